@@ -0,0 +1,131 @@
+#ifndef LYNX_BENCH_HISTOGRAM_HPP
+#define LYNX_BENCH_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+namespace bench
+{
+// log-linear 直方图（与 HdrHistogram 相同的分桶方式）：
+// 每个 2 的幂区间再等分为 kSubBuckets 个桶，相对误差小于 1/kSubBuckets，
+// record 只做一次下标计算和一次自增，不分配内存
+class Histogram
+{
+  private:
+	static constexpr int kSubBits = 7;
+	static constexpr uint64_t kSubBuckets = 1ull << kSubBits;
+	static constexpr size_t kBuckets = kSubBuckets * (64 - kSubBits + 1);
+
+	std::vector<uint64_t> counts_;
+	uint64_t total_;
+	uint64_t min_;
+	uint64_t max_;
+	long double sum_;
+
+  public:
+	Histogram() : counts_(kBuckets, 0)
+	{
+		reset();
+	}
+
+	void record(uint64_t value, uint64_t count = 1)
+	{
+		counts_[index(value)] += count;
+		total_ += count;
+		min_ = std::min(min_, value);
+		max_ = std::max(max_, value);
+		sum_ += static_cast<long double>(value) * count;
+	}
+
+	void merge(const Histogram& other)
+	{
+		for (size_t i = 0; i < kBuckets; ++i)
+		{
+			counts_[i] += other.counts_[i];
+		}
+		total_ += other.total_;
+		min_ = std::min(min_, other.min_);
+		max_ = std::max(max_, other.max_);
+		sum_ += other.sum_;
+	}
+
+	void reset()
+	{
+		std::fill(counts_.begin(), counts_.end(), 0);
+		total_ = 0;
+		min_ = std::numeric_limits<uint64_t>::max();
+		max_ = 0;
+		sum_ = 0;
+	}
+
+	// p 取 [0, 100]，返回所在桶的上界
+	uint64_t percentile(double p) const
+	{
+		if (total_ == 0)
+		{
+			return 0;
+		}
+
+		uint64_t rank = static_cast<uint64_t>(p / 100.0 * total_ + 0.5);
+		rank = std::clamp<uint64_t>(rank, 1, total_);
+
+		uint64_t seen = 0;
+		for (size_t i = 0; i < kBuckets; ++i)
+		{
+			seen += counts_[i];
+			if (seen >= rank)
+			{
+				return std::min(upperBound(i), max_);
+			}
+		}
+		return max_;
+	}
+
+	uint64_t count() const
+	{
+		return total_;
+	}
+
+	uint64_t min() const
+	{
+		return total_ == 0 ? 0 : min_;
+	}
+
+	uint64_t max() const
+	{
+		return max_;
+	}
+
+	double mean() const
+	{
+		return total_ == 0 ? 0.0 : static_cast<double>(sum_ / total_);
+	}
+
+  private:
+	static size_t index(uint64_t value)
+	{
+		if (value < kSubBuckets)
+		{
+			return value;
+		}
+		int shift = std::bit_width(value) - 1 - kSubBits;
+		return kSubBuckets * (shift + 1) + ((value >> shift) - kSubBuckets);
+	}
+
+	static uint64_t upperBound(size_t idx)
+	{
+		if (idx < kSubBuckets)
+		{
+			return idx;
+		}
+		size_t shift = idx / kSubBuckets - 1;
+		uint64_t sub = idx % kSubBuckets;
+		return ((kSubBuckets + sub + 1) << shift) - 1;
+	}
+};
+} // namespace bench
+
+#endif
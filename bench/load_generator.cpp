@@ -0,0 +1,432 @@
+#include "bench/load_generator.hpp"
+#include "lynx/json/parser.hpp"
+#include "lynx/json/ref.hpp"
+#include "lynx/json/tokenizer.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+using namespace lynx;
+using namespace bench;
+
+namespace
+{
+int64_t nowUs()
+{
+	return time::TimeStamp::now().microseconds();
+}
+
+std::string field(const std::shared_ptr<json::Object>& obj,
+				  const std::string& key, const std::string& def)
+{
+	for (const auto& [k, v] : *obj)
+	{
+		if (k == key)
+		{
+			if (!v->isValue() || !v->asValue()->isStr())
+			{
+				throw std::runtime_error(key + " must be a string");
+			}
+			return v->asValue()->asStr();
+		}
+	}
+	return def;
+}
+} // namespace
+
+RequestTemplate bench::makeRequest(const std::string& method,
+								   const std::string& path,
+								   const std::string& body,
+								   const Options& opts)
+{
+	RequestTemplate req;
+	req.name = method + " " + path;
+	req.weight = 1;
+	req.head = method == "HEAD";
+	req.wire = std::format("{} {} HTTP/1.1\r\nHost: {}:{}\r\n", method, path,
+						   opts.host, opts.port);
+	if (!body.empty())
+	{
+		req.wire += std::format("Content-Length: {}\r\n", body.size());
+	}
+	req.wire += "\r\n";
+	req.wire += body;
+	return req;
+}
+
+std::vector<RequestTemplate> bench::loadRequests(const std::string& path,
+												 const Options& opts)
+{
+	std::ifstream in(path);
+	if (!in)
+	{
+		throw std::runtime_error("cannot open " + path);
+	}
+
+	std::vector<RequestTemplate> reqs;
+	std::string line;
+	size_t lineno = 0;
+	while (std::getline(in, line))
+	{
+		++lineno;
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		try
+		{
+			json::Tokenizer tokenizer(line);
+			json::Ref root = json::Parser(&tokenizer).parse();
+			if (!root.getShared()->isObject())
+			{
+				throw std::runtime_error("not an object");
+			}
+			auto obj = root.getShared()->asObject();
+
+			RequestTemplate req =
+				makeRequest(field(obj, "method", "GET"),
+							field(obj, "path", "/"), field(obj, "body", ""),
+							opts);
+
+			// 额外的请求头插在空行之前
+			std::string headers;
+			for (const auto& [k, v] : *obj)
+			{
+				if (k == "headers")
+				{
+					if (!v->isObject())
+					{
+						throw std::runtime_error("headers must be an object");
+					}
+					for (const auto& [hk, hv] : *v->asObject())
+					{
+						headers += std::format("{}: {}\r\n", hk,
+											   hv->asValue()->asStr());
+					}
+				}
+				else if (k == "weight")
+				{
+					req.weight = static_cast<uint32_t>(
+						std::max<int64_t>(v->asValue()->asInt(), 0));
+				}
+			}
+			req.wire.insert(req.wire.find("\r\n\r\n") + 2, headers);
+			reqs.push_back(std::move(req));
+		}
+		catch (const std::exception& e)
+		{
+			throw std::runtime_error(
+				std::format("{}:{}: {}", path, lineno, e.what()));
+		}
+	}
+
+	if (reqs.empty())
+	{
+		throw std::runtime_error(path + ": no requests");
+	}
+	return reqs;
+}
+
+void Stats::reset()
+{
+	*this = Stats();
+}
+
+void Stats::merge(const Stats& other)
+{
+	latency.merge(other.latency);
+	service.merge(other.service);
+	requests += other.requests;
+	bytes += other.bytes;
+	for (size_t i = 0; i < 6; ++i)
+	{
+		status[i] += other.status[i];
+	}
+	connect_errors += other.connect_errors;
+	read_errors += other.read_errors;
+	timeouts += other.timeouts;
+	elapsed = std::max(elapsed, other.elapsed);
+}
+
+Worker::Worker(tcp::EventLoop* loop, const Options& opts,
+			   const std::vector<RequestTemplate>& reqs, size_t connections,
+			   uint64_t seed, std::function<void()> done)
+	: loop_(loop), opts_(opts), reqs_(reqs), addr_(opts.host, opts.port),
+	  done_(std::move(done)), conns_(connections), interval_(0), rng_(seed),
+	  start_(0), stopped_(false)
+{
+	std::vector<uint32_t> weights;
+	for (const auto& req : reqs_)
+	{
+		weights.push_back(req.weight);
+	}
+	pick_ = std::discrete_distribution<uint32_t>(weights.begin(),
+												 weights.end());
+
+	if (opts_.rate > 0)
+	{
+		interval_ = static_cast<int64_t>(opts_.connections * 1e6 / opts_.rate);
+		interval_ = std::max<int64_t>(interval_, 1);
+	}
+}
+
+void Worker::start()
+{
+	loop_->runInLoop([this]() { startInLoop(); });
+}
+
+void Worker::startInLoop()
+{
+	int64_t now = nowUs();
+	for (size_t i = 0; i < conns_.size(); ++i)
+	{
+		// 错开各连接的计划发送时间，避免同时突发
+		conns_[i].next_send =
+			now + interval_ * static_cast<int64_t>(i) / conns_.size();
+		connect(i);
+	}
+
+	start_ = now;
+	loop_->runAfter(opts_.warmup, [this]() { beginMeasure(); });
+	loop_->runAfter(opts_.warmup + opts_.duration, [this]() { stop(); });
+	// 开环需要按计划时间发送，间隔越短计划外的延迟越小；闭环只用来检查超时
+	loop_->runEvery(opts_.rate > 0 ? 0.0002 : 0.1, [this]() { tick(); });
+}
+
+void Worker::connect(size_t i)
+{
+	if (stopped_)
+	{
+		return;
+	}
+	tcp::ClientPool::local(loop_)->acquire(
+		addr_,
+		[this, i](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (stopped_)
+			{
+				if (conn)
+				{
+					conn->forceClose();
+				}
+				return;
+			}
+
+			if (!conn)
+			{
+				++stats_.connect_errors;
+				loop_->runAfter(0.1, [this, i]() { connect(i); });
+				return;
+			}
+
+			Conn& c = conns_[i];
+			c.conn = conn;
+			c.parser.clear();
+			conn->setMessageCallback(
+				[this, i](const std::shared_ptr<tcp::Connection>&,
+						  tcp::Buffer* buf) { onMessage(i, buf); });
+			conn->setConnectCallback(
+				[this, i](const std::shared_ptr<tcp::Connection>& conn)
+				{
+					if (conn->disconnected())
+					{
+						onClose(i);
+					}
+				});
+			fill(i, nowUs());
+		});
+}
+
+void Worker::onMessage(size_t i, tcp::Buffer* buf)
+{
+	Conn& c = conns_[i];
+	if (stopped_ || !c.conn)
+	{
+		buf->retrieve(buf->readableBytes());
+		return;
+	}
+	stats_.bytes += buf->readableBytes();
+
+	while (buf->readableBytes() > 0)
+	{
+		if (c.inflight.empty())
+		{
+			// 服务端返回了未请求的数据
+			++stats_.read_errors;
+			buf->retrieve(buf->readableBytes());
+			c.conn->forceClose();
+			return;
+		}
+
+		if (!c.parser.headerCompleted())
+		{
+			c.parser.expectNoBody(reqs_[c.inflight.front().req].head);
+			if (!c.parser.parseHeader(buf))
+			{
+				++stats_.read_errors;
+				c.conn->forceClose();
+				return;
+			}
+			if (!c.parser.headerCompleted())
+			{
+				break;
+			}
+		}
+
+		size_t n = c.parser.consumeBody(buf->peek(), buf->readableBytes());
+		buf->retrieve(n);
+		if (!c.parser.completed())
+		{
+			if (c.parser.error())
+			{
+				++stats_.read_errors;
+				c.conn->forceClose();
+				return;
+			}
+			break;
+		}
+
+		int64_t now = nowUs();
+		Pending done = c.inflight.front();
+		c.inflight.pop_front();
+
+		stats_.latency.record(static_cast<uint64_t>(now - done.intended));
+		stats_.service.record(static_cast<uint64_t>(now - done.sent));
+		++stats_.requests;
+		int code = c.parser.statusCode() / 100;
+		++stats_.status[code >= 1 && code <= 5 ? code : 0];
+
+		bool keep_alive = c.parser.keepAlive();
+		c.parser.clear();
+		if (!keep_alive)
+		{
+			// 断开后 onClose 负责重连
+			c.conn->shutdown();
+			return;
+		}
+	}
+
+	fill(i, nowUs());
+}
+
+void Worker::onClose(size_t i)
+{
+	Conn& c = conns_[i];
+	c.conn.reset();
+	c.parser.clear();
+	if (stopped_)
+	{
+		return;
+	}
+
+	// 未完成的请求算作读错误；开环的发送计划不变，断线期间积压的请求
+	// 在重连后计入延迟
+	stats_.read_errors += c.inflight.size();
+	c.inflight.clear();
+	loop_->queueInLoop([this, i]() { connect(i); });
+}
+
+void Worker::fill(size_t i, int64_t now)
+{
+	Conn& c = conns_[i];
+	if (stopped_ || !c.conn)
+	{
+		return;
+	}
+
+	// 流水线中的多个请求合并为一次写
+	std::string batch;
+	while (c.inflight.size() < opts_.pipeline)
+	{
+		int64_t intended = now;
+		if (interval_ > 0)
+		{
+			if (c.next_send > now)
+			{
+				break;
+			}
+			intended = c.next_send;
+			c.next_send += interval_;
+		}
+
+		uint32_t req = reqs_.size() == 1 ? 0 : pick_(rng_);
+		batch += reqs_[req].wire;
+		c.inflight.push_back({intended, now, req});
+	}
+
+	if (!batch.empty())
+	{
+		c.conn->send(batch);
+	}
+}
+
+void Worker::tick()
+{
+	if (stopped_)
+	{
+		return;
+	}
+
+	int64_t now = nowUs();
+	int64_t timeout = static_cast<int64_t>(opts_.timeout * 1e6);
+	for (size_t i = 0; i < conns_.size(); ++i)
+	{
+		Conn& c = conns_[i];
+		if (!c.conn)
+		{
+			continue;
+		}
+		if (!c.inflight.empty() && now - c.inflight.front().sent > timeout)
+		{
+			++stats_.timeouts;
+			c.inflight.pop_front();
+			c.conn->forceClose();
+			continue;
+		}
+		if (interval_ > 0)
+		{
+			fill(i, now);
+		}
+	}
+}
+
+void Worker::beginMeasure()
+{
+	// 预热期间的连接失败同样需要报告
+	uint64_t connect_errors = stats_.connect_errors;
+	stats_.reset();
+	stats_.connect_errors = connect_errors;
+	start_ = nowUs();
+}
+
+void Worker::stop()
+{
+	stopped_ = true;
+	stats_.elapsed = static_cast<double>(nowUs() - start_) / 1e6;
+
+	for (auto& c : conns_)
+	{
+		if (c.conn)
+		{
+			c.conn->setConnectCallback(nullptr);
+			c.conn->forceClose();
+			c.conn.reset();
+		}
+	}
+
+	// 留出时间处理连接关闭，再退出 loop 线程
+	loop_->runAfter(0.1,
+					[this]()
+					{
+						done_();
+						loop_->quit();
+					});
+}
@@ -0,0 +1,141 @@
+#ifndef LYNX_BENCH_LOAD_GENERATOR_HPP
+#define LYNX_BENCH_LOAD_GENERATOR_HPP
+
+#include "bench/histogram.hpp"
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class Connection;
+class Buffer;
+} // namespace tcp
+} // namespace lynx
+
+namespace bench
+{
+struct Options
+{
+	std::string host = "127.0.0.1";
+	uint16_t port = 8080;
+	size_t connections = 64;
+	size_t threads = 4;
+	size_t pipeline = 1;
+	double duration = 10.0;
+	double warmup = 1.0;
+	// 所有连接合计的目标速率，0 为闭环（收到响应立即发下一个）
+	double rate = 0.0;
+	double timeout = 5.0;
+	std::string requests_file;
+	uint64_t seed = 1;
+	bool json = false;
+
+	// 性能门禁，0 表示不检查
+	double max_p99_ms = 0.0;
+	double min_rps = 0.0;
+};
+
+struct RequestTemplate
+{
+	std::string name;
+	std::string wire; // 编码好的完整请求
+	uint32_t weight;
+	bool head;
+};
+
+// 每行一个 JSON 对象：
+// {"method":"POST","path":"/calculate","headers":{...},"body":"...","weight":2}
+// 空行与 # 开头的行被忽略；格式错误时抛出 std::runtime_error
+std::vector<RequestTemplate> loadRequests(const std::string& path,
+										  const Options& opts);
+RequestTemplate makeRequest(const std::string& method, const std::string& path,
+							const std::string& body, const Options& opts);
+
+struct Stats
+{
+	Histogram latency; // 开环时从计划发送时间算起（修正 coordinated omission）
+	Histogram service; // 从实际写出请求算起
+	uint64_t requests = 0;
+	uint64_t bytes = 0;
+	uint64_t status[6] = {0, 0, 0, 0, 0, 0}; // 按百位分组，[0] 为其他
+	uint64_t connect_errors = 0;
+	uint64_t read_errors = 0;
+	uint64_t timeouts = 0;
+	double elapsed = 0.0;
+
+	void reset();
+	void merge(const Stats& other);
+};
+
+// 一个 loop 线程上的一组连接，只在该 loop 线程中访问；
+// 结束后通过 done 回调通知，之后其他线程才可以读取 stats()
+class Worker : public lynx::base::noncopyable
+{
+  private:
+	struct Pending
+	{
+		int64_t intended; // us
+		int64_t sent;	  // us
+		uint32_t req;
+	};
+
+	struct Conn
+	{
+		std::shared_ptr<lynx::tcp::Connection> conn;
+		lynx::http::ResponseParser parser;
+		std::deque<Pending> inflight;
+		int64_t next_send = 0;
+	};
+
+	lynx::tcp::EventLoop* loop_;
+	const Options& opts_;
+	const std::vector<RequestTemplate>& reqs_;
+	lynx::tcp::InetAddr addr_;
+	std::function<void()> done_;
+
+	std::vector<Conn> conns_;
+	int64_t interval_; // 开环时每条连接的发送间隔，us
+	std::mt19937_64 rng_;
+	std::discrete_distribution<uint32_t> pick_;
+
+	Stats stats_;
+	int64_t start_;
+	bool stopped_;
+
+  public:
+	Worker(lynx::tcp::EventLoop* loop, const Options& opts,
+		   const std::vector<RequestTemplate>& reqs, size_t connections,
+		   uint64_t seed, std::function<void()> done);
+
+	// 线程安全
+	void start();
+
+	const Stats& stats() const
+	{
+		return stats_;
+	}
+
+  private:
+	void startInLoop();
+	void connect(size_t i);
+	void onMessage(size_t i, lynx::tcp::Buffer* buf);
+	void onClose(size_t i);
+	void fill(size_t i, int64_t now);
+	void tick();
+	void beginMeasure();
+	void stop();
+};
+} // namespace bench
+
+#endif
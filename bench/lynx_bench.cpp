@@ -0,0 +1,305 @@
+#include "bench/load_generator.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/event_loop_thread_pool.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <getopt.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace lynx;
+using namespace bench;
+
+namespace
+{
+void usage(const char* prog)
+{
+	std::printf(
+		"usage: %s [options] [host:port]\n"
+		"  -c, --connections N   total connections (64)\n"
+		"  -t, --threads N       event loop threads (4)\n"
+		"  -d, --duration SEC    measured duration (10)\n"
+		"  -w, --warmup SEC      warmup, not measured (1)\n"
+		"  -P, --pipeline N      requests in flight per connection (1)\n"
+		"  -R, --rate N          open loop at N req/s in total; latency is\n"
+		"                        measured from the scheduled send time\n"
+		"                        (0: closed loop)\n"
+		"  -f, --requests FILE   JSON lines request mix (GET /)\n"
+		"  -T, --timeout SEC     per request timeout (5)\n"
+		"  -s, --seed N          request mix seed (1)\n"
+		"  -j, --json            print the result as JSON\n"
+		"      --max-p99 MS      exit 1 if p99 latency exceeds MS\n"
+		"      --min-rps N       exit 1 if throughput is below N\n",
+		prog);
+}
+
+std::string formatUs(double us)
+{
+	if (us < 1000)
+	{
+		return std::format("{:.0f}us", us);
+	}
+	if (us < 1e6)
+	{
+		return std::format("{:.2f}ms", us / 1e3);
+	}
+	return std::format("{:.2f}s", us / 1e6);
+}
+
+void printText(const Options& opts, const Stats& s)
+{
+	double rps = s.elapsed > 0 ? s.requests / s.elapsed : 0;
+	std::printf("%s\n",
+				std::format("{:.1f}s @ {}:{}, {} threads, {} connections, "
+							"pipeline {}, {}",
+							opts.duration, opts.host, opts.port, opts.threads,
+							opts.connections, opts.pipeline,
+							opts.rate > 0
+								? std::format("open loop {:.0f} req/s",
+											  opts.rate)
+								: std::string("closed loop"))
+					.c_str());
+
+	auto line = [](const char* name, const Histogram& h)
+	{
+		std::printf(
+			"%s\n",
+			std::format("  {:<8} mean {:>8}  p50 {:>8}  p90 {:>8}  p99 {:>8}  "
+						"p99.9 {:>8}  p99.99 {:>8}  max {:>8}",
+						name, formatUs(h.mean()),
+						formatUs(h.percentile(50)), formatUs(h.percentile(90)),
+						formatUs(h.percentile(99)),
+						formatUs(h.percentile(99.9)),
+						formatUs(h.percentile(99.99)), formatUs(h.max()))
+				.c_str());
+	};
+	line("latency", s.latency);
+	if (opts.rate > 0)
+	{
+		line("service", s.service);
+	}
+
+	std::printf("%s\n",
+				std::format("  {} requests, {:.1f} req/s, {:.2f} MB/s",
+							s.requests, rps, s.bytes / s.elapsed / 1048576)
+					.c_str());
+	std::printf("%s\n",
+				std::format("  status 1xx {} 2xx {} 3xx {} 4xx {} 5xx {} "
+							"other {}",
+							s.status[1], s.status[2], s.status[3], s.status[4],
+							s.status[5], s.status[0])
+					.c_str());
+	std::printf("%s\n",
+				std::format("  errors connect {} read {} timeout {}",
+							s.connect_errors, s.read_errors, s.timeouts)
+					.c_str());
+}
+
+void printJson(const Options& opts, const Stats& s)
+{
+	auto hist = [](const Histogram& h)
+	{
+		return std::format(
+			"{{\"mean\":{:.1f},\"p50\":{},\"p90\":{},\"p99\":{},"
+			"\"p999\":{},\"p9999\":{},\"max\":{}}}",
+			h.mean(), h.percentile(50), h.percentile(90), h.percentile(99),
+			h.percentile(99.9), h.percentile(99.99), h.max());
+	};
+
+	std::printf(
+		"%s\n",
+		std::format(
+			"{{\"connections\":{},\"threads\":{},\"pipeline\":{},"
+			"\"rate\":{},\"duration\":{:.3f},\"requests\":{},"
+			"\"rps\":{:.1f},\"bytes\":{},\"latency_us\":{},"
+			"\"service_us\":{},\"status\":{{\"1xx\":{},\"2xx\":{},"
+			"\"3xx\":{},\"4xx\":{},\"5xx\":{},\"other\":{}}},"
+			"\"errors\":{{\"connect\":{},\"read\":{},\"timeout\":{}}}}}",
+			opts.connections, opts.threads, opts.pipeline, opts.rate,
+			s.elapsed, s.requests, s.elapsed > 0 ? s.requests / s.elapsed : 0,
+			s.bytes, hist(s.latency), hist(s.service), s.status[1],
+			s.status[2], s.status[3], s.status[4], s.status[5], s.status[0],
+			s.connect_errors, s.read_errors, s.timeouts)
+			.c_str());
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	Options opts;
+
+	enum
+	{
+		kMaxP99 = 256,
+		kMinRps
+	};
+	const option long_opts[] = {
+		{"connections", required_argument, nullptr, 'c'},
+		{"threads", required_argument, nullptr, 't'},
+		{"duration", required_argument, nullptr, 'd'},
+		{"warmup", required_argument, nullptr, 'w'},
+		{"pipeline", required_argument, nullptr, 'P'},
+		{"rate", required_argument, nullptr, 'R'},
+		{"requests", required_argument, nullptr, 'f'},
+		{"timeout", required_argument, nullptr, 'T'},
+		{"seed", required_argument, nullptr, 's'},
+		{"json", no_argument, nullptr, 'j'},
+		{"max-p99", required_argument, nullptr, kMaxP99},
+		{"min-rps", required_argument, nullptr, kMinRps},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0}};
+
+	int ch;
+	while ((ch = ::getopt_long(argc, argv, "c:t:d:w:P:R:f:T:s:jh", long_opts,
+							   nullptr)) != -1)
+	{
+		switch (ch)
+		{
+		case 'c':
+			opts.connections = std::strtoul(optarg, nullptr, 10);
+			break;
+		case 't':
+			opts.threads = std::strtoul(optarg, nullptr, 10);
+			break;
+		case 'd':
+			opts.duration = std::strtod(optarg, nullptr);
+			break;
+		case 'w':
+			opts.warmup = std::strtod(optarg, nullptr);
+			break;
+		case 'P':
+			opts.pipeline = std::strtoul(optarg, nullptr, 10);
+			break;
+		case 'R':
+			opts.rate = std::strtod(optarg, nullptr);
+			break;
+		case 'f':
+			opts.requests_file = optarg;
+			break;
+		case 'T':
+			opts.timeout = std::strtod(optarg, nullptr);
+			break;
+		case 's':
+			opts.seed = std::strtoull(optarg, nullptr, 10);
+			break;
+		case 'j':
+			opts.json = true;
+			break;
+		case kMaxP99:
+			opts.max_p99_ms = std::strtod(optarg, nullptr);
+			break;
+		case kMinRps:
+			opts.min_rps = std::strtod(optarg, nullptr);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 2;
+		}
+	}
+
+	if (optind < argc)
+	{
+		std::string target = argv[optind];
+		size_t colon = target.rfind(':');
+		if (colon != std::string::npos)
+		{
+			opts.port =
+				static_cast<uint16_t>(std::stoi(target.substr(colon + 1)));
+			target.resize(colon);
+		}
+		opts.host = target;
+	}
+
+	if (opts.connections == 0 || opts.threads == 0 || opts.pipeline == 0 ||
+		opts.duration <= 0)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+	opts.threads = std::min(opts.threads, opts.connections);
+
+	std::vector<RequestTemplate> reqs;
+	try
+	{
+		if (opts.requests_file.empty())
+		{
+			reqs.push_back(makeRequest("GET", "/", "", opts));
+		}
+		else
+		{
+			reqs = loadRequests(opts.requests_file, opts);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s\n", e.what());
+		return 2;
+	}
+
+	// workers 需在 loop 线程退出后才析构
+	std::vector<std::unique_ptr<Worker>> workers;
+	tcp::EventLoop loop;
+	tcp::EventLoopThreadPool pool(&loop, opts.threads);
+	pool.run();
+
+	// 各 worker 结束后在主 loop 中计数，全部结束再汇总
+	size_t finished = 0;
+	for (size_t i = 0; i < opts.threads; ++i)
+	{
+		size_t conns = opts.connections / opts.threads +
+					   (i < opts.connections % opts.threads ? 1 : 0);
+		workers.push_back(std::make_unique<Worker>(
+			pool.nextLoop(), opts, reqs, conns, opts.seed + i,
+			[&loop, &finished, &opts]()
+			{
+				loop.queueInLoop(
+					[&loop, &finished, &opts]()
+					{
+						if (++finished == opts.threads)
+						{
+							loop.quit();
+						}
+					});
+			}));
+	}
+	for (auto& worker : workers)
+	{
+		worker->start();
+	}
+	loop.run();
+
+	Stats total;
+	for (auto& worker : workers)
+	{
+		total.merge(worker->stats());
+	}
+
+	if (opts.json)
+	{
+		printJson(opts, total);
+	}
+	else
+	{
+		printText(opts, total);
+	}
+
+	int rc = 0;
+	double rps = total.elapsed > 0 ? total.requests / total.elapsed : 0;
+	double p99_ms = total.latency.percentile(99) / 1e3;
+	if (opts.max_p99_ms > 0 && p99_ms > opts.max_p99_ms)
+	{
+		std::fprintf(stderr, "perf gate: p99 %.2fms > %.2fms\n", p99_ms,
+					 opts.max_p99_ms);
+		rc = 1;
+	}
+	if (opts.min_rps > 0 && rps < opts.min_rps)
+	{
+		std::fprintf(stderr, "perf gate: %.1f req/s < %.1f req/s\n", rps,
+					 opts.min_rps);
+		rc = 1;
+	}
+	return rc;
+}
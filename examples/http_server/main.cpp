@@ -1,6 +1,12 @@
+#include <charconv>
+#include <cstdlib>
+#include <format>
 #include <functional>
 #include <lynx/lynx.hpp>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
 
 using namespace lynx;
 using entry_type = base::Entry<tcp::Connection>;
@@ -23,6 +29,10 @@ int main(int argc, char* argv[])
 
 	// 创建路由器
 	auto router = http::Router();
+	// 按 Accept-Encoding 压缩 JSON、HTML 等文本响应
+	router.enableCompression();
+	// GET /metrics 以 Prometheus 文本格式导出运行时指标
+	router.enableMetrics();
 
 	// 注册路由
 	router.addRoute("GET", "/",
@@ -50,62 +60,77 @@ int main(int argc, char* argv[])
 							conn, res, LYNX_WEB_SRC_DIR "/static/js/script.js");
 					});
 
+	// 访问日志 + 异常转 400 JSON 响应，中间件在注册时静态组合
 	router.addRoute(
 		"POST", "/calculate",
-		[](const auto& req, auto* res, const auto& conn)
-		{
-			try
-			{
-				json::Tokenizer tokenizer(req.body);
-				json::Ref root = json::Parser(&tokenizer).parse();
-
-				double sum = 0.0;
-
-				auto a = root["a"];
-				auto b = root["b"];
-
-				if (a.getShared()->isValue() &&
-					a.getShared()->asValue()->isFloat())
-				{
-					sum += a.asFloat();
-				}
-				else if (a.getShared()->isValue() &&
-						 a.getShared()->asValue()->isInt())
+		http::use(http::AccessLog{}, http::JsonError{})
+			.handle(
+				[](const auto& req, auto* res, const auto& conn)
 				{
-					sum += a.asInt();
-				}
+					// 每个 sub reactor 复用一个 Document，arena 在请求间保留
+					thread_local json::Document doc;
+					doc.parse(req.body);
 
-				if (b.getShared()->isValue() &&
-					b.getShared()->asValue()->isFloat())
-				{
-					sum += b.asFloat();
-				}
-				else if (b.getShared()->isValue() &&
-						 b.getShared()->asValue()->isInt())
+					double sum = 0.0;
+					for (const char* key : {"a", "b"})
+					{
+						const json::Node& node = doc[key];
+						if (node.isInt())
+						{
+							sum += node.asInt();
+						}
+						else if (node.isFloat())
+						{
+							sum += node.asFloat();
+						}
+					}
+
+					json::Ref result =
+						json::make_object({{"sum", json::make_value(sum)}});
+
+					res->setStatusCode(200);
+					res->setContentType("application/json");
+
+					res->setBody(result.serialize());
+
+					conn->send(res->toFormattedString());
+				}));
+
+	// 按比例抽样请求，各阶段耗时写入日志；PUT /admin/trace?rate=0.05 在线调整，
+	// 需携带 Authorization: Bearer $LYNX_ADMIN_TOKEN，未设置该变量时一律拒绝
+	http::Trace::setSampleRate(0.01);
+	const char* admin_token = std::getenv("LYNX_ADMIN_TOKEN");
+	router.addRoute(
+		"PUT", "/admin/trace",
+		http::use(http::BearerAuth{
+					  [token = std::string(admin_token ? admin_token : "")](
+						  std::string_view t)
+					  { return !token.empty() && t == token; }})
+			.handle(
+				[](const auto& req, auto* res, const auto& conn)
 				{
-					sum += b.asInt();
-				}
-
-				json::Ref result =
-					json::make_object({{"sum", json::make_value(sum)}});
-
-				res->setStatusCode(200);
-				res->setContentType("application/json");
-
-				res->setBody(result.serialize());
-
-				conn->send(res->toFormattedString());
-			}
-
-			catch (const std::exception& e)
-			{
-				res->setStatusCode(400);
-				res->setContentType("application/json");
-				res->setBody(std::format("{{\"error\": \"{}\"}}", e.what()));
-
-				conn->send(res->toFormattedString());
-			}
-		});
+					std::string value = req.query("rate");
+					const char* end = value.data() + value.size();
+					double rate = 0.0;
+					auto [ptr, ec] = std::from_chars(value.data(), end, rate);
+
+					res->setContentType("text/plain; charset=utf-8");
+					// 拒绝无法完整解析的值以及 nan、inf 等超出 [0, 1] 的值
+					if (value.empty() || ec != std::errc() || ptr != end ||
+						!(rate >= 0.0 && rate <= 1.0))
+					{
+						res->setStatusCode(400);
+						res->setBody("rate must be a number in [0, 1]\n");
+					}
+					else
+					{
+						http::Trace::setSampleRate(rate);
+						res->setStatusCode(200);
+						res->setBody(std::format("sample rate {}\n",
+												 http::Trace::sampleRate()));
+					}
+					conn->send(res->toFormattedString());
+				}));
 
 	// 设置连接回调
 	server.setConnectionCallback(
@@ -124,6 +149,8 @@ int main(int argc, char* argv[])
 
 				tcp::Context ctx;
 				ctx.session_ = std::make_shared<http::Session>();
+				// 请求头 / body 迟迟收不齐的慢速连接回复 408 并关闭
+				ctx.session_->setConnection(conn);
 				ctx.entry_ = entry;
 
 				conn->setContext(ctx);
@@ -148,10 +175,10 @@ int main(int argc, char* argv[])
 				conn_buckets_.push_back(entry);
 			}
 
+			// 格式错误回复 400，请求头过大 431，body 过大 413
 			if (!session->parser(buf))
 			{
-				conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
-				conn->shutdown();
+				http::Session::reject(conn, session->errorStatus());
 				return;
 			}
 
@@ -162,9 +189,11 @@ int main(int argc, char* argv[])
 
 				router.dispatch(req, &res, conn);
 
+				// deferred 的处理函数（如反向代理）自行负责关闭连接
 				std::string conn_header = req.header("connection");
-				if (conn_header == "close" ||
-					(req.version == "HTTP/1.0" && conn_header != "keep-alive"))
+				if (!res.deferred() &&
+					(conn_header == "close" ||
+					 (req.version == "HTTP/1.0" && conn_header != "keep-alive")))
 				{
 					conn->shutdown();
 				}
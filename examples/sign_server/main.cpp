@@ -87,6 +87,8 @@ int main(int argc, char* argv[])
 
 	// 创建路由器
 	auto router = http::Router();
+	// 按 Accept-Encoding 压缩 JSON、HTML 等文本响应
+	router.enableCompression();
 
 	// 注册路由
 	router.addRoute("GET", "/",
@@ -478,6 +480,8 @@ int main(int argc, char* argv[])
 
 				tcp::Context ctx;
 				ctx.session_ = std::make_shared<http::Session>();
+				// 请求头 / body 迟迟收不齐的慢速连接回复 408 并关闭
+				ctx.session_->setConnection(conn);
 				ctx.entry_ = entry;
 
 				conn->setContext(ctx);
@@ -501,10 +505,10 @@ int main(int argc, char* argv[])
 				conn_buckets_.push_back(entry);
 			}
 
+			// 格式错误回复 400，请求头过大 431，body 过大 413
 			if (!session->parser(buf))
 			{
-				conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
-				conn->shutdown();
+				http::Session::reject(conn, session->errorStatus());
 				return;
 			}
 
@@ -515,9 +519,11 @@ int main(int argc, char* argv[])
 
 				router.dispatch(req, &res, conn);
 
+				// deferred 的处理函数（如压缩流式发送）自行负责关闭连接
 				std::string conn_header = req.header("connection");
-				if (conn_header == "close" ||
-					(req.version == "HTTP/1.0" && conn_header != "keep-alive"))
+				if (!res.deferred() &&
+					(conn_header == "close" ||
+					 (req.version == "HTTP/1.0" && conn_header != "keep-alive")))
 				{
 					conn->shutdown();
 				}
@@ -215,6 +215,13 @@ template <bool threads, int inst> class default_alloc_template
 	static pointer reallocate(pointer p, size_type old_size,
 							  size_type new_size);
 
+	// 内存池从系统申请的总字节数
+	static size_type heapSize()
+	{
+		std::lock_guard<lock_type> lock(mtx);
+		return heap_size;
+	}
+
   protected:
 	static size_type round_up(size_type bytes)
 	{
@@ -0,0 +1,136 @@
+#ifndef LYNX_BASE_ARENA_HPP
+#define LYNX_BASE_ARENA_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+namespace lynx
+{
+namespace base
+{
+// 单调递增的内存区：分配只移动指针，不能单独释放，析构或 clear 时整体归还。
+// 只能存放平凡析构的对象
+class Arena : public noncopyable
+{
+  private:
+	static constexpr size_t kMaxGrowth = 1 << 20;
+
+	struct Block
+	{
+		Block* next;
+		size_t size; // 含 Block 头部
+	};
+
+	Block* head_;
+	char* cur_;
+	char* end_;
+	size_t block_size_;
+	size_t used_;
+
+  public:
+	explicit Arena(size_t block_size = 4096)
+		: head_(nullptr), cur_(nullptr), end_(nullptr),
+		  block_size_(block_size), used_(0)
+	{
+	}
+
+	~Arena()
+	{
+		release(head_);
+	}
+
+	void* allocate(size_t size, size_t align = alignof(std::max_align_t))
+	{
+		char* p = alignUp(cur_, align);
+		if (p == nullptr || p + size > end_)
+		{
+			grow(size + align);
+			p = alignUp(cur_, align);
+		}
+		cur_ = p + size;
+		used_ += size;
+		return p;
+	}
+
+	template <typename T> T* allocate(size_t n)
+	{
+		static_assert(std::is_trivially_destructible_v<T>,
+					  "arena objects are never destroyed");
+		return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+	}
+
+	// 只有一块时保留该块；有多块时全部释放，下次分配按总大小申请一整块，
+	// 此后同等规模的使用不再申请内存
+	void clear()
+	{
+		used_ = 0;
+		if (head_ == nullptr)
+		{
+			return;
+		}
+		if (head_->next != nullptr)
+		{
+			size_t total = 0;
+			for (Block* block = head_; block != nullptr; block = block->next)
+			{
+				total += block->size;
+			}
+			release(head_);
+			head_ = nullptr;
+			cur_ = end_ = nullptr;
+			block_size_ = std::max(block_size_, total);
+			return;
+		}
+		cur_ = reinterpret_cast<char*>(head_ + 1);
+		end_ = reinterpret_cast<char*>(head_) + head_->size;
+	}
+
+	// 已分配给调用者的字节数
+	size_t used() const
+	{
+		return used_;
+	}
+
+  private:
+	static char* alignUp(char* p, size_t align)
+	{
+		auto addr = reinterpret_cast<uintptr_t>(p);
+		return reinterpret_cast<char*>((addr + align - 1) & ~(align - 1));
+	}
+
+	void grow(size_t min_size)
+	{
+		// 块大小倍增，块数随总用量对数增长
+		size_t size = std::max(block_size_, min_size + sizeof(Block));
+		block_size_ = std::max(block_size_, std::min(size * 2, kMaxGrowth));
+
+		auto* block = static_cast<Block*>(std::malloc(size));
+		if (block == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		block->next = head_;
+		block->size = size;
+		head_ = block;
+		cur_ = reinterpret_cast<char*>(block + 1);
+		end_ = reinterpret_cast<char*>(block) + size;
+	}
+
+	static void release(Block* block)
+	{
+		while (block != nullptr)
+		{
+			Block* next = block->next;
+			std::free(block);
+			block = next;
+		}
+	}
+};
+} // namespace base
+} // namespace lynx
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef LYNX_BASE_INLINE_FUNCTION_HPP
+#define LYNX_BASE_INLINE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+namespace lynx
+{
+namespace base
+{
+template <typename Signature, size_t Capacity = 48> class InlineFunction;
+
+// 只能移动的 std::function：不超过 Capacity 字节的可调用对象直接存放在
+// 对象内部，构造与移动都不分配内存；更大的对象退化为堆上分配
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity>
+{
+  private:
+	struct Ops
+	{
+		R (*invoke)(void*, Args&&...);
+		void (*move)(void* dst, void* src) noexcept;
+		void (*destroy)(void*) noexcept;
+	};
+
+	template <typename F>
+	static constexpr bool kInline =
+		sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+		std::is_nothrow_move_constructible_v<F>;
+
+	template <typename F> struct InlineOps
+	{
+		static R invoke(void* p, Args&&... args)
+		{
+			return std::invoke(*static_cast<F*>(p),
+							   std::forward<Args>(args)...);
+		}
+
+		static void move(void* dst, void* src) noexcept
+		{
+			new (dst) F(std::move(*static_cast<F*>(src)));
+			static_cast<F*>(src)->~F();
+		}
+
+		static void destroy(void* p) noexcept
+		{
+			static_cast<F*>(p)->~F();
+		}
+
+		static constexpr Ops kOps{invoke, move, destroy};
+	};
+
+	template <typename F> struct HeapOps
+	{
+		static R invoke(void* p, Args&&... args)
+		{
+			return std::invoke(**static_cast<F**>(p),
+							   std::forward<Args>(args)...);
+		}
+
+		static void move(void* dst, void* src) noexcept
+		{
+			*static_cast<F**>(dst) = *static_cast<F**>(src);
+		}
+
+		static void destroy(void* p) noexcept
+		{
+			delete *static_cast<F**>(p);
+		}
+
+		static constexpr Ops kOps{invoke, move, destroy};
+	};
+
+	alignas(std::max_align_t) unsigned char storage_[Capacity];
+	const Ops* ops_;
+
+  public:
+	InlineFunction() noexcept : ops_(nullptr)
+	{
+	}
+
+	InlineFunction(std::nullptr_t) noexcept : ops_(nullptr)
+	{
+	}
+
+	template <typename F, typename D = std::decay_t<F>,
+			  typename = std::enable_if_t<
+				  !std::is_same_v<D, InlineFunction> &&
+				  std::is_invocable_r_v<R, D&, Args...>>>
+	InlineFunction(F&& f) : ops_(nullptr)
+	{
+		if constexpr (kInline<D>)
+		{
+			new (storage_) D(std::forward<F>(f));
+			ops_ = &InlineOps<D>::kOps;
+		}
+		else
+		{
+			*reinterpret_cast<D**>(storage_) = new D(std::forward<F>(f));
+			ops_ = &HeapOps<D>::kOps;
+		}
+	}
+
+	InlineFunction(InlineFunction&& other) noexcept : ops_(other.ops_)
+	{
+		if (ops_)
+		{
+			ops_->move(storage_, other.storage_);
+			other.ops_ = nullptr;
+		}
+	}
+
+	InlineFunction& operator=(InlineFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			if (other.ops_)
+			{
+				other.ops_->move(storage_, other.storage_);
+				ops_ = other.ops_;
+				other.ops_ = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	InlineFunction(const InlineFunction&) = delete;
+	InlineFunction& operator=(const InlineFunction&) = delete;
+
+	~InlineFunction()
+	{
+		reset();
+	}
+
+	void reset() noexcept
+	{
+		if (ops_)
+		{
+			ops_->destroy(storage_);
+			ops_ = nullptr;
+		}
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return ops_ != nullptr;
+	}
+
+	R operator()(Args... args)
+	{
+		return ops_->invoke(storage_, std::forward<Args>(args)...);
+	}
+};
+} // namespace base
+} // namespace lynx
+
+#endif
@@ -0,0 +1,159 @@
+#include "lynx/http/balancer.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+using namespace lynx;
+using namespace lynx::http;
+
+Balancer::Balancer(const std::vector<tcp::InetAddr>& addrs, Policy policy)
+	: policy_(policy), next_(0), max_fails_(3), fail_timeout_(10.0)
+{
+	assert(!addrs.empty());
+	for (const auto& addr : addrs)
+	{
+		upstreams_.push_back(std::make_unique<Upstream>(addr));
+	}
+
+	if (policy_ == Policy::kConsistentHash)
+	{
+		// 虚拟节点让 key 在各节点间分布更均匀
+		ring_.reserve(upstreams_.size() * kVirtualNodes);
+		for (const auto& upstream : upstreams_)
+		{
+			std::string name = upstream->addr.toFormattedString();
+			for (int i = 0; i < kVirtualNodes; ++i)
+			{
+				ring_.emplace_back(hash(name + "#" + std::to_string(i)),
+								   upstream.get());
+			}
+		}
+		std::sort(ring_.begin(), ring_.end(),
+				  [](const auto& a, const auto& b)
+				  { return a.first < b.first; });
+	}
+}
+
+Balancer::~Balancer()
+{
+}
+
+uint64_t Balancer::hash(std::string_view key)
+{
+	// FNV-1a
+	uint64_t h = 14695981039346656037ull;
+	for (char c : key)
+	{
+		h ^= static_cast<unsigned char>(c);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+bool Balancer::available(const Upstream* upstream, int64_t now)
+{
+	return upstream->ejected_until.load(std::memory_order_relaxed) <= now;
+}
+
+Upstream* Balancer::select(std::string_view hash_key)
+{
+	int64_t now = time::TimeStamp::now().microseconds();
+
+	switch (policy_)
+	{
+	case Policy::kLeastConn:
+		return selectLeastConn(now);
+	case Policy::kConsistentHash:
+		return selectConsistentHash(hash_key, now);
+	default:
+		return selectRoundRobin(now);
+	}
+}
+
+Upstream* Balancer::selectRoundRobin(int64_t now)
+{
+	size_t n = upstreams_.size();
+	size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+	for (size_t i = 0; i < n; ++i)
+	{
+		Upstream* upstream = upstreams_[(start + i) % n].get();
+		if (available(upstream, now))
+		{
+			return upstream;
+		}
+	}
+	return upstreams_[start % n].get();
+}
+
+Upstream* Balancer::selectLeastConn(int64_t now)
+{
+	// 从轮转位置开始扫描，活跃数相同时不总是落到第一个节点
+	size_t n = upstreams_.size();
+	size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+	Upstream* best = nullptr;
+	int best_active = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		Upstream* upstream = upstreams_[(start + i) % n].get();
+		if (!available(upstream, now))
+		{
+			continue;
+		}
+
+		int active = upstream->active.load(std::memory_order_relaxed);
+		if (!best || active < best_active)
+		{
+			best = upstream;
+			best_active = active;
+		}
+	}
+	return best ? best : upstreams_[start % n].get();
+}
+
+Upstream* Balancer::selectConsistentHash(std::string_view key, int64_t now)
+{
+	uint64_t h = hash(key);
+	auto it = std::lower_bound(ring_.begin(), ring_.end(), h,
+							   [](const auto& node, uint64_t value)
+							   { return node.first < value; });
+	size_t pos = (it == ring_.end()) ? 0 : it - ring_.begin();
+
+	// 顺时针找到第一个可用节点，被摘除节点的 key 只迁移到后继节点
+	for (size_t i = 0; i < ring_.size(); ++i)
+	{
+		Upstream* upstream = ring_[(pos + i) % ring_.size()].second;
+		if (available(upstream, now))
+		{
+			return upstream;
+		}
+	}
+	return ring_[pos].second;
+}
+
+void Balancer::markSuccess(Upstream* upstream)
+{
+	if (upstream->fails.load(std::memory_order_relaxed) != 0)
+	{
+		upstream->fails.store(0, std::memory_order_relaxed);
+	}
+}
+
+void Balancer::markFailure(Upstream* upstream)
+{
+	if (upstream->fails.fetch_add(1, std::memory_order_relaxed) + 1 <
+		max_fails_)
+	{
+		return;
+	}
+
+	upstream->fails.store(0, std::memory_order_relaxed);
+	upstream->ejected_until.store(
+		time::TimeStamp::addTime(time::TimeStamp::now(), fail_timeout_)
+			.microseconds(),
+		std::memory_order_relaxed);
+
+	LOG_WARN << "upstream " << upstream->addr.toFormattedString()
+			 << " ejected for " << fail_timeout_ << "s";
+}
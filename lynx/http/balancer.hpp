@@ -0,0 +1,99 @@
+#ifndef LYNX_HTTP_BALANCER_HPP
+#define LYNX_HTTP_BALANCER_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace http
+{
+// 被所有 sub-reactor 共享，状态均为原子变量
+struct Upstream
+{
+	tcp::InetAddr addr;
+	std::atomic<int> active{0}; // 进行中的请求数
+	std::atomic<int> fails{0};	// 连续失败次数
+	std::atomic<int64_t> ejected_until{0}; // 微秒，被动摘除截止时间
+
+	explicit Upstream(const tcp::InetAddr& a) : addr(a)
+	{
+	}
+};
+
+class Balancer : public base::noncopyable
+{
+  public:
+	enum class Policy
+	{
+		kRoundRobin,
+		kLeastConn,
+		kConsistentHash
+	};
+
+  private:
+	static constexpr int kVirtualNodes = 160;
+
+	Policy policy_;
+	std::vector<std::unique_ptr<Upstream>> upstreams_;
+	// 一致性哈希环，按 hash 排序
+	std::vector<std::pair<uint64_t, Upstream*>> ring_;
+	std::atomic<size_t> next_;
+
+	int max_fails_;
+	double fail_timeout_;
+
+  public:
+	Balancer(const std::vector<tcp::InetAddr>& addrs, Policy policy);
+	~Balancer();
+
+	// 跳过被摘除的节点；全部被摘除时仍返回一个节点，避免彻底不可用
+	Upstream* select(std::string_view hash_key);
+
+	void markSuccess(Upstream* upstream);
+	void markFailure(Upstream* upstream);
+
+	// 连续失败 max_fails 次后摘除 fail_timeout 秒
+	void setMaxFails(int n)
+	{
+		max_fails_ = n;
+	}
+
+	void setFailTimeout(double seconds)
+	{
+		fail_timeout_ = seconds;
+	}
+
+	Policy policy() const
+	{
+		return policy_;
+	}
+
+	size_t size() const
+	{
+		return upstreams_.size();
+	}
+
+	Upstream* upstream(size_t i) const
+	{
+		return upstreams_[i].get();
+	}
+
+	static uint64_t hash(std::string_view key);
+
+  private:
+	static bool available(const Upstream* upstream, int64_t now);
+	Upstream* selectRoundRobin(int64_t now);
+	Upstream* selectLeastConn(int64_t now);
+	Upstream* selectConsistentHash(std::string_view key, int64_t now);
+};
+} // namespace http
+} // namespace lynx
+
+#endif
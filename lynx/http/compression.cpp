@@ -0,0 +1,256 @@
+#include "lynx/http/compression.hpp"
+#include "lynx/logger/logger.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <zlib.h>
+
+using namespace lynx;
+using namespace lynx::http;
+
+namespace
+{
+constexpr size_t kMaxPooled = 16;
+
+// 每个线程按 (编码, 压缩级别) 缓存 z_stream
+class ZStreamPool
+{
+  private:
+	struct Slot
+	{
+		Encoding encoding;
+		int level;
+		z_stream* zs;
+	};
+
+	std::vector<Slot> idle_;
+
+  public:
+	~ZStreamPool()
+	{
+		for (auto& slot : idle_)
+		{
+			deflateEnd(slot.zs);
+			delete slot.zs;
+		}
+	}
+
+	z_stream* acquire(Encoding encoding, int level)
+	{
+		for (size_t i = idle_.size(); i-- > 0;)
+		{
+			if (idle_[i].encoding == encoding && idle_[i].level == level)
+			{
+				z_stream* zs = idle_[i].zs;
+				idle_.erase(idle_.begin() + i);
+				return zs;
+			}
+		}
+
+		auto zs = std::make_unique<z_stream>();
+		// windowBits + 16 输出 gzip 头，否则为 zlib（HTTP deflate）格式
+		int window_bits = encoding == Encoding::kGzip ? 15 + 16 : 15;
+		if (deflateInit2(zs.get(), level, Z_DEFLATED, window_bits, 8,
+						 Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			LOG_ERROR << "deflateInit2 failed";
+			return nullptr;
+		}
+		return zs.release();
+	}
+
+	void release(Encoding encoding, int level, z_stream* zs)
+	{
+		if (idle_.size() >= kMaxPooled || deflateReset(zs) != Z_OK)
+		{
+			deflateEnd(zs);
+			delete zs;
+			return;
+		}
+		idle_.push_back({encoding, level, zs});
+	}
+};
+
+ZStreamPool& localPool()
+{
+	thread_local ZStreamPool pool;
+	return pool;
+}
+
+std::string_view trim(std::string_view s)
+{
+	while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+	{
+		s.remove_prefix(1);
+	}
+	while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+	{
+		s.remove_suffix(1);
+	}
+	return s;
+}
+
+bool iequals(std::string_view a, std::string_view b)
+{
+	return a.size() == b.size() &&
+		   std::equal(a.begin(), a.end(), b.begin(),
+					  [](char x, char y)
+					  {
+						  return std::tolower(static_cast<unsigned char>(x)) ==
+								 std::tolower(static_cast<unsigned char>(y));
+					  });
+}
+} // namespace
+
+Encoding http::negotiate(std::string_view accept_encoding)
+{
+	// -1: 未出现，0: 拒绝（q=0），1: 接受
+	int gzip = -1;
+	int deflate = -1;
+	int wildcard = -1;
+
+	while (!accept_encoding.empty())
+	{
+		size_t comma = accept_encoding.find(',');
+		std::string_view item = accept_encoding.substr(0, comma);
+		accept_encoding = comma == std::string_view::npos
+							  ? std::string_view()
+							  : accept_encoding.substr(comma + 1);
+
+		// gzip;q=0.8
+		std::string_view name = item;
+		bool allowed = true;
+		size_t semi = item.find(';');
+		if (semi != std::string_view::npos)
+		{
+			name = item.substr(0, semi);
+			std::string_view param = trim(item.substr(semi + 1));
+			if (param.starts_with("q=") || param.starts_with("Q="))
+			{
+				std::string q(param.substr(2));
+				allowed = std::strtod(q.c_str(), nullptr) > 0.0;
+			}
+		}
+
+		name = trim(name);
+		int* state = nullptr;
+		if (iequals(name, "gzip"))
+		{
+			state = &gzip;
+		}
+		else if (iequals(name, "deflate"))
+		{
+			state = &deflate;
+		}
+		else if (iequals(name, "*"))
+		{
+			state = &wildcard;
+		}
+		if (state != nullptr)
+		{
+			*state = std::max(*state, allowed ? 1 : 0);
+		}
+	}
+
+	// "*" 只作用于没有被显式列出的编码，gzip;q=0 不会被 "*" 覆盖
+	if (gzip < 0)
+	{
+		gzip = wildcard;
+	}
+	if (deflate < 0)
+	{
+		deflate = wildcard;
+	}
+
+	if (gzip > 0)
+	{
+		return Encoding::kGzip;
+	}
+	return deflate > 0 ? Encoding::kDeflate : Encoding::kIdentity;
+}
+
+const char* http::encodingName(Encoding encoding)
+{
+	switch (encoding)
+	{
+	case Encoding::kGzip:
+		return "gzip";
+	case Encoding::kDeflate:
+		return "deflate";
+	default:
+		return "identity";
+	}
+}
+
+bool http::compressible(std::string_view content_type)
+{
+	content_type = trim(content_type.substr(0, content_type.find(';')));
+	return content_type.starts_with("text/") ||
+		   content_type == "application/json" ||
+		   content_type == "application/javascript" ||
+		   content_type == "application/xml" ||
+		   content_type == "image/svg+xml" || content_type.ends_with("+json") ||
+		   content_type.ends_with("+xml");
+}
+
+Deflater::Deflater(Encoding encoding, int level)
+	: encoding_(encoding), level_(level),
+	  zs_(localPool().acquire(encoding, level))
+{
+	assert(encoding != Encoding::kIdentity);
+}
+
+Deflater::~Deflater()
+{
+	if (zs_)
+	{
+		localPool().release(encoding_, level_, zs_);
+	}
+}
+
+bool Deflater::compress(std::string_view in, bool finish, std::string* out)
+{
+	if (!zs_)
+	{
+		return false;
+	}
+
+	zs_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+	zs_->avail_in = static_cast<uInt>(in.size());
+
+	int flush = finish ? Z_FINISH : Z_NO_FLUSH;
+	int ret;
+	do
+	{
+		size_t old = out->size();
+		size_t chunk = std::max<size_t>(deflateBound(zs_, zs_->avail_in), 4096);
+		out->resize(old + chunk);
+
+		zs_->next_out = reinterpret_cast<Bytef*>(out->data() + old);
+		zs_->avail_out = static_cast<uInt>(chunk);
+		ret = deflate(zs_, flush);
+		out->resize(old + chunk - zs_->avail_out);
+
+		if (ret == Z_STREAM_ERROR)
+		{
+			LOG_ERROR << "deflate failed";
+			return false;
+		}
+	} while (zs_->avail_out == 0 || (finish && ret != Z_STREAM_END));
+
+	return true;
+}
+
+std::string http::compress(std::string_view in, Encoding encoding, int level)
+{
+	std::string out;
+	Deflater deflater(encoding, level);
+	if (!deflater.compress(in, true, &out))
+	{
+		out.clear();
+	}
+	return out;
+}
@@ -0,0 +1,56 @@
+#ifndef LYNX_HTTP_COMPRESSION_HPP
+#define LYNX_HTTP_COMPRESSION_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+struct z_stream_s;
+
+namespace lynx
+{
+namespace http
+{
+enum class Encoding
+{
+	kIdentity,
+	kGzip,
+	kDeflate
+};
+
+// 按 Accept-Encoding 选择编码，优先 gzip，忽略 q=0 的项
+Encoding negotiate(std::string_view accept_encoding);
+// Content-Encoding 的取值
+const char* encodingName(Encoding encoding);
+// 文本类压缩收益明显；图片、压缩包等已压缩格式直接跳过
+bool compressible(std::string_view content_type);
+
+// 从当前线程的 z_stream 池中借出，析构时 reset 后归还，避免反复
+// deflateInit/deflateEnd 带来的内存分配
+class Deflater : public base::noncopyable
+{
+  private:
+	Encoding encoding_;
+	int level_;
+	z_stream_s* zs_;
+
+  public:
+	explicit Deflater(Encoding encoding, int level = 6);
+	~Deflater();
+
+	// 压缩结果追加到 out；finish 为 true 时结束当前流
+	bool compress(std::string_view in, bool finish, std::string* out);
+
+	Encoding encoding() const
+	{
+		return encoding_;
+	}
+};
+
+// 一次性压缩整个 body
+std::string compress(std::string_view in, Encoding encoding, int level = 6);
+} // namespace http
+} // namespace lynx
+
+#endif
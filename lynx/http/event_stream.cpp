@@ -0,0 +1,221 @@
+#include "lynx/http/event_stream.hpp"
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+
+using namespace lynx;
+using namespace lynx::http;
+
+namespace
+{
+void discardMessage(const std::shared_ptr<tcp::Connection>&, tcp::Buffer* buf)
+{
+	buf->retrieve(buf->readableBytes());
+}
+
+// 字段值中不能出现换行，否则会被解析成新的字段
+void appendField(std::string* out, std::string_view name,
+				 std::string_view value)
+{
+	size_t start = 0;
+	while (true)
+	{
+		size_t end = value.find('\n', start);
+		std::string_view line = value.substr(
+			start, end == std::string_view::npos ? end : end - start);
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.remove_suffix(1);
+		}
+
+		out->append(name);
+		out->append(": ");
+		out->append(line);
+		out->push_back('\n');
+
+		if (end == std::string_view::npos)
+		{
+			break;
+		}
+		start = end + 1;
+	}
+}
+} // namespace
+
+EventStream::EventStream(EventStreamHub* hub,
+						 const std::shared_ptr<tcp::Connection>& conn,
+						 const std::string& last_event_id)
+	: hub_(hub), group_(nullptr), conn_(conn), loop_(conn->loop()),
+	  last_event_id_(last_event_id), last_write_(time::TimeStamp::now())
+{
+}
+
+EventStream::~EventStream()
+{
+}
+
+std::string EventStream::encode(std::string_view data, std::string_view event,
+								std::string_view id)
+{
+	std::string frame;
+	frame.reserve(data.size() + event.size() + id.size() + 24);
+
+	if (!event.empty())
+	{
+		appendField(&frame, "event", event);
+	}
+	if (!id.empty())
+	{
+		appendField(&frame, "id", id);
+	}
+	appendField(&frame, "data", data);
+	frame.push_back('\n');
+	return frame;
+}
+
+std::string EventStream::encodeRetry(int milliseconds)
+{
+	return "retry: " + std::to_string(milliseconds) + "\n\n";
+}
+
+void EventStream::send(std::string_view data, std::string_view event,
+					   std::string_view id)
+{
+	std::string frame = encode(data, event, id);
+	loop_->runInLoop([self = shared_from_this(), frame]()
+					 { self->sendFrame(frame); });
+}
+
+void EventStream::sendFrame(const std::string& frame)
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	if (!conn || !conn->connected())
+	{
+		return;
+	}
+
+	// 直接丢弃事件客户端无从知晓，断开后它才会凭 Last-Event-ID 重连补齐
+	if (conn->outputBytes() > hub_->high_water_mark_)
+	{
+		LOG_WARN << "EventStream: slow consumer "
+				 << conn->addr().toFormattedString() << ", disconnecting";
+		conn->forceClose();
+		return;
+	}
+
+	last_write_ = time::TimeStamp::now();
+	conn->send(frame.data(), frame.size());
+}
+
+void EventStream::close()
+{
+	if (auto conn = conn_.lock())
+	{
+		conn->shutdown();
+	}
+}
+
+void EventStream::drain()
+{
+	if (auto conn = conn_.lock())
+	{
+		conn->setBusy(false);
+	}
+}
+
+void EventStream::handleClose()
+{
+	std::shared_ptr<EventStream> self = shared_from_this();
+	hub_->leave(this);
+	if (hub_->close_callback_)
+	{
+		hub_->close_callback_(self);
+	}
+}
+
+EventStreamHub::EventStreamHub()
+	: heartbeat_interval_(15.0), high_water_mark_(1024 * 1024)
+{
+}
+
+EventStreamHub::~EventStreamHub()
+{
+}
+
+std::shared_ptr<EventStream> EventStreamHub::open(
+	const Request& req, Response* res,
+	const std::shared_ptr<tcp::Connection>& conn)
+{
+	res->setEventStream();
+	conn->send(res->toFormattedString());
+
+	auto stream =
+		std::make_shared<EventStream>(this, conn, req.header("last-event-id"));
+
+	// 单向推送，客户端之后发来的数据直接丢弃
+	conn->setMessageCallback(discardMessage);
+
+	std::weak_ptr<EventStream> weak = stream;
+	conn->setConnectCallback(
+		[prev = conn->connectCallback(),
+		 weak](const std::shared_ptr<tcp::Connection>& c)
+		{
+			if (prev)
+			{
+				prev(c);
+			}
+
+			auto stream = weak.lock();
+			if (stream && c->disconnected())
+			{
+				stream->handleClose();
+			}
+		});
+
+	join(stream);
+	if (open_callback_)
+	{
+		open_callback_(stream);
+	}
+	return stream;
+}
+
+void EventStreamHub::broadcast(std::string_view data, std::string_view event,
+							   std::string_view id)
+{
+	auto frame = std::make_shared<const std::string>(
+		EventStream::encode(data, event, id));
+	streams_.forEach([frame](EventStream* stream)
+					 { stream->sendFrame(*frame); });
+}
+
+void EventStreamHub::join(const std::shared_ptr<EventStream>& stream)
+{
+	stream->group_ = streams_.join(stream, heartbeat_interval_,
+								   [this](EventStream::Group* group)
+								   { heartbeat(group); });
+}
+
+void EventStreamHub::leave(EventStream* stream)
+{
+	streams_.leave(stream, stream->group_);
+	stream->group_ = nullptr;
+}
+
+void EventStreamHub::heartbeat(EventStream::Group* group)
+{
+	static const std::string comment = ": ping\n\n";
+
+	time::TimeStamp idle =
+		time::TimeStamp::addTime(time::TimeStamp::now(), -heartbeat_interval_);
+	for (auto& item : group->members)
+	{
+		if (item.second->last_write_ <= idle)
+		{
+			item.second->sendFrame(comment);
+		}
+	}
+}
@@ -0,0 +1,175 @@
+#ifndef LYNX_HTTP_EVENT_STREAM_HPP
+#define LYNX_HTTP_EVENT_STREAM_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/http/fan_out.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <any>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+namespace lynx
+{
+namespace tcp
+{
+class Connection;
+class EventLoop;
+} // namespace tcp
+
+namespace http
+{
+class Request;
+class Response;
+class EventStreamHub;
+// Server-Sent Events 连接，由 EventStreamHub::open 创建
+class EventStream : public base::noncopyable,
+					public std::enable_shared_from_this<EventStream>
+{
+	friend class EventStreamHub;
+
+  private:
+	using Group = FanOut<EventStream>::Group;
+
+	EventStreamHub* hub_;
+	Group* group_;
+	std::weak_ptr<tcp::Connection> conn_;
+	tcp::EventLoop* loop_;
+	std::string last_event_id_;
+
+	time::TimeStamp last_write_;
+
+	std::any ctx_;
+
+  public:
+	EventStream(EventStreamHub* hub,
+				const std::shared_ptr<tcp::Connection>& conn,
+				const std::string& last_event_id);
+	~EventStream();
+
+	// 线程安全
+	void send(std::string_view data, std::string_view event = {},
+			  std::string_view id = {});
+	void close();
+
+	// 服务端 drain：已排队的事件写完后结束流，客户端凭 Last-Event-ID
+	// 重连到新进程。仅限 loop 线程
+	void drain();
+
+	// 发送已编码好的事件，仅限 loop 线程；
+	// output buffer 超过高水位时断开连接，客户端凭 Last-Event-ID 重连补齐
+	void sendFrame(const std::string& frame);
+
+	// 重连时客户端带上的 Last-Event-ID
+	const std::string& lastEventId() const
+	{
+		return last_event_id_;
+	}
+
+	std::shared_ptr<tcp::Connection> connection() const
+	{
+		return conn_.lock();
+	}
+
+	tcp::EventLoop* loop() const
+	{
+		return loop_;
+	}
+
+	void setContext(const std::any& ctx)
+	{
+		ctx_ = ctx;
+	}
+
+	template <typename T> T& context()
+	{
+		return std::any_cast<T&>(ctx_);
+	}
+
+	// data 中的换行拆成多行 "data:"
+	static std::string encode(std::string_view data,
+							  std::string_view event = {},
+							  std::string_view id = {});
+	// 建议客户端的重连间隔
+	static std::string encodeRetry(int milliseconds);
+
+  private:
+	void handleClose();
+};
+
+// 管理所有 SSE 连接：按 loop 分组的心跳与广播
+class EventStreamHub : public base::noncopyable
+{
+	friend class EventStream;
+
+  public:
+	using event_callback = std::function<void(
+		const std::shared_ptr<EventStream>&)>;
+
+  private:
+	event_callback open_callback_;
+	event_callback close_callback_;
+
+	double heartbeat_interval_;
+	size_t high_water_mark_;
+
+	FanOut<EventStream> streams_;
+
+  public:
+	EventStreamHub();
+	~EventStreamHub();
+
+	// 注册到 Router，如 router.addRoute("GET", "/events", hub.handler())；
+	// EventStreamHub 的生命周期需长于 Server
+	Router::http_handler handler()
+	{
+		return [this](const Request& req, Response* res,
+					  const std::shared_ptr<tcp::Connection>& conn)
+		{ open(req, res, conn); };
+	}
+
+	std::shared_ptr<EventStream> open(
+		const Request& req, Response* res,
+		const std::shared_ptr<tcp::Connection>& conn);
+
+	// 线程安全：事件只编码一次，再分发到各 loop 中发送
+	void broadcast(std::string_view data, std::string_view event = {},
+				   std::string_view id = {});
+
+	void setOpenCallback(event_callback cb)
+	{
+		open_callback_ = std::move(cb);
+	}
+
+	void setCloseCallback(event_callback cb)
+	{
+		close_callback_ = std::move(cb);
+	}
+
+	// 超过该时间没有写出数据的连接发送注释行，防止被中间代理断开
+	void setHeartbeatInterval(double seconds)
+	{
+		heartbeat_interval_ = seconds;
+	}
+
+	void setHighWaterMark(size_t bytes)
+	{
+		high_water_mark_ = bytes;
+	}
+
+	size_t size() const
+	{
+		return streams_.size();
+	}
+
+  private:
+	void join(const std::shared_ptr<EventStream>& stream);
+	void leave(EventStream* stream);
+	void heartbeat(EventStream::Group* group);
+};
+} // namespace http
+} // namespace lynx
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef LYNX_HTTP_FAN_OUT_HPP
+#define LYNX_HTTP_FAN_OUT_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace http
+{
+// 长连接（WebSocket、SSE）按所属 loop 分组：成员只在本 loop 线程中访问，
+// 广播时消息只编码一次，再投递到各 loop 中发送。
+// Member 需提供 loop()、connection() 与 drain()：服务端 drain 时调用后者，
+// 发出结束通知并清除连接的 busy，而不是等到超时被强制关闭
+template <typename Member> class FanOut : public base::noncopyable
+{
+  public:
+	struct Group
+	{
+		tcp::EventLoop* loop;
+		// 只在 loop 线程中访问
+		std::unordered_map<Member*, std::shared_ptr<Member>> members;
+	};
+
+	using tick_callback = std::function<void(Group*)>;
+
+  private:
+	std::mutex mtx_;
+	// guarded by mutex
+	std::vector<std::shared_ptr<Group>> groups_;
+	std::atomic<size_t> size_;
+
+  public:
+	FanOut() : size_(0)
+	{
+	}
+
+	// 仅限 member 所属 loop 线程。分组首次创建时在该 loop 上
+	// 每 interval 秒调用一次 tick，每个 loop 一个定时器，而不是每个连接一个
+	Group* join(const std::shared_ptr<Member>& member, double interval,
+				const tick_callback& tick)
+	{
+		Group* group = localGroup(member->loop(), interval, tick);
+		group->members[member.get()] = member;
+		size_.fetch_add(1, std::memory_order_relaxed);
+
+		if (auto conn = member->connection())
+		{
+			std::weak_ptr<Member> weak = member;
+			conn->setDrainCallback(
+				[weak]()
+				{
+					if (auto member = weak.lock())
+					{
+						member->drain();
+					}
+				});
+		}
+		return group;
+	}
+
+	// 仅限 group 所属 loop 线程
+	void leave(Member* member, Group* group)
+	{
+		if (group != nullptr && group->members.erase(member))
+		{
+			size_.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	// 线程安全：在每个 loop 线程中对其全部成员调用 fn(Member*)。
+	// 先复制一份成员，fn 中关闭连接导致的 leave 不影响遍历
+	template <typename F> void forEach(F fn)
+	{
+		std::vector<std::shared_ptr<Group>> groups;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			groups = groups_;
+		}
+
+		for (auto& group : groups)
+		{
+			group->loop->runInLoop(
+				[group, fn]()
+				{
+					std::vector<std::shared_ptr<Member>> members;
+					members.reserve(group->members.size());
+					for (auto& item : group->members)
+					{
+						members.push_back(item.second);
+					}
+					for (auto& member : members)
+					{
+						fn(member.get());
+					}
+				});
+		}
+	}
+
+	size_t size() const
+	{
+		return size_.load(std::memory_order_relaxed);
+	}
+
+  private:
+	Group* localGroup(tcp::EventLoop* loop, double interval,
+					  const tick_callback& tick)
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		for (auto& group : groups_)
+		{
+			if (group->loop == loop)
+			{
+				return group.get();
+			}
+		}
+
+		auto group = std::make_shared<Group>();
+		group->loop = loop;
+		groups_.push_back(group);
+
+		std::weak_ptr<Group> weak = group;
+		loop->runEvery(interval,
+					   [weak, tick]()
+					   {
+						   if (auto group = weak.lock())
+						   {
+							   tick(group.get());
+						   }
+					   });
+		return group.get();
+	}
+};
+} // namespace http
+} // namespace lynx
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef LYNX_HTTP_MIDDLEWARE_HPP
+#define LYNX_HTTP_MIDDLEWARE_HPP
+
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/json/writer.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/rate_limiter.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+namespace lynx
+{
+namespace http
+{
+// 中间件是形如
+//   void(const Request&, Response*, const std::shared_ptr<tcp::Connection>&,
+//        Next&& next) const
+// 的可调用对象：next() 之前为 before，之后为 after，
+// 不调用 next() 即短路。中间件会被多个 sub-reactor 并发调用，需线程安全。
+//
+// Pipeline 在注册路由时把中间件和处理函数组合成一个 lambda，
+// next 的类型在编译期确定、可以被内联，每次请求既不遍历
+// std::function 列表，也不分配内存。
+template <typename... Middlewares> class Pipeline
+{
+  private:
+	std::tuple<Middlewares...> mws_;
+
+	template <size_t I, typename Handler>
+	static void run(const std::tuple<Middlewares...>& mws,
+					const Handler& handler, const Request& req, Response* res,
+					const std::shared_ptr<tcp::Connection>& conn)
+	{
+		if constexpr (I == sizeof...(Middlewares))
+		{
+			handler(req, res, conn);
+		}
+		else
+		{
+			std::get<I>(mws)(
+				req, res, conn,
+				[&]() { run<I + 1>(mws, handler, req, res, conn); });
+		}
+	}
+
+  public:
+	explicit Pipeline(Middlewares... mws) : mws_(std::move(mws)...)
+	{
+	}
+
+	// 追加中间件，返回新的 Pipeline，原有的可以继续复用
+	template <typename... More>
+	Pipeline<Middlewares..., std::decay_t<More>...> use(More&&... more) const
+	{
+		return std::apply(
+			[&](const auto&... mws)
+			{
+				return Pipeline<Middlewares..., std::decay_t<More>...>(
+					mws..., std::forward<More>(more)...);
+			},
+			mws_);
+	}
+
+	template <typename Handler>
+	Router::http_handler handle(Handler handler) const
+	{
+		return [mws = mws_, handler = std::move(handler)](
+				   const Request& req, Response* res,
+				   const std::shared_ptr<tcp::Connection>& conn)
+		{ run<0>(mws, handler, req, res, conn); };
+	}
+};
+
+// http::use(AccessLog{}, Cors{}).handle(handler)
+template <typename... Middlewares>
+Pipeline<std::decay_t<Middlewares>...> use(Middlewares&&... mws)
+{
+	return Pipeline<std::decay_t<Middlewares>...>(
+		std::forward<Middlewares>(mws)...);
+}
+
+// 访问日志：方法、路径、状态码与处理耗时；
+// deferred 的处理函数（如反向代理）记录的是其返回时的状态
+struct AccessLog
+{
+	template <typename Next>
+	void operator()(const Request& req, Response* res,
+					const std::shared_ptr<tcp::Connection>& conn,
+					Next&& next) const
+	{
+		time::TimeStamp start = time::TimeStamp::now();
+		next();
+		int64_t elapsed = time::TimeStamp::now().microseconds() -
+						  start.microseconds();
+		LOG_INFO << req.method << " " << req.path << " " << res->statusCode()
+				 << " " << conn->addr().ip() << " " << elapsed << "us";
+	}
+};
+
+// 跨域：附加 CORS 头，OPTIONS 预检请求直接回复 204
+struct Cors
+{
+	std::string allow_origin = "*";
+	std::string allow_methods = "GET, POST, PUT, DELETE, OPTIONS";
+	std::string allow_headers = "Content-Type, Authorization";
+	int max_age = 86400;
+
+	template <typename Next>
+	void operator()(const Request& req, Response* res,
+					const std::shared_ptr<tcp::Connection>& conn,
+					Next&& next) const
+	{
+		res->setHeader("Access-Control-Allow-Origin", allow_origin);
+		if (req.method == "OPTIONS")
+		{
+			res->setStatusCode(204);
+			res->setHeader("Access-Control-Allow-Methods", allow_methods);
+			res->setHeader("Access-Control-Allow-Headers", allow_headers);
+			res->setHeader("Access-Control-Max-Age", std::to_string(max_age));
+			conn->send(res->toFormattedString());
+			return;
+		}
+		next();
+	}
+};
+
+// 校验 Authorization: Bearer <token>，verify 返回 false 时回复 401
+template <typename Verify> struct BearerAuth
+{
+	Verify verify;
+
+	template <typename Next>
+	void operator()(const Request& req, Response* res,
+					const std::shared_ptr<tcp::Connection>& conn,
+					Next&& next) const
+	{
+		std::string auth = req.header("authorization");
+		std::string_view token = auth;
+		if (!token.starts_with("Bearer ") || !verify(token.substr(7)))
+		{
+			res->setStatusCode(401);
+			res->setHeader("WWW-Authenticate", "Bearer");
+			res->setContentType("application/json");
+			res->setBody(R"({"error":"unauthorized"})");
+			conn->send(res->toFormattedString());
+			return;
+		}
+		next();
+	}
+};
+
+template <typename Verify> BearerAuth(Verify) -> BearerAuth<Verify>;
+
+// 按客户端 IP 限制请求速率（令牌桶，每秒 rate 个，突发 burst 个），
+// 超出时回复 429。桶按 loop 分片：同一 IP 的连接分散在多个 sub-reactor
+// 上时各自计数，因此应配合 Server::setMaxConnectionsPerIp 使用
+struct RateLimit
+{
+	double rate;
+	double burst;
+	uint64_t id = tcp::RateLimiter::nextId(); // 复制后仍共用同一组分片
+
+	template <typename Next>
+	void operator()(const Request&, Response* res,
+					const std::shared_ptr<tcp::Connection>& conn,
+					Next&& next) const
+	{
+		tcp::RateLimiter& limiter = tcp::RateLimiter::local(id, rate, burst);
+		if (!limiter.allow(conn->addr().ip()))
+		{
+			res->setStatusCode(429);
+			res->setHeader("Retry-After",
+						   std::to_string(static_cast<int64_t>(
+							   std::ceil(1 / std::max(rate, 1e-3)))));
+			res->setContentType("application/json");
+			res->setBody(R"({"error":"too many requests"})");
+			conn->send(res->toFormattedString());
+			return;
+		}
+		next();
+	}
+};
+
+// 处理函数抛出的异常转换为 JSON 错误响应
+struct JsonError
+{
+	int status = 400;
+
+	template <typename Next>
+	void operator()(const Request&, Response* res,
+					const std::shared_ptr<tcp::Connection>& conn,
+					Next&& next) const
+	{
+		try
+		{
+			next();
+		}
+		catch (const std::exception& e)
+		{
+			res->setStatusCode(status);
+			res->setContentType("application/json");
+			// 异常信息可能含引号等字符（如不存在的键名），需转义
+			std::string body;
+			json::Writer writer(&body);
+			writer.startObject();
+			writer.key("error");
+			writer.string(e.what());
+			writer.endObject();
+			res->setBody(body);
+			conn->send(res->toFormattedString());
+		}
+	}
+};
+} // namespace http
+} // namespace lynx
+
+#endif
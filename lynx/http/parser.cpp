@@ -1,9 +1,12 @@
 #include "lynx/http/parser.hpp"
+#include <charconv>
 
 using namespace lynx;
 using namespace lynx::http;
 
-Parser::Parser() : state_(State::kStart)
+Parser::Parser(const Limits& limits)
+	: state_(State::kStart), body_remaining_(0), limits_(limits),
+	  header_bytes_(0), header_count_(0), error_status_(0)
 {
 }
 
@@ -13,6 +16,34 @@ Parser::~Parser()
 
 bool Parser::consume(char c)
 {
+	// 请求行与头部逐字节计数，慢速发送也无法绕过
+	if (state_ != State::kBody && ++header_bytes_ > limits_.max_header_bytes)
+	{
+		state_ = State::kError;
+		return fail(431);
+	}
+
+	if (!step(c))
+	{
+		state_ = State::kError;
+		if (error_status_ == 0)
+		{
+			error_status_ = 400;
+		}
+		return false;
+	}
+	return true;
+}
+
+bool Parser::step(char c)
+{
+	if ((state_ == State::kPath || state_ == State::kQueryKey ||
+		 state_ == State::kQueryValue || state_ == State::kFragment) &&
+		c != ' ')
+	{
+		req_.target += c;
+	}
+
 	switch (state_)
 	{
 	case State::kStart:
@@ -156,7 +187,10 @@ bool Parser::consume(char c)
 		}
 		if (c == '\r')
 		{
-
+			if (++header_count_ > limits_.max_headers)
+			{
+				return fail(431);
+			}
 			req_.headers[tmp_key_] = tmp_value_;
 			tmp_key_.clear();
 			tmp_value_.clear();
@@ -182,11 +216,31 @@ bool Parser::consume(char c)
 	case State::kExpectDoubleLf:
 		if (c == '\n')
 		{
+			// HTTP/1.1 默认长连接，HTTP/1.0 需显式声明 keep-alive
+			std::string conn_header = req_.header("connection");
+			for (char& ch : conn_header)
+			{
+				ch = static_cast<char>(std::tolower(ch));
+			}
+			req_.keep_alive = conn_header != "close" &&
+							  (req_.version == "HTTP/1.1" ||
+							   conn_header == "keep-alive");
+
 			// 检查是否有 Content-Length 决定是否需要解析 Body
 			auto it = req_.headers.find("content-length");
 			if (it != req_.headers.end())
 			{
-				body_remaining_ = std::stol(it->second);
+				const std::string& len = it->second;
+				auto [end, ec] = std::from_chars(
+					len.data(), len.data() + len.size(), body_remaining_);
+				if (ec != std::errc() || end != len.data() + len.size())
+				{
+					return false;
+				}
+				if (body_remaining_ > limits_.max_body_bytes)
+				{
+					return fail(413);
+				}
 				req_.body.reserve(body_remaining_);
 				state_ =
 					(body_remaining_ > 0) ? State::kBody : State::kComplete;
@@ -9,6 +9,16 @@ namespace lynx
 {
 namespace http
 {
+// 单个请求的大小与时间限制，超时由 Session 在绑定连接后检查
+struct Limits
+{
+	size_t max_header_bytes = 8 * 1024; // 请求行与全部头部
+	size_t max_headers = 100;
+	size_t max_body_bytes = 8 * 1024 * 1024;
+	double header_timeout = 10; // 第一个字节到头部结束（秒），0 不限
+	double body_timeout = 30;	// 头部结束到 body 读完（秒），0 不限
+};
+
 class Parser : public base::noncopyable
 {
   public:
@@ -39,8 +49,13 @@ class Parser : public base::noncopyable
 	std::string tmp_value_;
 	size_t body_remaining_;
 
+	Limits limits_;
+	size_t header_bytes_;
+	size_t header_count_;
+	int error_status_; // 出错时应回复的状态码
+
   public:
-	Parser();
+	explicit Parser(const Limits& limits = Limits());
 	~Parser();
 
 	size_t bodyRemaining() const
@@ -55,6 +70,9 @@ class Parser : public base::noncopyable
 		tmp_key_.clear();
 		tmp_value_.clear();
 		body_remaining_ = 0;
+		header_bytes_ = 0;
+		header_count_ = 0;
+		error_status_ = 0;
 
 		req_.clear();
 	}
@@ -97,7 +115,27 @@ class Parser : public base::noncopyable
 		return req_;
 	}
 
+	const Limits& limits() const
+	{
+		return limits_;
+	}
+
+	// consume 返回 false 后有效：400、431 或 413
+	int errorStatus() const
+	{
+		return error_status_;
+	}
+
 	bool consume(char c);
+
+  private:
+	bool step(char c);
+
+	bool fail(int status)
+	{
+		error_status_ = status;
+		return false;
+	}
 };
 } // namespace http
 } // namespace lynx
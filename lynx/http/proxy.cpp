@@ -0,0 +1,489 @@
+#include "lynx/http/proxy.hpp"
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include "lynx/time/timer_id.hpp"
+#include <format>
+
+using namespace lynx;
+using namespace lynx::http;
+
+struct Proxy::Exchange
+{
+	tcp::EventLoop* loop = nullptr;
+	std::weak_ptr<tcp::Connection> downstream;
+	std::weak_ptr<tcp::Connection> upstream;
+	Upstream* target = nullptr;
+
+	std::string request;
+	bool keep_alive = false; // 下游连接
+	bool close_downstream = false;
+	bool head = false;
+	bool idempotent = false;
+
+	int attempts = 0;
+	bool counted = false;  // 已计入 target->active
+	bool received = false; // 本次尝试已收到上游数据
+	bool header_sent = false;
+	bool done = false;
+
+	time::TimeStamp last_active;
+	time::TimerId timer;
+	ResponseParser parser;
+};
+
+namespace
+{
+void discardMessage(const std::shared_ptr<tcp::Connection>&, tcp::Buffer* buf)
+{
+	buf->retrieve(buf->readableBytes());
+}
+
+// 逐跳头部不转发，由代理按两侧连接各自决定
+bool hopByHop(const std::string& key)
+{
+	return key == "connection" || key == "keep-alive" ||
+		   key == "proxy-connection" || key == "te" || key == "trailer" ||
+		   key == "upgrade";
+}
+
+bool wantKeepAlive(const Request& req)
+{
+	std::string conn_header = req.header("connection");
+	return !(conn_header == "close" ||
+			 (req.version == "HTTP/1.0" && conn_header != "keep-alive"));
+}
+
+void detach(const std::shared_ptr<tcp::Connection>& upstream)
+{
+	upstream->setMessageCallback(discardMessage);
+	upstream->setConnectCallback(nullptr);
+}
+} // namespace
+
+Proxy::Proxy(const std::vector<tcp::InetAddr>& upstreams,
+			 Balancer::Policy policy)
+	: balancer_(upstreams, policy), timeout_(30.0),
+	  high_water_mark_(1024 * 1024)
+{
+}
+
+Proxy::~Proxy()
+{
+}
+
+void Proxy::forward(const Request& req, Response* res,
+					const std::shared_ptr<tcp::Connection>& conn)
+{
+	// 响应由上游回调写回，调用方不要在返回后关闭连接
+	res->setDeferred();
+
+	auto ex = std::make_shared<Exchange>();
+	ex->loop = conn->loop();
+	ex->downstream = conn;
+	ex->request = buildRequest(req, conn->addr());
+	ex->keep_alive = wantKeepAlive(req) && !conn->draining();
+	ex->close_downstream = !ex->keep_alive;
+	ex->head = req.method == "HEAD";
+	ex->idempotent = req.method == "GET" || ex->head;
+
+	std::string key;
+	if (!hash_header_.empty())
+	{
+		key = req.header(hash_header_);
+	}
+	if (key.empty())
+	{
+		key = conn->addr().ip();
+	}
+	ex->target = balancer_.select(key);
+
+	start(ex);
+}
+
+void Proxy::start(const std::shared_ptr<Exchange>& ex)
+{
+	++ex->attempts;
+	ex->counted = true;
+	ex->received = false;
+	ex->target->active.fetch_add(1, std::memory_order_relaxed);
+
+	tcp::ClientPool::local(ex->loop)->acquire(
+		ex->target->addr,
+		[this, ex](const std::shared_ptr<tcp::Connection>& upstream)
+		{ onUpstream(ex, upstream); });
+}
+
+void Proxy::onUpstream(const std::shared_ptr<Exchange>& ex,
+					   const std::shared_ptr<tcp::Connection>& upstream)
+{
+	if (!upstream)
+	{
+		LOG_WARN << "Proxy: connect to upstream "
+				 << ex->target->addr.toFormattedString() << " failed";
+		endAttempt(ex);
+		balancer_.markFailure(ex->target);
+		fail(ex, 502);
+		return;
+	}
+
+	std::shared_ptr<tcp::Connection> downstream = ex->downstream.lock();
+	if (!downstream || !downstream->connected())
+	{
+		endAttempt(ex);
+		ex->done = true;
+		tcp::ClientPool::local(ex->loop)->release(upstream);
+		return;
+	}
+
+	ex->upstream = upstream;
+	ex->parser.clear();
+	ex->parser.expectNoBody(ex->head);
+
+	// 回调持有 ex，ex 只弱引用两端连接，不会形成环
+	upstream->setMessageCallback(
+		[this, ex](const std::shared_ptr<tcp::Connection>& c, tcp::Buffer* buf)
+		{ onUpstreamMessage(ex, c, buf); });
+	upstream->setConnectCallback(
+		[this, ex](const std::shared_ptr<tcp::Connection>& c)
+		{
+			if (c->disconnected())
+			{
+				onUpstreamClose(ex);
+			}
+		});
+
+	ex->last_active = time::TimeStamp::now();
+	if (!ex->timer.isAlive())
+	{
+		std::weak_ptr<Exchange> weak = ex;
+		ex->timer = ex->loop->runAfter(timeout_,
+									   [this, weak]()
+									   {
+										   if (auto ex = weak.lock())
+										   {
+											   onTimeout(ex);
+										   }
+									   });
+	}
+
+	upstream->send(ex->request.data(), ex->request.size());
+}
+
+void Proxy::onUpstreamMessage(const std::shared_ptr<Exchange>& ex,
+							  const std::shared_ptr<tcp::Connection>& upstream,
+							  tcp::Buffer* buf)
+{
+	if (ex->done)
+	{
+		buf->retrieve(buf->readableBytes());
+		return;
+	}
+
+	ex->received = true;
+	ex->last_active = time::TimeStamp::now();
+
+	std::shared_ptr<tcp::Connection> downstream = ex->downstream.lock();
+	if (!downstream || !downstream->connected())
+	{
+		// 下游已断开，上游响应读到一半，连接不能再复用
+		buf->retrieve(buf->readableBytes());
+		abort(ex);
+		return;
+	}
+
+	ResponseParser& parser = ex->parser;
+	if (!parser.headerCompleted())
+	{
+		if (!parser.parseHeader(buf))
+		{
+			LOG_WARN << "Proxy: bad response from upstream "
+					 << ex->target->addr.toFormattedString();
+			buf->retrieve(buf->readableBytes());
+			balancer_.markFailure(ex->target);
+			abort(ex);
+			return;
+		}
+
+		if (!parser.headerCompleted())
+		{
+			return;
+		}
+
+		// 以关闭为结束标志的响应，下游也只能用关闭来结束；
+		// 转发期间开始 drain 的连接同样在响应后关闭
+		if (parser.untilClose() || downstream->draining())
+		{
+			ex->close_downstream = true;
+		}
+		std::string header = buildHeader(parser, !ex->close_downstream);
+		downstream->send(header.data(), header.size());
+		ex->header_sent = true;
+	}
+
+	while (buf->readableBytes() > 0 && !parser.completed())
+	{
+		size_t n = parser.consumeBody(buf->peek(), buf->readableBytes());
+		downstream->send(buf->peek(), n);
+		buf->retrieve(n);
+
+		if (parser.error())
+		{
+			LOG_WARN << "Proxy: bad chunked body from upstream "
+					 << ex->target->addr.toFormattedString();
+			buf->retrieve(buf->readableBytes());
+			balancer_.markFailure(ex->target);
+			abort(ex);
+			return;
+		}
+	}
+
+	if (parser.completed())
+	{
+		// 响应之后还有多余数据说明上游状态异常，不复用
+		bool reusable = parser.keepAlive() && buf->readableBytes() == 0;
+		buf->retrieve(buf->readableBytes());
+		complete(ex, reusable);
+	}
+	else if (downstream->outputBytes() > high_water_mark_)
+	{
+		// 下游写不动时暂停读上游，避免响应整体堆积在内存中
+		upstream->stopRead();
+		std::weak_ptr<tcp::Connection> weak = upstream;
+		downstream->setFlushCallback(
+			[weak]()
+			{
+				if (auto c = weak.lock())
+				{
+					c->startRead();
+				}
+			});
+	}
+}
+
+void Proxy::onUpstreamClose(const std::shared_ptr<Exchange>& ex)
+{
+	if (ex->done)
+	{
+		return;
+	}
+
+	if (ex->parser.untilClose())
+	{
+		ex->parser.finish();
+		complete(ex, false);
+		return;
+	}
+
+	endAttempt(ex);
+
+	// 复用的空闲连接可能恰好被上游关闭，幂等请求换一条连接重试一次
+	if (!ex->received && ex->idempotent && ex->attempts < 2)
+	{
+		LOG_DEBUG << "Proxy: upstream closed before response, retrying";
+		start(ex);
+		return;
+	}
+
+	LOG_WARN << "Proxy: upstream " << ex->target->addr.toFormattedString()
+			 << " closed before response completed";
+	balancer_.markFailure(ex->target);
+	fail(ex, 502);
+}
+
+void Proxy::onTimeout(const std::shared_ptr<Exchange>& ex)
+{
+	if (ex->done)
+	{
+		return;
+	}
+
+	// 只记录最后活跃时间，未真正超时则按剩余时间重新定时
+	time::TimeStamp now = time::TimeStamp::now();
+	time::TimeStamp deadline =
+		time::TimeStamp::addTime(ex->last_active, timeout_);
+	if (now < deadline)
+	{
+		double remaining =
+			(deadline.microseconds() - now.microseconds()) / 1000000.0;
+		std::weak_ptr<Exchange> weak = ex;
+		ex->timer = ex->loop->runAfter(remaining,
+									   [this, weak]()
+									   {
+										   if (auto ex = weak.lock())
+										   {
+											   onTimeout(ex);
+										   }
+									   });
+		return;
+	}
+
+	LOG_WARN << "Proxy: upstream " << ex->target->addr.toFormattedString()
+			 << " timed out";
+	balancer_.markFailure(ex->target);
+	endAttempt(ex);
+	if (auto upstream = ex->upstream.lock())
+	{
+		detach(upstream);
+		upstream->forceClose();
+	}
+	fail(ex, 504);
+}
+
+void Proxy::complete(const std::shared_ptr<Exchange>& ex, bool reusable)
+{
+	ex->done = true;
+	endAttempt(ex);
+	balancer_.markSuccess(ex->target);
+	if (ex->timer.isAlive())
+	{
+		ex->loop->cancell(ex->timer);
+	}
+
+	if (auto upstream = ex->upstream.lock())
+	{
+		detach(upstream);
+		if (reusable)
+		{
+			tcp::ClientPool::local(ex->loop)->release(upstream);
+		}
+		else
+		{
+			upstream->forceClose();
+		}
+	}
+
+	std::shared_ptr<tcp::Connection> downstream = ex->downstream.lock();
+	if (downstream && ex->close_downstream)
+	{
+		downstream->shutdown();
+	}
+	if (downstream)
+	{
+		downstream->setBusy(false);
+	}
+}
+
+void Proxy::abort(const std::shared_ptr<Exchange>& ex)
+{
+	endAttempt(ex);
+	if (auto upstream = ex->upstream.lock())
+	{
+		detach(upstream);
+		upstream->forceClose();
+	}
+	fail(ex, 502);
+}
+
+void Proxy::fail(const std::shared_ptr<Exchange>& ex, int code)
+{
+	ex->done = true;
+	if (ex->timer.isAlive())
+	{
+		ex->loop->cancell(ex->timer);
+	}
+
+	std::shared_ptr<tcp::Connection> downstream = ex->downstream.lock();
+	if (!downstream)
+	{
+		return;
+	}
+
+	if (ex->header_sent)
+	{
+		// 响应已写出一部分，只能断开让客户端感知
+		downstream->forceClose();
+		return;
+	}
+
+	Response res;
+	res.setStatusCode(code);
+	res.setContentType("text/html");
+	res.setBody(code == 504 ? "<h1>504 Gateway Timeout</h1>"
+							: "<h1>502 Bad Gateway</h1>");
+	res.setKeepAlive(ex->keep_alive);
+	downstream->send(res.toFormattedString());
+
+	if (!ex->keep_alive)
+	{
+		downstream->shutdown();
+	}
+	downstream->setBusy(false);
+}
+
+void Proxy::endAttempt(const std::shared_ptr<Exchange>& ex)
+{
+	if (ex->counted)
+	{
+		ex->counted = false;
+		ex->target->active.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+std::string Proxy::buildRequest(const Request& req, const tcp::InetAddr& client)
+{
+	std::string result;
+	auto out = std::back_inserter(result);
+
+	// 原样转发，保留重复的键、参数顺序与无值的参数
+	std::format_to(out, "{} {} HTTP/1.1\r\n", req.method, req.target);
+
+	std::string forwarded_for = client.ip();
+	for (const auto& header : req.headers)
+	{
+		const std::string& key = header.first;
+		if (hopByHop(key) || key == "content-length" ||
+			key == "transfer-encoding" || key == "expect")
+		{
+			continue;
+		}
+
+		if (key == "x-forwarded-for")
+		{
+			forwarded_for = header.second + ", " + forwarded_for;
+			continue;
+		}
+
+		std::format_to(out, "{}: {}\r\n", key, header.second);
+	}
+
+	std::format_to(out, "x-forwarded-for: {}\r\nconnection: keep-alive\r\n",
+				   forwarded_for);
+	if (!req.body.empty() || req.method == "POST" || req.method == "PUT" ||
+		req.method == "PATCH")
+	{
+		std::format_to(out, "content-length: {}\r\n", req.body.size());
+	}
+
+	result += "\r\n";
+	result += req.body;
+	return result;
+}
+
+std::string Proxy::buildHeader(const ResponseParser& parser, bool keep_alive)
+{
+	std::string result;
+	auto out = std::back_inserter(result);
+
+	std::format_to(out, "HTTP/1.1 {} {}\r\n", parser.statusCode(),
+				   parser.statusMessage());
+
+	// transfer-encoding 保留，chunked 分帧原样转发
+	for (const auto& header : parser.headers())
+	{
+		if (!hopByHop(header.first))
+		{
+			std::format_to(out, "{}: {}\r\n", header.first, header.second);
+		}
+	}
+
+	std::format_to(out, "connection: {}\r\n\r\n",
+				   keep_alive ? "keep-alive" : "close");
+	return result;
+}
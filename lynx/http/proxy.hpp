@@ -0,0 +1,109 @@
+#ifndef LYNX_HTTP_PROXY_HPP
+#define LYNX_HTTP_PROXY_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/http/balancer.hpp"
+#include "lynx/http/router.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class Connection;
+class Buffer;
+class InetAddr;
+} // namespace tcp
+
+namespace http
+{
+class Request;
+class Response;
+class ResponseParser;
+// 反向代理：请求转发到上游，响应边收边写回下游，不整体缓存。
+// 上游连接来自所在 sub-reactor 的 tcp::ClientPool，keep-alive 复用
+class Proxy : public base::noncopyable
+{
+  private:
+	struct Exchange;
+
+	Balancer balancer_;
+	// 一致性哈希的 key 取自该请求头（小写），为空或缺失时取客户端 ip
+	std::string hash_header_;
+	double timeout_;
+	size_t high_water_mark_;
+
+  public:
+	Proxy(const std::vector<tcp::InetAddr>& upstreams,
+		  Balancer::Policy policy = Balancer::Policy::kRoundRobin);
+	~Proxy();
+
+	// 注册到 Router，Proxy 的生命周期需长于 Server
+	Router::http_handler handler()
+	{
+		return [this](const Request& req, Response* res,
+					  const std::shared_ptr<tcp::Connection>& conn)
+		{ forward(req, res, conn); };
+	}
+
+	void forward(const Request& req, Response* res,
+				 const std::shared_ptr<tcp::Connection>& conn);
+
+	void setHashHeader(const std::string& key)
+	{
+		hash_header_ = key;
+	}
+
+	// 上游无响应（两次读之间）的超时时间
+	void setTimeout(double seconds)
+	{
+		timeout_ = seconds;
+	}
+
+	// 下游 output buffer 超过该值时暂停读上游
+	void setHighWaterMark(size_t bytes)
+	{
+		high_water_mark_ = bytes;
+	}
+
+	void setMaxFails(int n)
+	{
+		balancer_.setMaxFails(n);
+	}
+
+	void setFailTimeout(double seconds)
+	{
+		balancer_.setFailTimeout(seconds);
+	}
+
+	Balancer& balancer()
+	{
+		return balancer_;
+	}
+
+  private:
+	void start(const std::shared_ptr<Exchange>& ex);
+	void onUpstream(const std::shared_ptr<Exchange>& ex,
+					const std::shared_ptr<tcp::Connection>& upstream);
+	void onUpstreamMessage(const std::shared_ptr<Exchange>& ex,
+						   const std::shared_ptr<tcp::Connection>& upstream,
+						   tcp::Buffer* buf);
+	void onUpstreamClose(const std::shared_ptr<Exchange>& ex);
+	void onTimeout(const std::shared_ptr<Exchange>& ex);
+
+	void complete(const std::shared_ptr<Exchange>& ex, bool reusable);
+	void abort(const std::shared_ptr<Exchange>& ex);
+	void fail(const std::shared_ptr<Exchange>& ex, int code);
+	void endAttempt(const std::shared_ptr<Exchange>& ex);
+
+	static std::string buildRequest(const Request& req,
+									const tcp::InetAddr& client);
+	static std::string buildHeader(const ResponseParser& parser,
+								   bool keep_alive);
+};
+} // namespace http
+} // namespace lynx
+
+#endif
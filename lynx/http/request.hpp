@@ -13,6 +13,7 @@ struct Request : public base::noncopyable
 {
 	std::string method;
 	std::string path;
+	std::string target; // 原始 request-target，含查询串，代理原样转发
 	std::string version;
 
 	std::map<std::string, std::string> headers;
@@ -39,6 +40,7 @@ struct Request : public base::noncopyable
 	{
 		method.clear();
 		path.clear();
+		target.clear();
 		version.clear();
 		headers.clear();
 		query_params.clear();
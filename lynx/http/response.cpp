@@ -4,13 +4,29 @@
 using namespace lynx;
 using namespace lynx::http;
 
-Response::Response() : version_("HTTP/1.1")
+Response::Response()
+	: status_code_(200), status_msg_("OK"), version_("HTTP/1.1"),
+	  deferred_(false), encoding_(Encoding::kIdentity),
+	  compress_min_size_(1024), compress_level_(6)
 {
 }
 Response::~Response()
 {
 }
 
+bool Response::shouldCompress() const
+{
+	if (encoding_ == Encoding::kIdentity || body_.size() < compress_min_size_ ||
+		status_code_ < 200 || status_code_ == 204 || status_code_ == 304)
+	{
+		return false;
+	}
+
+	// 处理函数已自行编码的 body 不再处理
+	return headers_.find("Content-Encoding") == headers_.end() &&
+		   compressible(header("Content-Type"));
+}
+
 std::string Response::toFormattedString() const
 {
 	std::string result;
@@ -20,14 +36,40 @@ std::string Response::toFormattedString() const
 	// 第一行
 	std::format_to(out, "{} {} {}\r\n", version_, status_code_, status_msg_);
 
+	// 压缩后反而变大（已压缩的数据）时发送原文
+	std::string compressed;
+	if (shouldCompress())
+	{
+		compressed = compress(body_, encoding_, compress_level_);
+		if (compressed.empty() || compressed.size() >= body_.size())
+		{
+			compressed.clear();
+		}
+	}
+	bool use_compressed = !compressed.empty();
+	const std::string& body = use_compressed ? compressed : body_;
+
 	// 头部
 	for (const auto& header : headers_)
 	{
+		if (use_compressed && header.first == "Content-Length")
+		{
+			std::format_to(out, "Content-Length: {}\r\n", body.size());
+			continue;
+		}
 		std::format_to(out, "{}: {}\r\n", header.first, header.second);
 	}
 
+	if (use_compressed)
+	{
+		std::format_to(out,
+					   "Content-Encoding: {}\r\nVary: Accept-Encoding\r\n",
+					   encodingName(encoding_));
+	}
+
 	// 空行和正文
-	std::format_to(out, "\r\n{}", body_);
+	result += "\r\n";
+	result += body;
 
 	return result;
-}
\ No newline at end of file
+}
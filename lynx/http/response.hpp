@@ -2,6 +2,8 @@
 #define LYNX_HTTP_RESPONSE_HPP
 
 #include "lynx/base/noncopyable.hpp"
+#include "lynx/http/compression.hpp"
+#include <cstddef>
 #include <map>
 #include <string>
 namespace lynx
@@ -16,6 +18,13 @@ class Response : public base::noncopyable
 	std::string version_;
 	std::map<std::string, std::string> headers_;
 	std::string body_;
+	// 处理函数将异步完成响应（如反向代理），连接的关闭由其自行负责
+	bool deferred_;
+
+	// 由 Router 按 Accept-Encoding 协商
+	Encoding encoding_;
+	size_t compress_min_size_;
+	int compress_level_;
 
   public:
 	Response();
@@ -55,15 +64,89 @@ class Response : public base::noncopyable
 		}
 	}
 
+	// text/event-stream：只发送头部，之后由 EventStream 持续写事件
+	void setEventStream()
+	{
+		setStatusCode(200);
+		setContentType("text/event-stream");
+		setHeader("Cache-Control", "no-cache");
+		setHeader("X-Accel-Buffering", "no");
+		setKeepAlive(true);
+		setDeferred();
+	}
+
+	// toFormattedString 时 body 满足大小与类型条件才会压缩
+	void setCompression(Encoding encoding, size_t min_size = 1024,
+						int level = 6)
+	{
+		encoding_ = encoding;
+		compress_min_size_ = min_size;
+		compress_level_ = level;
+	}
+
+	Encoding encoding() const
+	{
+		return encoding_;
+	}
+
+	size_t compressMinSize() const
+	{
+		return compress_min_size_;
+	}
+
+	int compressLevel() const
+	{
+		return compress_level_;
+	}
+
+	bool keepAlive() const
+	{
+		auto it = headers_.find("Connection");
+		return it == headers_.end() || it->second != "close";
+	}
+
+	std::string header(const std::string& key) const
+	{
+		auto it = headers_.find(key);
+		return (it != headers_.end()) ? it->second : "";
+	}
+
+	void setDeferred(bool on = true)
+	{
+		deferred_ = on;
+	}
+
+	bool deferred() const
+	{
+		return deferred_;
+	}
+
+	int statusCode() const
+	{
+		return status_code_;
+	}
+
 	std::string toFormattedString() const;
 
   private:
+	bool shouldCompress() const;
+
 	static std::string_view code2msg(int code)
 	{
 		static const std::map<int, std::string_view> status_msgs = {
-			{200, "OK"},		  {301, "Moved Permanently"},
-			{400, "Bad Request"}, {403, "Forbidden"},
-			{404, "Not Found"},	  {500, "Internal Server Error"},
+			{101, "Switching Protocols"},
+			{200, "OK"},		  {204, "No Content"},
+			{301, "Moved Permanently"},
+			{400, "Bad Request"}, {401, "Unauthorized"},
+			{403, "Forbidden"},
+			{404, "Not Found"},	  {408, "Request Timeout"},
+			{413, "Content Too Large"},
+			{426, "Upgrade Required"},
+			{429, "Too Many Requests"},
+			{431, "Request Header Fields Too Large"},
+			{500, "Internal Server Error"},
+			{502, "Bad Gateway"}, {503, "Service Unavailable"},
+			{504, "Gateway Timeout"},
 		};
 
 		auto it = status_msgs.find(code);
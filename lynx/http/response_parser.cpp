@@ -0,0 +1,346 @@
+#include "lynx/http/response_parser.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+using namespace lynx;
+using namespace lynx::http;
+
+namespace
+{
+const char kCRLF[] = "\r\n";
+const char kHeaderEnd[] = "\r\n\r\n";
+
+std::string toLower(std::string s)
+{
+	for (char& c : s)
+	{
+		c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+	return s;
+}
+
+const char* trim(const char* begin, const char* end, const char** new_end)
+{
+	while (begin < end && (*begin == ' ' || *begin == '\t'))
+	{
+		++begin;
+	}
+	while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+	{
+		--end;
+	}
+	*new_end = end;
+	return begin;
+}
+
+int hexValue(char c)
+{
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0';
+	}
+	c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	if (c >= 'a' && c <= 'f')
+	{
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+} // namespace
+
+ResponseParser::ResponseParser()
+	: state_(State::kHeader), status_code_(0), keep_alive_(false),
+	  chunked_(false), no_body_(false), body_remaining_(0),
+	  chunk_remaining_(0), trailer_line_(0), max_header_bytes_(64 * 1024)
+{
+}
+
+ResponseParser::~ResponseParser()
+{
+}
+
+void ResponseParser::clear()
+{
+	state_ = State::kHeader;
+	version_.clear();
+	status_code_ = 0;
+	status_msg_.clear();
+	headers_.clear();
+	keep_alive_ = false;
+	chunked_ = false;
+	no_body_ = false;
+	body_remaining_ = 0;
+	chunk_remaining_ = 0;
+	trailer_line_ = 0;
+}
+
+std::string ResponseParser::header(const std::string& key) const
+{
+	for (const auto& item : headers_)
+	{
+		if (item.first == key)
+		{
+			return item.second;
+		}
+	}
+	return "";
+}
+
+bool ResponseParser::parseHeader(tcp::Buffer* buf)
+{
+	if (state_ != State::kHeader)
+	{
+		return state_ != State::kError;
+	}
+
+	const char* begin = buf->peek();
+	const char* end = begin + buf->readableBytes();
+	const char* header_end =
+		std::search(begin, end, kHeaderEnd, kHeaderEnd + 4);
+	if (header_end == end)
+	{
+		if (buf->readableBytes() > max_header_bytes_)
+		{
+			state_ = State::kError;
+			return false;
+		}
+		return true; // 等待更多数据
+	}
+
+	const char* line = begin;
+	const char* eol = std::search(line, header_end + 2, kCRLF, kCRLF + 2);
+	if (!parseStatusLine(line, eol))
+	{
+		state_ = State::kError;
+		return false;
+	}
+
+	for (line = eol + 2; line < header_end + 2; line = eol + 2)
+	{
+		eol = std::search(line, header_end + 2, kCRLF, kCRLF + 2);
+		if (!parseHeaderLine(line, eol))
+		{
+			state_ = State::kError;
+			return false;
+		}
+	}
+
+	buf->retrieve(header_end + 4 - begin);
+	startBody();
+	return true;
+}
+
+bool ResponseParser::parseStatusLine(const char* begin, const char* end)
+{
+	// HTTP/1.1 200 OK
+	const char* sp = std::find(begin, end, ' ');
+	if (sp == end || end - begin < 12 || std::strncmp(begin, "HTTP/1.", 7) != 0)
+	{
+		return false;
+	}
+	version_.assign(begin, sp);
+
+	const char* code_begin = sp + 1;
+	auto [ptr, ec] = std::from_chars(code_begin, end, status_code_);
+	if (ec != std::errc() || ptr - code_begin != 3)
+	{
+		return false;
+	}
+
+	status_msg_.assign(ptr < end ? ptr + 1 : end, end);
+	return true;
+}
+
+bool ResponseParser::parseHeaderLine(const char* begin, const char* end)
+{
+	const char* colon = std::find(begin, end, ':');
+	if (colon == end || colon == begin)
+	{
+		return false;
+	}
+
+	const char* value_end;
+	const char* value_begin = trim(colon + 1, end, &value_end);
+	headers_.emplace_back(toLower(std::string(begin, colon)),
+						  std::string(value_begin, value_end));
+	return true;
+}
+
+void ResponseParser::startBody()
+{
+	std::string connection = toLower(header("connection"));
+	if (version_ == "HTTP/1.1")
+	{
+		keep_alive_ = connection.find("close") == std::string::npos;
+	}
+	else
+	{
+		keep_alive_ = connection.find("keep-alive") != std::string::npos;
+	}
+
+	// 1xx / 204 / 304 以及 HEAD 的响应没有 body
+	if (no_body_ || status_code_ / 100 == 1 || status_code_ == 204 ||
+		status_code_ == 304)
+	{
+		state_ = State::kComplete;
+		return;
+	}
+
+	std::string te = header("transfer-encoding");
+	std::string cl = header("content-length");
+	if (toLower(te).find("chunked") != std::string::npos)
+	{
+		chunked_ = true;
+		chunk_remaining_ = 0;
+		state_ = State::kChunkSize;
+	}
+	else if (!cl.empty())
+	{
+		auto [ptr, ec] =
+			std::from_chars(cl.data(), cl.data() + cl.size(), body_remaining_);
+		if (ec != std::errc() || ptr != cl.data() + cl.size())
+		{
+			state_ = State::kError;
+			return;
+		}
+		state_ = body_remaining_ > 0 ? State::kBody : State::kComplete;
+	}
+	else
+	{
+		// 没有长度信息，以关闭连接作为结束，连接不可复用
+		keep_alive_ = false;
+		state_ = State::kUntilClose;
+	}
+}
+
+size_t ResponseParser::consumeBody(const char* data, size_t len)
+{
+	switch (state_)
+	{
+	case State::kBody:
+	{
+		size_t n = std::min(len, body_remaining_);
+		body_remaining_ -= n;
+		if (body_remaining_ == 0)
+		{
+			state_ = State::kComplete;
+		}
+		return n;
+	}
+	case State::kUntilClose:
+		return len;
+	case State::kChunkSize:
+	case State::kChunkExt:
+	case State::kChunkData:
+	case State::kChunkDataEnd:
+	case State::kTrailer:
+		return consumeChunked(data, len);
+	default:
+		return 0;
+	}
+}
+
+size_t ResponseParser::consumeChunked(const char* data, size_t len)
+{
+	size_t i = 0;
+	while (i < len && state_ != State::kComplete && state_ != State::kError)
+	{
+		char c = data[i];
+		switch (state_)
+		{
+		case State::kChunkSize:
+		{
+			int v = hexValue(c);
+			if (v >= 0)
+			{
+				if (chunk_remaining_ > (SIZE_MAX >> 4))
+				{
+					state_ = State::kError;
+					return i;
+				}
+				chunk_remaining_ = (chunk_remaining_ << 4) | v;
+			}
+			else if (c == ';' || c == ' ' || c == '\t')
+			{
+				state_ = State::kChunkExt;
+			}
+			else if (c == '\n')
+			{
+				state_ = chunk_remaining_ == 0 ? State::kTrailer
+											   : State::kChunkData;
+				trailer_line_ = 0;
+			}
+			else if (c != '\r')
+			{
+				state_ = State::kError;
+				return i;
+			}
+			++i;
+			break;
+		}
+		case State::kChunkExt:
+			if (c == '\n')
+			{
+				state_ = chunk_remaining_ == 0 ? State::kTrailer
+											   : State::kChunkData;
+				trailer_line_ = 0;
+			}
+			++i;
+			break;
+		case State::kChunkData:
+		{
+			size_t n = std::min(len - i, chunk_remaining_);
+			chunk_remaining_ -= n;
+			i += n;
+			if (chunk_remaining_ == 0)
+			{
+				state_ = State::kChunkDataEnd;
+			}
+			break;
+		}
+		case State::kChunkDataEnd:
+			if (c == '\n')
+			{
+				state_ = State::kChunkSize;
+			}
+			else if (c != '\r')
+			{
+				state_ = State::kError;
+				return i;
+			}
+			++i;
+			break;
+		case State::kTrailer:
+			// 逐行跳过 trailer，遇到空行结束
+			if (c == '\n')
+			{
+				if (trailer_line_ == 0)
+				{
+					state_ = State::kComplete;
+				}
+				trailer_line_ = 0;
+			}
+			else if (c != '\r')
+			{
+				++trailer_line_;
+			}
+			++i;
+			break;
+		default:
+			return i;
+		}
+	}
+	return i;
+}
+
+void ResponseParser::finish()
+{
+	if (state_ == State::kUntilClose)
+	{
+		state_ = State::kComplete;
+	}
+}
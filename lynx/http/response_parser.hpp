@@ -0,0 +1,146 @@
+#ifndef LYNX_HTTP_RESPONSE_PARSER_HPP
+#define LYNX_HTTP_RESPONSE_PARSER_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class Buffer;
+}
+
+namespace http
+{
+// 增量解析上游响应：头部完整解析，body 只跟踪分帧（Content-Length /
+// chunked / 直到关闭），不做缓存，调用方可以边收边转发
+class ResponseParser : public base::noncopyable
+{
+  public:
+	enum class State
+	{
+		kHeader,
+		kBody,
+		kChunkSize,
+		kChunkExt,
+		kChunkData,
+		kChunkDataEnd,
+		kTrailer,
+		kUntilClose,
+		kComplete,
+		kError
+	};
+
+  private:
+	State state_;
+
+	std::string version_;
+	int status_code_;
+	std::string status_msg_;
+	// key 为小写
+	std::vector<std::pair<std::string, std::string>> headers_;
+
+	bool keep_alive_;
+	bool chunked_;
+	bool no_body_;
+	size_t body_remaining_;
+	size_t chunk_remaining_;
+	size_t trailer_line_;
+	size_t max_header_bytes_;
+
+  public:
+	ResponseParser();
+	~ResponseParser();
+
+	// 对 HEAD 请求的响应没有 body
+	void expectNoBody(bool on = true)
+	{
+		no_body_ = on;
+	}
+
+	void setMaxHeaderBytes(size_t n)
+	{
+		max_header_bytes_ = n;
+	}
+
+	// 头部不完整时不消费数据；出错返回 false
+	bool parseHeader(tcp::Buffer* buf);
+
+	// 返回 data 起始处属于当前响应 body 的字节数（含 chunk 分帧）
+	size_t consumeBody(const char* data, size_t len);
+
+	// 上游关闭连接：以关闭为结束标志的响应到此完成
+	void finish();
+
+	void clear();
+
+	State state() const
+	{
+		return state_;
+	}
+
+	bool headerCompleted() const
+	{
+		return state_ != State::kHeader && state_ != State::kError;
+	}
+
+	bool completed() const
+	{
+		return state_ == State::kComplete;
+	}
+
+	bool error() const
+	{
+		return state_ == State::kError;
+	}
+
+	bool untilClose() const
+	{
+		return state_ == State::kUntilClose;
+	}
+
+	bool keepAlive() const
+	{
+		return keep_alive_;
+	}
+
+	bool chunked() const
+	{
+		return chunked_;
+	}
+
+	int statusCode() const
+	{
+		return status_code_;
+	}
+
+	const std::string& statusMessage() const
+	{
+		return status_msg_;
+	}
+
+	const std::string& version() const
+	{
+		return version_;
+	}
+
+	const std::vector<std::pair<std::string, std::string>>& headers() const
+	{
+		return headers_;
+	}
+
+	std::string header(const std::string& key) const;
+
+  private:
+	bool parseStatusLine(const char* begin, const char* end);
+	bool parseHeaderLine(const char* begin, const char* end);
+	void startBody();
+	size_t consumeChunked(const char* data, size_t len);
+};
+} // namespace http
+} // namespace lynx
+
+#endif
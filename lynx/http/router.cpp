@@ -1,18 +1,160 @@
 #include "lynx/http/router.hpp"
+#include "lynx/http/compression.hpp"
 #include "lynx/http/request.hpp"
 #include "lynx/http/response.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/http/trace.hpp"
 #include "lynx/logger/logger.hpp"
 #include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include <chrono>
+#include <cstdio>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 using namespace lynx;
 using namespace lynx::http;
 
+namespace
+{
+// 本次请求被抽中时返回连接上的 Trace
+Trace* sampledTrace(const std::shared_ptr<tcp::Connection>& conn)
+{
+	tcp::Context* ctx = conn->findContext<tcp::Context>();
+	if (!ctx || !ctx->session_ || !ctx->session_->trace().sampled())
+	{
+		return nullptr;
+	}
+	return &ctx->session_->trace();
+}
+
+// 响应全部写出后输出；Session 随后会清空，因此拷贝一份交给 flush callback
+void finishTrace(Trace* trace, const Request& req, const Response& res,
+				 const std::shared_ptr<tcp::Connection>& conn)
+{
+	trace->mark(Trace::kHandlerDone);
+	if (trace->firstRequest())
+	{
+		trace->mark(Trace::kAccept,
+					std::chrono::duration_cast<std::chrono::nanoseconds>(
+						conn->createdTime().time_since_epoch())
+						.count());
+	}
+	trace->setRequest(conn->id(), req.method, req.path, res.statusCode());
+
+	if (conn->pendingBytes() > 0)
+	{
+		conn->appendFlushCallback(
+			[copy = *trace]() mutable
+			{
+				copy.mark(Trace::kFlushed);
+				copy.emit();
+			});
+		return;
+	}
+
+	// deferred 的响应（如反向代理）此时尚未开始写，不记录 flush
+	if (!res.deferred())
+	{
+		trace->mark(Trace::kFlushed);
+	}
+	trace->emit();
+}
+
+// 边读文件边压缩，每次 output buffer 清空后再读下一块，内存占用与文件大小无关
+class FileStreamer : public std::enable_shared_from_this<FileStreamer>
+{
+  private:
+	static constexpr size_t kChunkSize = 64 * 1024;
+
+	std::weak_ptr<tcp::Connection> conn_;
+	int fd_;
+	Deflater deflater_;
+	bool keep_alive_;
+	std::string in_;
+	std::string out_;
+
+  public:
+	FileStreamer(const std::shared_ptr<tcp::Connection>& conn, int fd,
+				 Encoding encoding, int level, bool keep_alive)
+		: conn_(conn), fd_(fd), deflater_(encoding, level),
+		  keep_alive_(keep_alive), in_(kChunkSize, '\0')
+	{
+	}
+
+	~FileStreamer()
+	{
+		::close(fd_);
+	}
+
+	void pump()
+	{
+		std::shared_ptr<tcp::Connection> conn = conn_.lock();
+		if (!conn || !conn->connected())
+		{
+			return;
+		}
+
+		while (conn->outputBytes() == 0)
+		{
+			ssize_t n = ::read(fd_, in_.data(), in_.size());
+			if (n < 0)
+			{
+				LOG_ERROR << "FileStreamer: read failed: " << strerror(errno);
+				conn->forceClose();
+				return;
+			}
+
+			bool finish = n == 0;
+			out_.clear();
+			if (!deflater_.compress(std::string_view(in_.data(), n), finish,
+									&out_))
+			{
+				conn->forceClose();
+				return;
+			}
+
+			if (!out_.empty())
+			{
+				char size_line[32];
+				int len = std::snprintf(size_line, sizeof(size_line),
+										"%zx\r\n", out_.size());
+				out_.insert(0, size_line, len);
+				out_ += "\r\n";
+				conn->send(out_.data(), out_.size());
+			}
+
+			if (finish)
+			{
+				conn->send("0\r\n\r\n");
+				if (!keep_alive_)
+				{
+					conn->shutdown();
+				}
+				conn->setBusy(false);
+				return;
+			}
+		}
+
+		// 写不完的部分在 output buffer 中，清空后继续
+		conn->setFlushCallback([self = shared_from_this()]()
+							   { self->pump(); });
+	}
+};
+} // namespace
+
 Router::Router()
+	: compression_(false), compress_min_size_(1024), compress_level_(6)
 {
-	tries_.emplace("GET", Trie());
-	tries_.emplace("POST", Trie());
+	for (const char* method :
+		 {"GET", "POST", "PUT", "DELETE", "PATCH", "HEAD", "OPTIONS"})
+	{
+		tries_.emplace(method, Trie())
+			.first->second.unmatched.init(method, "unmatched");
+	}
+	unknown_method_.init("other", "unmatched");
 }
 
 Router::~Router()
@@ -22,13 +164,38 @@ Router::~Router()
 void Router::dispatch(const Request& req, Response* res,
 					  const std::shared_ptr<tcp::Connection>& conn)
 {
-	http_handler f;
-	std::string method = req.method;
-	std::string path = req.path;
+	// drain 期间响应后关闭连接
+	res->setKeepAlive(req.keep_alive && !conn->draining());
+	if (compression_)
+	{
+		res->setCompression(negotiate(req.header("accept-encoding")),
+							compress_min_size_, compress_level_);
+	}
 
-	if ((f = tries_[method].search(path)))
+	Trace* trace = sampledTrace(conn);
+	if (trace)
 	{
-		f(req, res, conn);
+		trace->mark(Trace::kDispatch);
+	}
+
+	// 多个 sub-reactor 并发 dispatch，不能用 operator[] 插入
+	const TrieNode* node = nullptr;
+	auto it = tries_.find(req.method);
+	if (it != tries_.end() && (node = it->second.search(req.path)) && node->f)
+	{
+		// 异步完成的响应只统计处理函数返回前的耗时与状态码
+		auto start = std::chrono::steady_clock::now();
+		conn->setBusy(true);
+		node->f(req, res, conn);
+		// deferred 的响应只由其完成方清除 busy：完成方可能已在处理函数中
+		// 同步清除（文件一次写完、代理连接上游立即失败），不能再置回
+		if (!res->deferred())
+		{
+			conn->setBusy(false);
+		}
+		std::chrono::duration<double> elapsed =
+			std::chrono::steady_clock::now() - start;
+		node->metrics.record(res->statusCode(), elapsed.count());
 	}
 	else
 	{
@@ -37,9 +204,49 @@ void Router::dispatch(const Request& req, Response* res,
 		res->setBody("<h1>404 Not Found</h1>");
 
 		conn->send(res->toFormattedString());
+		conn->setBusy(false);
+		(it != tries_.end() ? it->second.unmatched : unknown_method_)
+			.record(404, 0);
+	}
+
+	if (trace)
+	{
+		finishTrace(trace, req, *res, conn);
 	}
 }
 
+void Router::enableMetrics(const std::string& path)
+{
+	addRoute("GET", path,
+			 [](const Request&, Response* res,
+				const std::shared_ptr<tcp::Connection>& conn)
+			 {
+				 res->setStatusCode(200);
+				 res->setContentType(
+					 "text/plain; version=0.0.4; charset=utf-8");
+				 res->setBody(metrics::Registry::instance().scrape());
+				 conn->send(res->toFormattedString());
+			 });
+}
+
+void Router::RouteMetrics::init(const std::string& method,
+								const std::string& route)
+{
+	metrics::Registry& registry = metrics::Registry::instance();
+	static const char* const codes[] = {"other", "1xx", "2xx",
+										"3xx",	 "4xx", "5xx"};
+	for (size_t i = 0; i < 6; ++i)
+	{
+		requests[i] = registry.counter(
+			"lynx_http_requests_total", "HTTP requests by route and status",
+			{{"method", method}, {"route", route}, {"code", codes[i]}});
+	}
+	duration = registry.histogram(
+		"lynx_http_request_duration_seconds",
+		"Time spent in the route handler", metrics::Registry::latencyBuckets(),
+		{{"method", method}, {"route", route}});
+}
+
 void Router::sendFile(const std::shared_ptr<tcp::Connection>& conn,
 					  Response* res, const std::string& file_path)
 {
@@ -48,8 +255,20 @@ void Router::sendFile(const std::shared_ptr<tcp::Connection>& conn,
 	struct stat st;
 	if (::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
 	{
+		std::string type = getMineType(path);
+		if (res->encoding() != Encoding::kIdentity && compressible(type) &&
+			static_cast<size_t>(st.st_size) >= res->compressMinSize())
+		{
+			int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd >= 0)
+			{
+				streamFile(conn, res, fd, type);
+				return;
+			}
+		}
+
 		res->setStatusCode(200);
-		res->setContentType(getMineType(path));
+		res->setContentType(type);
 		res->setHeader("Content-Length", std::to_string(st.st_size));
 
 		conn->send(res->toFormattedString());
@@ -67,11 +286,30 @@ void Router::sendFile(const std::shared_ptr<tcp::Connection>& conn,
 	}
 }
 
-void Router::Trie::insert(const std::string& path, http_handler handler)
+void Router::streamFile(const std::shared_ptr<tcp::Connection>& conn,
+						Response* res, int fd, const std::string& type)
+{
+	res->setStatusCode(200);
+	res->setContentType(type);
+	res->setHeader("Transfer-Encoding", "chunked");
+	res->setHeader("Content-Encoding", encodingName(res->encoding()));
+	res->setHeader("Vary", "Accept-Encoding");
+	// 连接的关闭由 FileStreamer 在发送完成后处理
+	res->setDeferred();
+	conn->send(res->toFormattedString());
+
+	auto streamer = std::make_shared<FileStreamer>(
+		conn, fd, res->encoding(), res->compressLevel(), res->keepAlive());
+	streamer->pump();
+}
+
+void Router::Trie::insert(const std::string& method, const std::string& path,
+						  http_handler handler)
 {
 	if (path == "/")
 	{
 		root->f = std::move(handler);
+		root->metrics.init(method, path);
 		return;
 	}
 
@@ -80,59 +318,77 @@ void Router::Trie::insert(const std::string& path, http_handler handler)
 
 	while (start != std::string::npos)
 	{
-		std::string s = subPath(path, &start);
+		std::string_view s = subPath(path, &start);
 		if (s.empty() && start == std::string::npos)
 		{
 			break; // error
 		}
 
-		if (cur->next_node.find(s) == cur->next_node.end())
+		auto it = cur->next_node.find(s);
+		if (it == cur->next_node.end())
 		{
-			cur->next_node[s] = std::make_unique<TrieNode>();
+			it = cur->next_node
+					 .emplace(std::string(s), std::make_unique<TrieNode>())
+					 .first;
 		}
 
-		cur = cur->next_node[s].get();
+		cur = it->second.get();
 	}
 
 	cur->f = std::move(handler);
+	cur->metrics.init(method, path);
 }
 
-Router::http_handler Router::Trie::search(const std::string& path)
+const Router::TrieNode* Router::Trie::search(std::string_view path) const
 {
 	if (path == "/")
 	{
-		return root->f;
+		return root.get();
 	}
 
-	size_t start = (path[0] == '/') ? 1 : 0;
-	TrieNode* cur = root.get();
+	size_t start = (!path.empty() && path[0] == '/') ? 1 : 0;
+	const TrieNode* cur = root.get();
+	// 最长前缀匹配到的通配节点
+	const TrieNode* wildcard = nullptr;
 
 	while (start != std::string::npos)
 	{
-		std::string s = subPath(path, &start);
+		auto star = cur->next_node.find(std::string_view(kWildcard));
+		if (star != cur->next_node.end() && star->second->f)
+		{
+			wildcard = star->second.get();
+		}
+
+		std::string_view s = subPath(path, &start);
 		if (s.empty() && start == std::string::npos)
 		{
 			break; // error
 		}
 
-		if (cur->next_node.find(s) == cur->next_node.end())
+		auto it = cur->next_node.find(s);
+		if (it == cur->next_node.end())
 		{
-			return nullptr; // router not exist
+			// router not exist
+			return wildcard;
 		}
 
-		cur = cur->next_node[s].get();
+		cur = it->second.get();
 	}
 
-	return cur->f;
+	if (!cur->f && wildcard)
+	{
+		return wildcard;
+	}
+	return cur;
 }
 
-std::string Router::Trie::subPath(const std::string& path, size_t* start)
+std::string_view Router::Trie::subPath(std::string_view path, size_t* start)
 {
 	// because *start maybe arive 1
 	if (*start == std::string::npos || *start >= path.size())
 	{
 		*start = std::string::npos;
-		return "";
+		return {};
 	}
 
 	size_t begin = *start;
@@ -146,4 +402,4 @@ std::string Router::Trie::subPath(const std::string& path, size_t* start)
 
 	*start = std::string::npos;
 	return path.substr(begin);
-}
\ No newline at end of file
+}
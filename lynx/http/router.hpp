@@ -2,11 +2,13 @@
 #define LYNX_HTTP_ROUTER_HPP
 
 #include "lynx/base/noncopyable.hpp"
+#include "lynx/metrics/registry.hpp"
 #include <cassert>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 namespace lynx
 {
 namespace tcp
@@ -25,15 +27,34 @@ class Router : public base::noncopyable
 		const Request&, Response*, const std::shared_ptr<tcp::Connection>&)>;
 
   private:
+	// 每条路由的请求数（按状态码百位分组）与处理函数耗时，路由注册时创建
+	struct RouteMetrics
+	{
+		metrics::Counter requests[6]; // [0] 为其他
+		metrics::Histogram duration;
+
+		void init(const std::string& method, const std::string& route);
+		void record(int status_code, double seconds) const
+		{
+			int code = status_code / 100;
+			requests[code >= 1 && code <= 5 ? code : 0].inc();
+			duration.observe(seconds);
+		}
+	};
+
 	struct TrieNode
 	{
 		http_handler f;
-		std::map<std::string, std::unique_ptr<TrieNode>> next_node;
+		RouteMetrics metrics;
+		// std::less<> 支持以 string_view 查找，匹配时不分配内存
+		std::map<std::string, std::unique_ptr<TrieNode>, std::less<>>
+			next_node;
 	};
 
 	struct Trie
 	{
 		std::unique_ptr<TrieNode> root;
+		RouteMetrics unmatched;
 		Trie()
 		{
 			root = std::make_unique<TrieNode>();
@@ -45,33 +66,52 @@ class Router : public base::noncopyable
 
 		Trie(Trie&&) = default;
 
-		void insert(const std::string& path, http_handler handler);
-		http_handler search(const std::string& path);
+		void insert(const std::string& method, const std::string& path,
+					http_handler handler);
+		// 返回匹配的节点，避免每次请求拷贝 std::function
+		const TrieNode* search(std::string_view path) const;
 
 	  private:
-		std::string subPath(const std::string& path, size_t* start);
+		static std::string_view subPath(std::string_view path, size_t* start);
 	};
 
-	std::map<std::string, Trie> tries_;
+	std::map<std::string, Trie, std::less<>> tries_;
+	RouteMetrics unknown_method_;
+
+	bool compression_;
+	size_t compress_min_size_;
+	int compress_level_;
 
   public:
 	Router();
 	~Router();
 
+	// path 末段为 "*" 时匹配该前缀下的所有路径，如 "/api/*"
 	void addRoute(const std::string& method, const std::string& path,
 				  const http_handler& handler)
 	{
-		assert(tries_.size() == 2);
-		tries_[method].insert(path, handler);
+		assert(tries_.count(method));
+		tries_[method].insert(method, path, handler);
+	}
+
+	// 在 path 上以 Prometheus 文本格式导出 metrics::Registry 中的全部指标
+	void enableMetrics(const std::string& path = "/metrics");
+
+	// 按 Accept-Encoding 压缩不小于 min_size 的文本类响应
+	void enableCompression(size_t min_size = 1024, int level = 6)
+	{
+		compression_ = true;
+		compress_min_size_ = min_size;
+		compress_level_ = level;
 	}
 
 	void dispatch(const Request& req, Response* res,
 				  const std::shared_ptr<tcp::Connection>& conn);
 
+	// 协商了压缩的大文本文件以 chunked 边读边压缩发送，否则走 sendfile
 	static void sendFile(const std::shared_ptr<tcp::Connection>& conn,
 						 Response* res, const std::string& file_path);
 
-  private:
 	static std::string getMineType(const std::string& path)
 	{
 		if (path.ends_with(".html"))
@@ -94,9 +134,27 @@ class Router : public base::noncopyable
 		{
 			return "image/jpeg";
 		}
+		else if (path.ends_with(".json"))
+		{
+			return "application/json";
+		}
+		else if (path.ends_with(".svg"))
+		{
+			return "image/svg+xml";
+		}
+		else if (path.ends_with(".txt"))
+		{
+			return "text/plain; charset=utf-8";
+		}
 
 		return "application/octet-stream";
 	}
+
+  private:
+	static constexpr const char* kWildcard = "*";
+
+	static void streamFile(const std::shared_ptr<tcp::Connection>& conn,
+						   Response* res, int fd, const std::string& type);
 };
 } // namespace http
 } // namespace lynx
@@ -1,14 +1,19 @@
 #include "lynx/http/session.hpp"
 #include "lynx/http/parser.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/logger/logger.hpp"
 #include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include <algorithm>
 #include <memory>
 
 using namespace lynx;
 using namespace lynx::http;
 
-Session::Session()
+Session::Session(const Limits& limits) : started_(0)
 {
-	parser_ = std::make_unique<Parser>();
+	parser_ = std::make_unique<Parser>(limits);
 }
 
 Session::~Session()
@@ -20,22 +25,75 @@ bool Session::completed() const
 	return parser_->completed();
 }
 
+bool Session::idle() const
+{
+	return parser_->state() == Parser::State::kStart;
+}
+
 const Request& Session::req() const
 {
 	return parser_->req();
 }
 
+void Session::setConnection(const std::shared_ptr<tcp::Connection>& conn)
+{
+	conn_ = conn;
+}
+
+int Session::errorStatus() const
+{
+	return parser_->errorStatus();
+}
+
+void Session::reject(const std::shared_ptr<tcp::Connection>& conn, int status)
+{
+	Response res;
+	res.setStatusCode(status);
+	res.setKeepAlive(false);
+	res.setHeader("Content-Length", "0");
+	conn->send(res.toFormattedString());
+	// 超时的客户端多半不会再读，直接释放 socket
+	if (status == 408)
+	{
+		conn->forceClose();
+	}
+	else
+	{
+		conn->shutdown();
+	}
+}
+
 void Session::clear()
 {
 	parser_->clear();
+	trace_.reset();
+	cancelDeadlines();
 }
 
 bool Session::parser(tcp::Buffer* buf)
+{
+	if (parser_->state() == Parser::State::kStart && buf->readableBytes() > 0)
+	{
+		trace_.begin();
+		started_ = Trace::now();
+	}
+
+	bool ok = parse(buf);
+	if (!conn_.expired())
+	{
+		updateDeadlines();
+	}
+	return ok;
+}
+
+bool Session::parse(tcp::Buffer* buf)
 {
 	while (buf->readableBytes() > 0)
 	{
 		if (parser_->state() == Parser::State::kBody)
 		{
+			markHeaders();
+
 			size_t n = std::min(buf->readableBytes(), parser_->bodyRemaining());
 			parser_->appendBody(buf->peek(), n);
 
@@ -59,8 +117,117 @@ bool Session::parser(tcp::Buffer* buf)
 
 		if (parser_->completed())
 		{
+			markHeaders();
 			return true;
 		}
 	}
+
+	if (parser_->state() == Parser::State::kBody)
+	{
+		markHeaders();
+	}
 	return true;
-}
\ No newline at end of file
+}
+
+void Session::markHeaders()
+{
+	if (trace_.sampled() && !trace_.marked(Trace::kHeaders))
+	{
+		trace_.mark(Trace::kHeaders);
+	}
+}
+
+// 一次读到完整请求头（绝大多数请求）时不访问定时器队列，
+// 只有解析停在半路时才按阶段挂一个定时器
+void Session::updateDeadlines()
+{
+	const Limits& limits = parser_->limits();
+	switch (parser_->state())
+	{
+	case Parser::State::kStart:
+	case Parser::State::kComplete:
+	case Parser::State::kError:
+		cancelDeadlines();
+		break;
+
+	case Parser::State::kBody:
+		if (header_timer_.isAlive() || !body_timer_.isAlive())
+		{
+			cancelDeadlines();
+			if (limits.body_timeout > 0)
+			{
+				body_timer_ = armDeadline(limits.body_timeout);
+			}
+		}
+		break;
+
+	default:
+		if (!header_timer_.isAlive() && limits.header_timeout > 0)
+		{
+			double elapsed = static_cast<double>(Trace::now() - started_) / 1e9;
+			header_timer_ =
+				armDeadline(std::max(limits.header_timeout - elapsed, 0.0));
+		}
+		break;
+	}
+}
+
+void Session::cancelDeadlines()
+{
+	if (!header_timer_.isAlive() && !body_timer_.isAlive())
+	{
+		return;
+	}
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	if (!conn)
+	{
+		return;
+	}
+	if (header_timer_.isAlive())
+	{
+		conn->loop()->cancell(header_timer_);
+	}
+	if (body_timer_.isAlive())
+	{
+		conn->loop()->cancell(body_timer_);
+	}
+	header_timer_ = time::TimerId();
+	body_timer_ = time::TimerId();
+}
+
+time::TimerId Session::armDeadline(double delay)
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	return conn->loop()->runAfter(delay,
+								  [self = weak_from_this()]()
+								  {
+									  std::shared_ptr<Session> session =
+										  self.lock();
+									  if (session)
+									  {
+										  session->handleDeadline();
+									  }
+								  });
+}
+
+void Session::handleDeadline()
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	if (!conn)
+	{
+		return;
+	}
+
+	Parser::State state = parser_->state();
+	if (state == Parser::State::kStart || state == Parser::State::kComplete ||
+		state == Parser::State::kError)
+	{
+		return;
+	}
+
+	LOG_WARN << "request from " << conn->addr().toFormattedString()
+			 << (state == Parser::State::kBody ? " body" : " header")
+			 << " timed out";
+	parser_->setState(Parser::State::kError);
+	reject(conn, 408);
+}
@@ -2,6 +2,10 @@
 #define LYNX_HTTP_SESSION_HPP
 
 #include "lynx/base/noncopyable.hpp"
+#include "lynx/http/parser.hpp"
+#include "lynx/http/trace.hpp"
+#include "lynx/time/timer_id.hpp"
+#include <cstdint>
 #include <memory>
 namespace lynx
 {
@@ -9,24 +13,59 @@ namespace lynx
 namespace tcp
 {
 class Buffer;
-}
+class Connection;
+} // namespace tcp
 namespace http
 {
 class Request;
-class Parser;
-class Session : public base::noncopyable
+class Session : public base::noncopyable,
+				public std::enable_shared_from_this<Session>
 {
   private:
 	std::unique_ptr<Parser> parser_;
+	Trace trace_;
+
+	// 绑定连接后启用读取超时，只在连接所在 loop 中访问
+	std::weak_ptr<tcp::Connection> conn_;
+	int64_t started_; // 请求第一个字节的时间（ns）
+	time::TimerId header_timer_;
+	time::TimerId body_timer_;
 
   public:
-	Session();
+	explicit Session(const Limits& limits = Limits());
 	~Session();
 
+	// 请求头、body 未在 Limits 规定的时间内收齐时回复 408 并关闭连接。
+	// Session 须由 shared_ptr 持有
+	void setConnection(const std::shared_ptr<tcp::Connection>& conn);
+
+	// parser 返回 false 后应回复的状态码
+	int errorStatus() const;
+
+	// 回复不带 body 的错误响应并关闭连接
+	static void reject(const std::shared_ptr<tcp::Connection>& conn,
+					   int status);
+
 	bool completed() const;
+	// 没有解析到一半的请求
+	bool idle() const;
 	const Request& req() const;
 	void clear();
 	bool parser(tcp::Buffer* buf);
+
+	Trace& trace()
+	{
+		return trace_;
+	}
+
+  private:
+	bool parse(tcp::Buffer* buf);
+	void markHeaders();
+
+	void updateDeadlines();
+	void cancelDeadlines();
+	time::TimerId armDeadline(double delay);
+	void handleDeadline();
 };
 } // namespace http
 } // namespace lynx
@@ -0,0 +1,123 @@
+#include "lynx/http/trace.hpp"
+#include "lynx/logger/logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+
+using namespace lynx;
+using namespace lynx::http;
+
+std::atomic<uint32_t> Trace::threshold_{0};
+
+namespace
+{
+// 每个线程独立的 xorshift，抽样不需要同步
+uint32_t nextRandom()
+{
+	thread_local uint64_t state =
+		0x9e3779b97f4a7c15ull ^ static_cast<uint64_t>(Trace::now());
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return static_cast<uint32_t>(state >> 32);
+}
+
+std::string formatNs(int64_t ns)
+{
+	if (ns < 1000000)
+	{
+		return std::format("{}us", ns / 1000);
+	}
+	return std::format("{:.2f}ms", ns / 1e6);
+}
+} // namespace
+
+Trace::Trace() : sampled_(false), seq_(0), conn_id_(0), status_(0)
+{
+	std::fill(ts_, ts_ + kStages, 0);
+}
+
+void Trace::setSampleRate(double rate)
+{
+	rate = std::isnan(rate) ? 0.0 : std::clamp(rate, 0.0, 1.0);
+	// 阈值取最大值时 begin 中视为全部抽中
+	uint32_t threshold =
+		rate >= 1.0 ? std::numeric_limits<uint32_t>::max()
+					: static_cast<uint32_t>(
+						  rate * std::numeric_limits<uint32_t>::max());
+	threshold_.store(threshold, std::memory_order_relaxed);
+}
+
+double Trace::sampleRate()
+{
+	return static_cast<double>(threshold_.load(std::memory_order_relaxed)) /
+		   std::numeric_limits<uint32_t>::max();
+}
+
+void Trace::begin()
+{
+	++seq_;
+	uint32_t threshold = threshold_.load(std::memory_order_relaxed);
+	sampled_ = threshold != 0 &&
+			   (threshold == std::numeric_limits<uint32_t>::max() ||
+				nextRandom() < threshold);
+	if (sampled_)
+	{
+		ts_[kFirstByte] = now();
+	}
+}
+
+void Trace::reset()
+{
+	if (sampled_)
+	{
+		std::fill(ts_, ts_ + kStages, 0);
+		method_.clear();
+		path_.clear();
+		status_ = 0;
+		sampled_ = false;
+	}
+}
+
+void Trace::setRequest(uint64_t conn_id, const std::string& method,
+					   const std::string& path, int status)
+{
+	conn_id_ = conn_id;
+	method_ = method;
+	path_ = path;
+	status_ = status;
+}
+
+std::string Trace::format() const
+{
+	std::string out = std::format("trace conn={}#{} {} {} {}", conn_id_, seq_,
+								  method_, path_, status_);
+
+	// 以到达该阶段的间隔命名
+	static const char* const names[kStages] = {
+		"", "accept", "parse", "body", "handler", "flush"};
+	int64_t prev = 0;
+	for (int stage = kAccept; stage < kStages; ++stage)
+	{
+		if (ts_[stage] == 0)
+		{
+			continue;
+		}
+		if (prev != 0)
+		{
+			out += std::format(" {}={}", names[stage],
+							   formatNs(ts_[stage] - prev));
+		}
+		prev = ts_[stage];
+	}
+
+	int64_t last = *std::max_element(ts_ + kFirstByte, ts_ + kStages);
+	out += std::format(" total={}", formatNs(last - ts_[kFirstByte]));
+	return out;
+}
+
+void Trace::emit() const
+{
+	LOG_INFO << format();
+}
@@ -0,0 +1,102 @@
+#ifndef LYNX_HTTP_TRACE_HPP
+#define LYNX_HTTP_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+namespace lynx
+{
+namespace http
+{
+// 请求各阶段的单调时钟时间戳（ns），抽中的请求在响应写完后
+// 通过异步日志输出一行；未抽中时每个阶段只多一次分支
+class Trace
+{
+  public:
+	enum Stage
+	{
+		kAccept,	  // 连接建立，只记录在连接的第一个请求上
+		kFirstByte,	  // 开始解析请求
+		kHeaders,	  // 请求头解析完成
+		kDispatch,	  // 请求体读完，进入路由
+		kHandlerDone, // 处理函数返回（SQL 等同步调用计入处理函数）
+		kFlushed,	  // 响应最后一个字节写入 socket
+		kStages
+	};
+
+  private:
+	static std::atomic<uint32_t> threshold_; // 随机数小于它则抽中
+
+	int64_t ts_[kStages];
+	bool sampled_;
+	uint64_t seq_; // 连接上的第几个请求
+
+	uint64_t conn_id_;
+	std::string method_;
+	std::string path_;
+	int status_;
+
+  public:
+	Trace();
+
+	// rate 取 [0, 1]，线程安全，运行中随时可调
+	static void setSampleRate(double rate);
+	static double sampleRate();
+
+	static int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   std::chrono::steady_clock::now().time_since_epoch())
+			.count();
+	}
+
+	// 新请求开始时调用：决定是否抽样并记录 kFirstByte
+	void begin();
+	void reset();
+
+	bool sampled() const
+	{
+		return sampled_;
+	}
+
+	bool firstRequest() const
+	{
+		return seq_ == 1;
+	}
+
+	void mark(Stage stage)
+	{
+		if (sampled_)
+		{
+			ts_[stage] = now();
+		}
+	}
+
+	void mark(Stage stage, int64_t ns)
+	{
+		if (sampled_)
+		{
+			ts_[stage] = ns;
+		}
+	}
+
+	bool marked(Stage stage) const
+	{
+		return ts_[stage] != 0;
+	}
+
+	// 处理函数返回后记录请求信息，Request 随后会被清空
+	void setRequest(uint64_t conn_id, const std::string& method,
+					const std::string& path, int status);
+
+	// 形如 trace conn=3#2 GET /api 200 parse=12us body=1us handler=300us
+	// flush=20us total=333us，各项为相邻阶段的间隔
+	std::string format() const;
+	void emit() const;
+};
+} // namespace http
+} // namespace lynx
+
+#endif
@@ -0,0 +1,653 @@
+#include "lynx/http/websocket.hpp"
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace lynx;
+using namespace lynx::http;
+
+namespace
+{
+const char kGUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+// 握手只需对 60 字节左右的输入做一次 SHA-1，不值得引入 OpenSSL
+void sha1(const std::string& input, uint8_t digest[20])
+{
+	uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+					 0xC3D2E1F0};
+
+	std::string msg = input;
+	uint64_t bit_len = static_cast<uint64_t>(input.size()) * 8;
+	msg.push_back(static_cast<char>(0x80));
+	while (msg.size() % 64 != 56)
+	{
+		msg.push_back(0);
+	}
+	for (int i = 7; i >= 0; --i)
+	{
+		msg.push_back(static_cast<char>(bit_len >> (i * 8)));
+	}
+
+	auto rol = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+
+	for (size_t chunk = 0; chunk < msg.size(); chunk += 64)
+	{
+		uint32_t w[80];
+		for (int i = 0; i < 16; ++i)
+		{
+			const auto* p =
+				reinterpret_cast<const uint8_t*>(msg.data() + chunk + i * 4);
+			w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+				   (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+		}
+		for (int i = 16; i < 80; ++i)
+		{
+			w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+		}
+
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+		for (int i = 0; i < 80; ++i)
+		{
+			uint32_t f, k;
+			if (i < 20)
+			{
+				f = (b & c) | (~b & d);
+				k = 0x5A827999;
+			}
+			else if (i < 40)
+			{
+				f = b ^ c ^ d;
+				k = 0x6ED9EBA1;
+			}
+			else if (i < 60)
+			{
+				f = (b & c) | (b & d) | (c & d);
+				k = 0x8F1BBCDC;
+			}
+			else
+			{
+				f = b ^ c ^ d;
+				k = 0xCA62C1D6;
+			}
+
+			uint32_t tmp = rol(a, 5) + f + e + k + w[i];
+			e = d;
+			d = c;
+			c = rol(b, 30);
+			b = a;
+			a = tmp;
+		}
+
+		h[0] += a;
+		h[1] += b;
+		h[2] += c;
+		h[3] += d;
+		h[4] += e;
+	}
+
+	for (int i = 0; i < 5; ++i)
+	{
+		digest[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+		digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+		digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+		digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+	}
+}
+
+std::string base64(const uint8_t* data, size_t len)
+{
+	static const char table[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	std::string out;
+	out.reserve((len + 2) / 3 * 4);
+	for (size_t i = 0; i < len; i += 3)
+	{
+		uint32_t v = uint32_t(data[i]) << 16;
+		if (i + 1 < len)
+		{
+			v |= uint32_t(data[i + 1]) << 8;
+		}
+		if (i + 2 < len)
+		{
+			v |= data[i + 2];
+		}
+
+		out.push_back(table[(v >> 18) & 0x3F]);
+		out.push_back(table[(v >> 12) & 0x3F]);
+		out.push_back(i + 1 < len ? table[(v >> 6) & 0x3F] : '=');
+		out.push_back(i + 2 < len ? table[v & 0x3F] : '=');
+	}
+	return out;
+}
+
+std::string acceptKey(const std::string& key)
+{
+	uint8_t digest[20];
+	sha1(key + kGUID, digest);
+	return base64(digest, sizeof(digest));
+}
+
+// 逗号分隔的头部值中是否含有 token（大小写不敏感）
+bool hasToken(std::string value, std::string_view token)
+{
+	std::transform(value.begin(), value.end(), value.begin(),
+				   [](unsigned char c) { return std::tolower(c); });
+	return value.find(token) != std::string::npos;
+}
+
+bool isControl(WebSocket::Opcode opcode)
+{
+	return static_cast<uint8_t>(opcode) & 0x8;
+}
+
+bool isKnown(WebSocket::Opcode opcode)
+{
+	switch (opcode)
+	{
+	case WebSocket::Opcode::kContinuation:
+	case WebSocket::Opcode::kText:
+	case WebSocket::Opcode::kBinary:
+	case WebSocket::Opcode::kClose:
+	case WebSocket::Opcode::kPing:
+	case WebSocket::Opcode::kPong:
+		return true;
+	default:
+		return false;
+	}
+}
+} // namespace
+
+WebSocket::WebSocket(WebSocketHub* hub,
+					 const std::shared_ptr<tcp::Connection>& conn)
+	: hub_(hub), group_(nullptr), conn_(conn), loop_(conn->loop()),
+	  message_opcode_(Opcode::kText), fragmented_(false), close_sent_(false),
+	  close_received_(false), last_active_(time::TimeStamp::now())
+{
+}
+
+WebSocket::~WebSocket()
+{
+}
+
+void WebSocket::unmask(char* dst, const char* src, size_t len,
+					   const uint8_t key[4])
+{
+	uint32_t key32;
+	std::memcpy(&key32, key, 4);
+	size_t i = 0;
+
+	// 每次处理的字节数都是 4 的倍数，key 的相位保持不变
+#if defined(__AVX2__)
+	__m256i key256 = _mm256_set1_epi32(static_cast<int>(key32));
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i v =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+							_mm256_xor_si256(v, key256));
+	}
+#endif
+#if defined(__SSE2__)
+	__m128i key128 = _mm_set1_epi32(static_cast<int>(key32));
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+						 _mm_xor_si128(v, key128));
+	}
+#endif
+
+	uint64_t key64 = (static_cast<uint64_t>(key32) << 32) | key32;
+	for (; i + 8 <= len; i += 8)
+	{
+		uint64_t v;
+		std::memcpy(&v, src + i, 8);
+		v ^= key64;
+		std::memcpy(dst + i, &v, 8);
+	}
+
+	for (; i < len; ++i)
+	{
+		dst[i] = static_cast<char>(src[i] ^ key[i & 3]);
+	}
+}
+
+std::string WebSocket::encodeFrame(std::string_view payload, Opcode opcode,
+								   bool fin)
+{
+	size_t len = payload.size();
+	std::string frame;
+	frame.reserve(len + 10);
+
+	frame.push_back(
+		static_cast<char>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode)));
+	if (len < 126)
+	{
+		frame.push_back(static_cast<char>(len));
+	}
+	else if (len <= 0xFFFF)
+	{
+		frame.push_back(static_cast<char>(126));
+		frame.push_back(static_cast<char>(len >> 8));
+		frame.push_back(static_cast<char>(len));
+	}
+	else
+	{
+		frame.push_back(static_cast<char>(127));
+		for (int i = 7; i >= 0; --i)
+		{
+			frame.push_back(static_cast<char>(static_cast<uint64_t>(len) >>
+											  (i * 8)));
+		}
+	}
+
+	frame.append(payload);
+	return frame;
+}
+
+std::string WebSocket::encodeClose(uint16_t code, std::string_view reason)
+{
+	std::string payload;
+	payload.push_back(static_cast<char>(code >> 8));
+	payload.push_back(static_cast<char>(code));
+	// 控制帧 payload 不超过 125 字节
+	payload.append(reason.substr(0, 123));
+	return encodeFrame(payload, Opcode::kClose);
+}
+
+void WebSocket::send(std::string_view payload, Opcode opcode)
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	if (conn)
+	{
+		conn->send(encodeFrame(payload, opcode));
+	}
+}
+
+void WebSocket::sendFrame(const std::string& frame)
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	if (!conn || !conn->connected())
+	{
+		return;
+	}
+
+	if (conn->outputBytes() > hub_->max_pending_bytes_)
+	{
+		LOG_WARN << "WebSocket: slow consumer "
+				 << conn->addr().toFormattedString() << ", disconnecting";
+		conn->forceClose();
+		return;
+	}
+
+	conn->send(frame.data(), frame.size());
+}
+
+void WebSocket::close(uint16_t code, std::string_view reason)
+{
+	std::string frame = encodeClose(code, reason);
+	loop_->runInLoop(
+		[self = shared_from_this(), frame]()
+		{
+			if (!self->close_sent_)
+			{
+				self->close_sent_ = true;
+				self->sendFrame(frame);
+			}
+		});
+}
+
+void WebSocket::drain()
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	if (!conn)
+	{
+		return;
+	}
+	if (!close_sent_)
+	{
+		close_sent_ = true;
+		sendFrame(encodeClose(1001, "Going Away"));
+	}
+	conn->setBusy(false);
+}
+
+void WebSocket::handleMessage(const std::shared_ptr<tcp::Connection>&,
+							  tcp::Buffer* buf)
+{
+	last_active_ = time::TimeStamp::now();
+
+	while (buf->readableBytes() >= 2)
+	{
+		if (close_received_)
+		{
+			buf->retrieve(buf->readableBytes());
+			return;
+		}
+
+		const auto* p = reinterpret_cast<const uint8_t*>(buf->peek());
+		size_t avail = buf->readableBytes();
+
+		bool fin = p[0] & 0x80;
+		uint8_t rsv = p[0] & 0x70;
+		auto opcode = static_cast<Opcode>(p[0] & 0x0F);
+		bool masked = p[1] & 0x80;
+		uint64_t len = p[1] & 0x7F;
+		size_t header = 2;
+
+		if (len == 126)
+		{
+			if (avail < 4)
+			{
+				return;
+			}
+			len = (uint64_t(p[2]) << 8) | p[3];
+			header = 4;
+		}
+		else if (len == 127)
+		{
+			if (avail < 10)
+			{
+				return;
+			}
+			len = 0;
+			for (int i = 2; i < 10; ++i)
+			{
+				len = (len << 8) | p[i];
+			}
+			header = 10;
+		}
+
+		// 客户端发来的帧必须加掩码；未协商扩展，RSV 必须为 0
+		if (rsv || !masked || !isKnown(opcode) ||
+			(isControl(opcode) && (!fin || len > 125)))
+		{
+			fail(1002);
+			return;
+		}
+
+		if (len > hub_->max_message_size_ ||
+			(!isControl(opcode) &&
+			 message_.size() + len > hub_->max_message_size_))
+		{
+			fail(1009);
+			return;
+		}
+
+		header += 4;
+		if (avail < header + len)
+		{
+			return; // 等待完整的帧
+		}
+
+		const uint8_t* key = p + header - 4;
+		const char* payload = buf->peek() + header;
+
+		if (isControl(opcode))
+		{
+			std::string data(len, '\0');
+			unmask(data.data(), payload, len, key);
+			buf->retrieve(header + len);
+			handleControl(opcode, data.data(), data.size());
+			continue;
+		}
+
+		if (opcode == Opcode::kContinuation)
+		{
+			if (!fragmented_)
+			{
+				fail(1002);
+				return;
+			}
+
+			size_t old = message_.size();
+			message_.resize(old + len);
+			unmask(message_.data() + old, payload, len, key);
+			buf->retrieve(header + len);
+
+			if (fin)
+			{
+				fragmented_ = false;
+				std::string message = std::move(message_);
+				message_.clear();
+				deliver(message_opcode_, message);
+			}
+			continue;
+		}
+
+		if (fragmented_)
+		{
+			fail(1002); // 上一条分片消息尚未结束
+			return;
+		}
+
+		if (fin)
+		{
+			std::string message(len, '\0');
+			unmask(message.data(), payload, len, key);
+			buf->retrieve(header + len);
+			deliver(opcode, message);
+		}
+		else
+		{
+			fragmented_ = true;
+			message_opcode_ = opcode;
+			message_.resize(len);
+			unmask(message_.data(), payload, len, key);
+			buf->retrieve(header + len);
+		}
+	}
+}
+
+void WebSocket::handleControl(Opcode opcode, const char* payload, size_t len)
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	if (!conn)
+	{
+		return;
+	}
+
+	switch (opcode)
+	{
+	case Opcode::kPing:
+		sendFrame(encodeFrame(std::string_view(payload, len), Opcode::kPong));
+		break;
+	case Opcode::kPong:
+		break;
+	case Opcode::kClose:
+	{
+		close_received_ = true;
+		if (!close_sent_)
+		{
+			// 回应对端的关闭码，1005 表示对端未携带关闭码
+			uint16_t code = 1000;
+			if (len >= 2)
+			{
+				code = static_cast<uint16_t>(
+					(static_cast<uint8_t>(payload[0]) << 8) |
+					static_cast<uint8_t>(payload[1]));
+			}
+			close_sent_ = true;
+			sendFrame(encodeClose(code, ""));
+		}
+		conn->shutdown();
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void WebSocket::deliver(Opcode opcode, const std::string& message)
+{
+	if (hub_->message_callback_)
+	{
+		hub_->message_callback_(shared_from_this(), message, opcode);
+	}
+}
+
+void WebSocket::fail(uint16_t code)
+{
+	std::shared_ptr<tcp::Connection> conn = conn_.lock();
+	LOG_WARN << "WebSocket: protocol error " << code << " from "
+			 << (conn ? conn->addr().toFormattedString() : "");
+
+	close_received_ = true;
+	if (!close_sent_)
+	{
+		close_sent_ = true;
+		sendFrame(encodeClose(code, ""));
+	}
+	if (conn)
+	{
+		conn->shutdown();
+	}
+}
+
+void WebSocket::handleClose()
+{
+	std::shared_ptr<WebSocket> self = shared_from_this();
+	hub_->leave(this);
+	if (hub_->close_callback_)
+	{
+		hub_->close_callback_(self);
+	}
+}
+
+WebSocketHub::WebSocketHub()
+	: ping_interval_(30.0), max_message_size_(1024 * 1024),
+	  max_pending_bytes_(4 * 1024 * 1024)
+{
+}
+
+WebSocketHub::~WebSocketHub()
+{
+}
+
+std::shared_ptr<WebSocket> WebSocketHub::upgrade(
+	const Request& req, Response* res,
+	const std::shared_ptr<tcp::Connection>& conn)
+{
+	std::string key = req.header("sec-websocket-key");
+	if (req.method != "GET" || key.empty() ||
+		!hasToken(req.header("upgrade"), "websocket") ||
+		!hasToken(req.header("connection"), "upgrade"))
+	{
+		res->setStatusCode(400);
+		res->setContentType("text/html");
+		res->setBody("<h1>400 Bad Request</h1>");
+		conn->send(res->toFormattedString());
+		return nullptr;
+	}
+
+	if (req.header("sec-websocket-version") != "13")
+	{
+		res->setStatusCode(426);
+		res->setHeader("Sec-WebSocket-Version", "13");
+		res->setBody("");
+		conn->send(res->toFormattedString());
+		return nullptr;
+	}
+
+	// 之后连接上的数据都按帧解析，不再交给 http::Session
+	res->setDeferred();
+	res->setStatusCode(101);
+	res->setHeader("Upgrade", "websocket");
+	res->setHeader("Connection", "Upgrade");
+	res->setHeader("Sec-WebSocket-Accept", acceptKey(key));
+	conn->send(res->toFormattedString());
+
+	auto ws = std::make_shared<WebSocket>(this, conn);
+	conn->setMessageCallback(std::bind(&WebSocket::handleMessage, ws,
+									   std::placeholders::_1,
+									   std::placeholders::_2));
+
+	std::weak_ptr<WebSocket> weak = ws;
+	conn->setConnectCallback(
+		[prev = conn->connectCallback(),
+		 weak](const std::shared_ptr<tcp::Connection>& c)
+		{
+			if (prev)
+			{
+				prev(c);
+			}
+
+			auto ws = weak.lock();
+			if (ws && c->disconnected())
+			{
+				ws->handleClose();
+			}
+		});
+
+	if (auto* ctx = conn->findContext<tcp::Context>())
+	{
+		ctx->ws_ = ws;
+	}
+
+	join(ws);
+	if (open_callback_)
+	{
+		open_callback_(ws);
+	}
+	return ws;
+}
+
+void WebSocketHub::broadcast(std::string_view payload, Opcode opcode)
+{
+	auto frame = std::make_shared<const std::string>(
+		WebSocket::encodeFrame(payload, opcode));
+	sockets_.forEach([frame](WebSocket* ws) { ws->sendFrame(*frame); });
+}
+
+void WebSocketHub::join(const std::shared_ptr<WebSocket>& ws)
+{
+	ws->group_ = sockets_.join(ws, ping_interval_,
+							   [this](WebSocket::Group* group)
+							   { sweep(group); });
+}
+
+void WebSocketHub::leave(WebSocket* ws)
+{
+	sockets_.leave(ws, ws->group_);
+	ws->group_ = nullptr;
+}
+
+void WebSocketHub::sweep(WebSocket::Group* group)
+{
+	static const std::string ping =
+		WebSocket::encodeFrame("", WebSocket::Opcode::kPing);
+
+	time::TimeStamp now = time::TimeStamp::now();
+	time::TimeStamp idle = time::TimeStamp::addTime(now, -ping_interval_);
+	time::TimeStamp dead = time::TimeStamp::addTime(now, -2 * ping_interval_);
+
+	for (auto& item : group->members)
+	{
+		WebSocket* ws = item.second.get();
+		if (ws->last_active_ < dead)
+		{
+			if (auto conn = ws->connection())
+			{
+				conn->forceClose();
+			}
+		}
+		else if (ws->last_active_ < idle)
+		{
+			ws->sendFrame(ping);
+		}
+	}
+}
@@ -0,0 +1,208 @@
+#ifndef LYNX_HTTP_WEBSOCKET_HPP
+#define LYNX_HTTP_WEBSOCKET_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/http/fan_out.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+namespace lynx
+{
+namespace tcp
+{
+class Connection;
+class EventLoop;
+class Buffer;
+} // namespace tcp
+
+namespace http
+{
+class Request;
+class Response;
+class WebSocketHub;
+// RFC 6455 服务端连接，由 WebSocketHub::upgrade 创建，
+// 帧的解析与回调都在所属 loop 线程中进行
+class WebSocket : public base::noncopyable,
+				  public std::enable_shared_from_this<WebSocket>
+{
+	friend class WebSocketHub;
+
+  public:
+	enum class Opcode : uint8_t
+	{
+		kContinuation = 0x0,
+		kText = 0x1,
+		kBinary = 0x2,
+		kClose = 0x8,
+		kPing = 0x9,
+		kPong = 0xA
+	};
+
+  private:
+	using Group = FanOut<WebSocket>::Group;
+
+	WebSocketHub* hub_;
+	Group* group_;
+	std::weak_ptr<tcp::Connection> conn_;
+	tcp::EventLoop* loop_;
+
+	// 分片消息重组
+	std::string message_;
+	Opcode message_opcode_;
+	bool fragmented_;
+
+	bool close_sent_;
+	bool close_received_;
+	time::TimeStamp last_active_;
+
+	std::any ctx_;
+
+  public:
+	WebSocket(WebSocketHub* hub, const std::shared_ptr<tcp::Connection>& conn);
+	~WebSocket();
+
+	// 线程安全
+	void send(std::string_view payload, Opcode opcode = Opcode::kText);
+	void close(uint16_t code = 1000, std::string_view reason = {});
+
+	// 服务端 drain：发送 1001 Going Away 后结束请求，连接随之关闭。
+	// 仅限 loop 线程
+	void drain();
+
+	// 发送已编码好的帧，仅限 loop 线程；用于广播时一次编码多次发送
+	void sendFrame(const std::string& frame);
+
+	std::shared_ptr<tcp::Connection> connection() const
+	{
+		return conn_.lock();
+	}
+
+	tcp::EventLoop* loop() const
+	{
+		return loop_;
+	}
+
+	void setContext(const std::any& ctx)
+	{
+		ctx_ = ctx;
+	}
+
+	template <typename T> T& context()
+	{
+		return std::any_cast<T&>(ctx_);
+	}
+
+	// 服务端发出的帧不加掩码
+	static std::string encodeFrame(std::string_view payload, Opcode opcode,
+								   bool fin = true);
+	static std::string encodeClose(uint16_t code, std::string_view reason);
+
+	// dst 与 src 可以相同
+	static void unmask(char* dst, const char* src, size_t len,
+					   const uint8_t key[4]);
+
+  private:
+	void handleMessage(const std::shared_ptr<tcp::Connection>& conn,
+					   tcp::Buffer* buf);
+	void handleControl(Opcode opcode, const char* payload, size_t len);
+	void handleClose();
+	void deliver(Opcode opcode, const std::string& message);
+	void fail(uint16_t code);
+};
+
+// 管理所有 WebSocket 连接：握手、按 loop 分组的心跳与广播
+class WebSocketHub : public base::noncopyable
+{
+	friend class WebSocket;
+
+  public:
+	using Opcode = WebSocket::Opcode;
+	using message_callback = std::function<void(
+		const std::shared_ptr<WebSocket>&, const std::string&, Opcode)>;
+	using event_callback =
+		std::function<void(const std::shared_ptr<WebSocket>&)>;
+
+  private:
+	message_callback message_callback_;
+	event_callback open_callback_;
+	event_callback close_callback_;
+
+	double ping_interval_;
+	size_t max_message_size_;
+	size_t max_pending_bytes_;
+
+	FanOut<WebSocket> sockets_;
+
+  public:
+	WebSocketHub();
+	~WebSocketHub();
+
+	// 注册到 Router，如 router.addRoute("GET", "/ws", hub.handler())；
+	// WebSocketHub 的生命周期需长于 Server
+	Router::http_handler handler()
+	{
+		return [this](const Request& req, Response* res,
+					  const std::shared_ptr<tcp::Connection>& conn)
+		{ upgrade(req, res, conn); };
+	}
+
+	// 握手失败时回复 400/426 并返回 nullptr
+	std::shared_ptr<WebSocket> upgrade(
+		const Request& req, Response* res,
+		const std::shared_ptr<tcp::Connection>& conn);
+
+	// 线程安全：帧只编码一次，再分发到各 loop 中发送
+	void broadcast(std::string_view payload, Opcode opcode = Opcode::kText);
+
+	void setMessageCallback(message_callback cb)
+	{
+		message_callback_ = std::move(cb);
+	}
+
+	void setOpenCallback(event_callback cb)
+	{
+		open_callback_ = std::move(cb);
+	}
+
+	void setCloseCallback(event_callback cb)
+	{
+		close_callback_ = std::move(cb);
+	}
+
+	// 空闲超过该时间发送 ping，超过两倍仍无数据则断开
+	void setPingInterval(double seconds)
+	{
+		ping_interval_ = seconds;
+	}
+
+	void setMaxMessageSize(size_t bytes)
+	{
+		max_message_size_ = bytes;
+	}
+
+	// 慢消费者的 output buffer 超过该值时断开
+	void setMaxPendingBytes(size_t bytes)
+	{
+		max_pending_bytes_ = bytes;
+	}
+
+	size_t size() const
+	{
+		return sockets_.size();
+	}
+
+  private:
+	void join(const std::shared_ptr<WebSocket>& ws);
+	void leave(WebSocket* ws);
+	void sweep(WebSocket::Group* group);
+};
+} // namespace http
+} // namespace lynx
+
+#endif
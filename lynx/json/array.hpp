@@ -48,21 +48,14 @@ class Array : public Element
 		return std::dynamic_pointer_cast<Array>(shared_from_this());
 	}
 
-	std::string serialize() const override
+	void write(Writer* writer) const override
 	{
-		std::string result = "[";
-		bool first = true;
+		writer->startArray();
 		for (const auto& v : arr_)
 		{
-			if (!first)
-			{
-				result += ',';
-			}
-			result += v->serialize(); // 多态
-			first = false;
+			v->write(writer); // 多态
 		}
-		result += ']';
-		return result;
+		writer->endArray();
 	}
 
 	std::shared_ptr<Element> copy() const override
@@ -0,0 +1,380 @@
+#include "lynx/json/document.hpp"
+#include "lynx/json/scalar.hpp"
+#include "lynx/json/token.hpp"
+#include "lynx/json/tokenizer.hpp"
+#include "lynx/json/writer.hpp"
+#include "lynx/logger/logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace lynx;
+using namespace lynx::json;
+
+namespace lynx
+{
+namespace json
+{
+// 递归下降构建 Document：子节点先压入 Document 的暂存栈，
+// 容器闭合时一次性拷入 arena，每个容器只分配一次
+class DocumentParser : public base::noncopyable
+{
+  private:
+	Document* doc_;
+	Tokenizer tokenizer_;
+
+  public:
+	DocumentParser(Document* doc, std::string_view text)
+		: doc_(doc), tokenizer_(text)
+	{
+	}
+
+	Node parse()
+	{
+		if (peek().type == TokenType::End)
+		{
+			LOG_ERROR << "Empty document";
+			throw std::runtime_error("Empty document");
+		}
+		Node root = parseValue(0);
+		if (peek().type != TokenType::End)
+		{
+			LOG_ERROR << "Unexpected trailing characters";
+			throw std::runtime_error("Unexpected trailing characters");
+		}
+		return root;
+	}
+
+  private:
+	const Token& peek() const noexcept
+	{
+		return tokenizer_.peek();
+	}
+
+	void consume()
+	{
+		tokenizer_.consume();
+	}
+
+	void expect(TokenType type, const char* what)
+	{
+		if (peek().type != type)
+		{
+			LOG_ERROR << what;
+			throw std::runtime_error(what);
+		}
+		consume();
+	}
+
+	Node parseValue(size_t depth)
+	{
+		if (depth >= Document::kMaxDepth)
+		{
+			LOG_ERROR << "Document nested too deeply";
+			throw std::runtime_error("Document nested too deeply");
+		}
+
+		const Token& token = peek();
+		Node node;
+		switch (token.type)
+		{
+		case TokenType::kObjectBegin:
+			return parseObject(depth);
+		case TokenType::kArrayBegin:
+			return parseArray(depth);
+		case TokenType::kString:
+			node = doc_->makeString(token.value);
+			break;
+		case TokenType::kInteger:
+		case TokenType::kFloat:
+		{
+			Scalar num;
+			if (!parseScalar(token.value, &num))
+			{
+				LOG_ERROR << "Invalid number";
+				throw std::runtime_error("Invalid number");
+			}
+			node = num.kind == Scalar::Kind::kInt
+					   ? Document::makeInt(num.integer)
+					   : Document::makeFloat(num.number);
+			break;
+		}
+		case TokenType::kBool:
+			node = Document::makeBool(token.value == "true");
+			break;
+		case TokenType::kNull:
+			break;
+		default:
+			LOG_ERROR << "Unexpected token for a value";
+			throw std::runtime_error("Unexpected token for a value");
+		}
+		consume();
+		return node;
+	}
+
+	Node parseArray(size_t depth)
+	{
+		consume(); // for '['
+
+		size_t base = doc_->elements_.size();
+		if (peek().type != TokenType::kArrayEnd)
+		{
+			while (true)
+			{
+				// 递归解析，push 放在解析之后：子容器会临时使用栈顶
+				Node element = parseValue(depth + 1);
+				doc_->elements_.push_back(element);
+
+				if (peek().type != TokenType::kComma)
+				{
+					break;
+				}
+				consume();
+			}
+		}
+		expect(TokenType::kArrayEnd, "Expected comma or ']'");
+
+		return doc_->makeArray(base);
+	}
+
+	Node parseObject(size_t depth)
+	{
+		consume(); // for '{'
+
+		size_t base = doc_->members_.size();
+		if (peek().type != TokenType::kObjectEnd)
+		{
+			while (true)
+			{
+				if (peek().type != TokenType::kString)
+				{
+					LOG_ERROR << "Expected string key";
+					throw std::runtime_error("Expected string key");
+				}
+				std::string_view key = doc_->copyString(peek().value);
+				consume();
+				expect(TokenType::kColon, "Expected colon");
+
+				Node value = parseValue(depth + 1);
+				doc_->members_.push_back({key, value});
+
+				if (peek().type != TokenType::kComma)
+				{
+					break;
+				}
+				consume();
+			}
+		}
+		expect(TokenType::kObjectEnd, "Expected comma or '}'");
+
+		return doc_->makeObject(base);
+	}
+};
+} // namespace json
+} // namespace lynx
+
+void Document::parse(std::string_view text)
+{
+	arena_.clear();
+	root_ = Node();
+	elements_.clear();
+	members_.clear();
+
+	try
+	{
+		root_ = DocumentParser(this, text).parse();
+	}
+	catch (...)
+	{
+		arena_.clear();
+		root_ = Node();
+		elements_.clear();
+		members_.clear();
+		throw;
+	}
+}
+
+std::string_view Document::copyString(std::string_view str)
+{
+	if (str.empty())
+	{
+		return {};
+	}
+	char* p = arena_.allocate<char>(str.size());
+	::memcpy(p, str.data(), str.size());
+	return {p, str.size()};
+}
+
+Node Document::makeString(std::string_view str)
+{
+	std::string_view copy = copyString(str);
+	Node node;
+	node.type_ = NodeType::kString;
+	node.size_ = static_cast<uint32_t>(copy.size());
+	node.str_ = copy.data();
+	return node;
+}
+
+Node Document::makeArray(size_t base)
+{
+	size_t n = elements_.size() - base;
+	Node node;
+	node.type_ = NodeType::kArray;
+	node.size_ = static_cast<uint32_t>(n);
+	node.elements_ = nullptr;
+	if (n > 0)
+	{
+		Node* elements = arena_.allocate<Node>(n);
+		std::copy(elements_.begin() + base, elements_.end(), elements);
+		node.elements_ = elements;
+	}
+	elements_.resize(base);
+	return node;
+}
+
+Node Document::makeObject(size_t base)
+{
+	size_t n = members_.size() - base;
+	Node node;
+	node.type_ = NodeType::kObject;
+	node.size_ = static_cast<uint32_t>(n);
+	node.members_ = nullptr;
+	if (n > 0)
+	{
+		Member* members = arena_.allocate<Member>(n);
+		std::copy(members_.begin() + base, members_.end(), members);
+		node.members_ = members;
+	}
+	members_.resize(base);
+	return node;
+}
+
+Node Document::makeBool(bool val)
+{
+	Node node;
+	node.type_ = NodeType::kBool;
+	node.bool_ = val;
+	return node;
+}
+
+Node Document::makeInt(int64_t val)
+{
+	Node node;
+	node.type_ = NodeType::kInt;
+	node.int_ = val;
+	return node;
+}
+
+Node Document::makeFloat(double val)
+{
+	Node node;
+	node.type_ = NodeType::kFloat;
+	node.float_ = val;
+	return node;
+}
+
+bool Node::asBool() const
+{
+	if (isBool())
+	{
+		return bool_;
+	}
+	LOG_ERROR << "Not bool type";
+	throw std::runtime_error("Not bool type");
+}
+
+int64_t Node::asInt() const
+{
+	if (isInt())
+	{
+		return int_;
+	}
+	LOG_ERROR << "Not int type";
+	throw std::runtime_error("Not int type");
+}
+
+double Node::asFloat() const
+{
+	if (isFloat())
+	{
+		return float_;
+	}
+	LOG_ERROR << "Not float type";
+	throw std::runtime_error("Not float type");
+}
+
+std::string_view Node::asStr() const
+{
+	if (isStr())
+	{
+		return {str_, size_};
+	}
+	LOG_ERROR << "Not str type";
+	throw std::runtime_error("Not str type");
+}
+
+std::span<const Node> Node::elements() const
+{
+	if (isArray())
+	{
+		return {elements_, size_};
+	}
+	LOG_ERROR << "Not an array";
+	throw std::runtime_error("Not an array");
+}
+
+std::span<const Member> Node::members() const
+{
+	if (isObject())
+	{
+		return {members_, size_};
+	}
+	LOG_ERROR << "Not an object";
+	throw std::runtime_error("Not an object");
+}
+
+const Node& Node::operator[](size_t index) const
+{
+	std::span<const Node> elements = this->elements();
+	if (index >= elements.size())
+	{
+		throw std::out_of_range("Array index out of range");
+	}
+	return elements[index];
+}
+
+const Node& Node::operator[](std::string_view key) const
+{
+	const Node* node = find(key);
+	if (node == nullptr)
+	{
+		throw std::out_of_range("Key not found: " + std::string(key));
+	}
+	return *node;
+}
+
+const Node* Node::find(std::string_view key) const
+{
+	// 成员保持输入顺序，请求体中的对象通常很小，线性查找即可
+	for (const Member& member : members())
+	{
+		if (member.key == key)
+		{
+			return &member.value;
+		}
+	}
+	return nullptr;
+}
+
+std::string Node::serialize() const
+{
+	std::string out;
+	serialize(&out);
+	return out;
+}
+
+void Node::serialize(std::string* out) const
+{
+	Writer(out).write(*this);
+}
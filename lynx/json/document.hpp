@@ -0,0 +1,188 @@
+#ifndef LYNX_JSON_DOCUMENT_HPP
+#define LYNX_JSON_DOCUMENT_HPP
+
+#include "lynx/base/arena.hpp"
+#include "lynx/base/noncopyable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace lynx
+{
+namespace json
+{
+enum class NodeType : uint8_t
+{
+	kNull,
+	kBool,
+	kInt,
+	kFloat,
+	kString,
+	kArray,
+	kObject
+};
+
+struct Member;
+
+// Document 中的节点：类型标记加联合体，16 字节，平凡复制与析构。
+// 字符串与子节点都在所属 Document 的 arena 中，只在 Document 存活期间有效
+class Node
+{
+  private:
+	friend class Document;
+
+	NodeType type_;
+	uint32_t size_; // 字符串长度或子节点个数
+	union
+	{
+		bool bool_;
+		int64_t int_;
+		double float_;
+		const char* str_;
+		const Node* elements_;
+		const Member* members_;
+	};
+
+  public:
+	Node() : type_(NodeType::kNull), size_(0), int_(0)
+	{
+	}
+
+	NodeType type() const noexcept
+	{
+		return type_;
+	}
+
+	bool isNull() const noexcept
+	{
+		return type_ == NodeType::kNull;
+	}
+
+	bool isBool() const noexcept
+	{
+		return type_ == NodeType::kBool;
+	}
+
+	bool isInt() const noexcept
+	{
+		return type_ == NodeType::kInt;
+	}
+
+	bool isFloat() const noexcept
+	{
+		return type_ == NodeType::kFloat;
+	}
+
+	bool isStr() const noexcept
+	{
+		return type_ == NodeType::kString;
+	}
+
+	bool isArray() const noexcept
+	{
+		return type_ == NodeType::kArray;
+	}
+
+	bool isObject() const noexcept
+	{
+		return type_ == NodeType::kObject;
+	}
+
+	bool asBool() const;
+	int64_t asInt() const;
+	double asFloat() const;
+	std::string_view asStr() const;
+
+	// 数组或对象的子节点个数，其他类型为 0
+	size_t size() const noexcept
+	{
+		return isArray() || isObject() ? size_ : 0;
+	}
+
+	std::span<const Node> elements() const;
+	std::span<const Member> members() const;
+
+	// 越界或键不存在时抛出异常
+	const Node& operator[](size_t index) const;
+	const Node& operator[](std::string_view key) const;
+	// 键不存在时返回 nullptr；重复的键取第一个
+	const Node* find(std::string_view key) const;
+
+	std::string serialize() const;
+	void serialize(std::string* out) const;
+};
+
+struct Member
+{
+	std::string_view key;
+	Node value;
+};
+
+// 一次解析得到的整棵树：节点、键与字符串都分配在 document 自有的 arena 中，
+// 节点没有虚函数和引用计数，析构时按块整体释放，不逐个析构节点。
+// 同一 Document 可反复 parse，arena 与解析用的栈在多次解析间复用
+class Document : public base::noncopyable
+{
+  public:
+	static constexpr size_t kMaxDepth = 512;
+
+  private:
+	base::Arena arena_;
+	Node root_;
+
+	// 解析时暂存尚未闭合的数组元素与对象成员，闭合时整段拷入 arena
+	std::vector<Node> elements_;
+	std::vector<Member> members_;
+
+  public:
+	explicit Document(size_t block_size = 4096) : arena_(block_size)
+	{
+	}
+
+	// 解析失败抛出 std::runtime_error，此前的内容被清空
+	void parse(std::string_view text);
+
+	const Node& root() const
+	{
+		return root_;
+	}
+
+	const Node& operator[](std::string_view key) const
+	{
+		return root_[key];
+	}
+
+	const Node& operator[](size_t index) const
+	{
+		return root_[index];
+	}
+
+	std::string serialize() const
+	{
+		return root_.serialize();
+	}
+
+	// arena 中已使用的字节数
+	size_t memoryUsage() const
+	{
+		return arena_.used();
+	}
+
+  private:
+	friend class DocumentParser;
+
+	std::string_view copyString(std::string_view str);
+	Node makeString(std::string_view str);
+	Node makeArray(size_t base);
+	Node makeObject(size_t base);
+
+	static Node makeBool(bool val);
+	static Node makeInt(int64_t val);
+	static Node makeFloat(double val);
+};
+} // namespace json
+} // namespace lynx
+
+#endif
@@ -2,6 +2,7 @@
 #define LYNX_JSON_ELEMENT_HPP
 
 #include "lynx/base/copyable.hpp"
+#include "lynx/json/writer.hpp"
 #include "lynx/logger/logger.hpp"
 #include <memory>
 #include <stdexcept>
@@ -59,9 +60,15 @@ class Element : public base::copyable,
 
 	virtual std::shared_ptr<Element> copy() const = 0;
 
-	virtual std::string serialize() const
+	// 按 Writer 的格式输出自身及全部子节点
+	virtual void write(Writer* writer) const = 0;
+
+	std::string serialize() const
 	{
-		return "";
+		std::string out;
+		Writer writer(&out);
+		write(&writer);
+		return out;
 	}
 
 	virtual void clear()
@@ -0,0 +1,160 @@
+#ifndef LYNX_JSON_ESCAPE_HPP
+#define LYNX_JSON_ESCAPE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+namespace lynx
+{
+namespace json
+{
+namespace detail
+{
+inline int hexValue(char c)
+{
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f')
+	{
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F')
+	{
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+// 读取 \u 之后的 4 位十六进制数，失败返回 -1
+inline int32_t readHex4(std::string_view in, size_t pos)
+{
+	if (pos + 4 > in.size())
+	{
+		return -1;
+	}
+	int32_t code = 0;
+	for (size_t i = pos; i < pos + 4; ++i)
+	{
+		int v = hexValue(in[i]);
+		if (v < 0)
+		{
+			return -1;
+		}
+		code = code * 16 + v;
+	}
+	return code;
+}
+
+inline void appendUtf8(uint32_t code, std::string* out)
+{
+	if (code < 0x80)
+	{
+		out->push_back(static_cast<char>(code));
+	}
+	else if (code < 0x800)
+	{
+		out->push_back(static_cast<char>(0xC0 | (code >> 6)));
+		out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+	}
+	else if (code < 0x10000)
+	{
+		out->push_back(static_cast<char>(0xE0 | (code >> 12)));
+		out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+		out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+	}
+	else
+	{
+		out->push_back(static_cast<char>(0xF0 | (code >> 18)));
+		out->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+		out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+		out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+	}
+}
+} // namespace detail
+
+// 把字符串字面量（不含两侧引号）中的转义序列还原后追加到 out，
+// \uXXXX 转为 UTF-8，代理对合并为一个码点。遇到非法转义返回 false
+inline bool unescape(std::string_view in, std::string* out)
+{
+	out->reserve(out->size() + in.size());
+	size_t i = 0;
+	while (i < in.size())
+	{
+		size_t slash = in.find('\\', i);
+		if (slash == std::string_view::npos)
+		{
+			out->append(in.substr(i));
+			break;
+		}
+		out->append(in.substr(i, slash - i));
+		if (slash + 1 >= in.size())
+		{
+			return false;
+		}
+
+		char c = in[slash + 1];
+		i = slash + 2;
+		switch (c)
+		{
+		case '"':
+		case '\\':
+		case '/':
+			out->push_back(c);
+			break;
+		case 'b':
+			out->push_back('\b');
+			break;
+		case 'f':
+			out->push_back('\f');
+			break;
+		case 'n':
+			out->push_back('\n');
+			break;
+		case 'r':
+			out->push_back('\r');
+			break;
+		case 't':
+			out->push_back('\t');
+			break;
+		case 'u':
+		{
+			int32_t code = detail::readHex4(in, i);
+			if (code < 0)
+			{
+				return false;
+			}
+			i += 4;
+			// 高位代理后面须紧跟低位代理
+			if (code >= 0xD800 && code <= 0xDBFF)
+			{
+				int32_t low = -1;
+				if (i + 1 < in.size() && in[i] == '\\' && in[i + 1] == 'u')
+				{
+					low = detail::readHex4(in, i + 2);
+				}
+				if (low < 0xDC00 || low > 0xDFFF)
+				{
+					return false;
+				}
+				i += 6;
+				code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+			}
+			else if (code >= 0xDC00 && code <= 0xDFFF)
+			{
+				return false;
+			}
+			detail::appendUtf8(static_cast<uint32_t>(code), out);
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+} // namespace json
+} // namespace lynx
+
+#endif
@@ -4,7 +4,6 @@
 #include "lynx/json/element.hpp"
 #include "lynx/json/value.hpp"
 #include <cstddef>
-#include <format>
 #include <map>
 #include <memory>
 #include <string>
@@ -48,22 +47,15 @@ class Object : public Element
 		return std::dynamic_pointer_cast<Object>(shared_from_this());
 	}
 
-	std::string serialize() const override
+	void write(Writer* writer) const override
 	{
-		std::string result = "{";
-		bool first = true;
+		writer->startObject();
 		for (const auto& kv : obj_)
 		{
-			if (!first)
-			{
-				result += ',';
-			}
-			result +=
-				std::format("\"{}\":{}", kv.first, kv.second->serialize());
-			first = false;
+			writer->key(kv.first);
+			kv.second->write(writer);
 		}
-		result += '}';
-		return result;
+		writer->endObject();
 	}
 
 	std::shared_ptr<Element> copy() const override
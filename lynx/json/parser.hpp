@@ -6,6 +6,7 @@
 #include "lynx/json/element.hpp"
 #include "lynx/json/object.hpp"
 #include "lynx/json/ref.hpp"
+#include "lynx/json/scalar.hpp"
 #include "lynx/json/token.hpp"
 #include "lynx/json/tokenizer.hpp"
 #include "lynx/json/value.hpp"
@@ -58,21 +59,25 @@ class Parser : public base::noncopyable
 			return parseArray();
 		case TokenType::kString:
 		{
-			std::string val = token.value;
+			std::string val(token.value);
 			consume();
 			return std::make_shared<Value>(std::move(val));
 		}
 		case TokenType::kInteger:
-		{
-			int64_t val = std::stoll(token.value);
-			consume();
-			return std::make_shared<Value>(std::move(val));
-		}
 		case TokenType::kFloat:
 		{
-			double val = std::stod(token.value);
+			Scalar num;
+			if (!parseScalar(token.value, &num))
+			{
+				LOG_FATAL << "Invalid number";
+				throw std::runtime_error("Invalid number");
+			}
 			consume();
-			return std::make_shared<Value>(std::move(val));
+			if (num.kind == Scalar::Kind::kInt)
+			{
+				return std::make_shared<Value>(num.integer);
+			}
+			return std::make_shared<Value>(num.number);
 		}
 		case TokenType::kBool:
 		{
@@ -114,7 +119,7 @@ class Parser : public base::noncopyable
 				throw std::runtime_error("Expected string key");
 			}
 
-			std::string key = key_token.value;
+			std::string key(key_token.value);
 			consume();
 
 			if (peek().type != TokenType::kColon)
@@ -193,72 +193,7 @@ inline Ref make_object(std::initializer_list<Pair> ref_dict)
 
 inline std::ostream& operator<<(std::ostream& os, const Ref& ref)
 {
-	Element* e = ref.get();
-	if (e->isArray())
-	{
-		auto arr = e->asArray();
-		os << '[';
-		bool first = true;
-
-		for (const auto& v : *arr)
-		{
-			if (!first)
-			{
-				os << ',';
-			}
-			os << Ref(v); // 递归调用 operator<<
-			first = false;
-		}
-		os << ']';
-		return os;
-	}
-	else if (e->isObject())
-	{
-		auto obj = e->asObject();
-		os << '{';
-		bool first = true;
-
-		for (const auto& kv : *obj)
-		{
-			if (!first)
-			{
-				os << ',';
-			}
-			os << '\"' << kv.first << "\":" << Ref(kv.second);
-			first = false;
-		}
-		os << '}';
-		return os;
-	}
-
-	auto val = e->asValue();
-	if (val->isBool())
-	{
-		os << (val->asBool() ? "true" : "false");
-	}
-	else if (val->isInt())
-	{
-		os << val->asInt();
-	}
-	else if (val->isFloat())
-	{
-		os << val->asFloat();
-	}
-	else if (val->isStr())
-	{
-		os << '\"' << val->asStr() << '\"';
-	}
-	else if (val->isNull())
-	{
-		os << "null";
-	}
-	else
-	{
-		LOG_WARN << "Unsupported type to print";
-		os << "null";
-	}
-
-	return os;
+	return os << ref.serialize();
 }
 } // namespace json
 } // namespace lynx
@@ -0,0 +1,173 @@
+#ifndef LYNX_JSON_SCALAR_HPP
+#define LYNX_JSON_SCALAR_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+namespace lynx
+{
+namespace json
+{
+// 数字或 true/false/null 字面量的解析结果
+struct Scalar
+{
+	enum class Kind
+	{
+		kNull,
+		kBool,
+		kInt,
+		kFloat
+	};
+
+	Kind kind = Kind::kNull;
+	bool boolean = false;
+	int64_t integer = 0;
+	double number = 0.0;
+};
+
+namespace detail
+{
+inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// 按 JSON 语法检查数字：-?(0|[1-9]\d*)(\.\d+)?([eE][+-]?\d+)?
+inline bool validNumber(std::string_view text, bool* is_float)
+{
+	size_t i = 0;
+	size_t n = text.size();
+	*is_float = false;
+
+	if (i < n && text[i] == '-')
+	{
+		++i;
+	}
+	if (i >= n || !isDigit(text[i]))
+	{
+		return false;
+	}
+	if (text[i] == '0')
+	{
+		++i;
+	}
+	else
+	{
+		while (i < n && isDigit(text[i]))
+		{
+			++i;
+		}
+	}
+
+	if (i < n && text[i] == '.')
+	{
+		*is_float = true;
+		if (++i >= n || !isDigit(text[i]))
+		{
+			return false;
+		}
+		while (i < n && isDigit(text[i]))
+		{
+			++i;
+		}
+	}
+
+	if (i < n && (text[i] == 'e' || text[i] == 'E'))
+	{
+		*is_float = true;
+		++i;
+		if (i < n && (text[i] == '+' || text[i] == '-'))
+		{
+			++i;
+		}
+		if (i >= n || !isDigit(text[i]))
+		{
+			return false;
+		}
+		while (i < n && isDigit(text[i]))
+		{
+			++i;
+		}
+	}
+
+	return i == n;
+}
+} // namespace detail
+
+// 解析一个完整的标量文本，不符合 JSON 语法时返回 false。
+// 直接在输入上使用 from_chars，与 locale 无关；
+// 超出 int64_t 的整数退化为 double，超出 double 范围的数字返回 false
+inline bool parseScalar(std::string_view text, Scalar* out)
+{
+	if (text == "true" || text == "false")
+	{
+		out->kind = Scalar::Kind::kBool;
+		out->boolean = text[0] == 't';
+		return true;
+	}
+	if (text == "null")
+	{
+		out->kind = Scalar::Kind::kNull;
+		return true;
+	}
+
+	bool is_float = false;
+	if (!detail::validNumber(text, &is_float))
+	{
+		return false;
+	}
+
+	const char* first = text.data();
+	const char* last = first + text.size();
+	if (!is_float)
+	{
+		auto [ptr, ec] = std::from_chars(first, last, out->integer);
+		if (ec == std::errc())
+		{
+			out->kind = Scalar::Kind::kInt;
+			return ptr == last;
+		}
+		if (ec != std::errc::result_out_of_range)
+		{
+			return false;
+		}
+	}
+
+	out->kind = Scalar::Kind::kFloat;
+	auto [ptr, ec] = std::from_chars(first, last, out->number);
+	return ec == std::errc() && ptr == last;
+}
+
+// 以下输出函数要求 buf 至少有 kMaxNumberLength 字节，返回写入的末尾
+constexpr size_t kMaxNumberLength = 32;
+
+inline char* formatInt(int64_t val, char* buf)
+{
+	return std::to_chars(buf, buf + kMaxNumberLength, val).ptr;
+}
+
+// 最短且可精确还原的表示；整数值补 ".0" 以保持浮点类型，
+// NaN 与无穷在 JSON 中无法表示，输出 null
+inline char* formatFloat(double val, char* buf)
+{
+	if (!std::isfinite(val))
+	{
+		return std::copy_n("null", 4, buf);
+	}
+
+	char* end = std::to_chars(buf, buf + kMaxNumberLength - 2, val).ptr;
+	if (std::find_first_of(buf, end, ".e", ".e" + 2) == end)
+	{
+		*end++ = '.';
+		*end++ = '0';
+	}
+	return end;
+}
+} // namespace json
+} // namespace lynx
+
+#endif
@@ -0,0 +1,179 @@
+#include "lynx/json/simd_parser.hpp"
+#include "lynx/json/scalar.hpp"
+#include "lynx/json/value.hpp"
+#include "lynx/logger/logger.hpp"
+#include <stdexcept>
+#include <utility>
+
+using namespace lynx;
+using namespace lynx::json;
+
+namespace
+{
+[[noreturn]] void fail(const char* what)
+{
+	LOG_ERROR << what;
+	throw std::runtime_error(what);
+}
+} // namespace
+
+Ref SimdParser::parse(std::string_view text)
+{
+	return parse(text, StructuralIndex::best());
+}
+
+Ref SimdParser::parse(std::string_view text, StructuralIndex::Simd simd)
+{
+	index_.build(text, simd);
+	next_ = 0;
+	if (index_.size() == 0)
+	{
+		return Ref(nullptr);
+	}
+
+	std::shared_ptr<Element> root = parseValue(0);
+	if (next_ != index_.size())
+	{
+		fail("Unexpected trailing characters");
+	}
+	return Ref(std::move(root));
+}
+
+char SimdParser::peek() const
+{
+	if (next_ >= index_.size())
+	{
+		fail("Unexpected end of input");
+	}
+	return index_.text()[index_[next_]];
+}
+
+void SimdParser::expect(char c, const char* what)
+{
+	if (peek() != c)
+	{
+		fail(what);
+	}
+	++next_;
+}
+
+std::shared_ptr<Element> SimdParser::parseValue(size_t depth)
+{
+	if (depth >= kMaxDepth)
+	{
+		fail("Document nested too deeply");
+	}
+
+	switch (peek())
+	{
+	case '{':
+		return parseObject(depth);
+	case '[':
+		return parseArray(depth);
+	case '"':
+		return std::make_shared<Value>(parseString());
+	case '}':
+	case ']':
+	case ':':
+	case ',':
+		fail("Unexpected token for a value");
+	default:
+		break;
+	}
+
+	Scalar scalar;
+	if (!parseScalar(index_.atom(next_), &scalar))
+	{
+		fail("Invalid literal");
+	}
+	++next_;
+
+	switch (scalar.kind)
+	{
+	case Scalar::Kind::kBool:
+		return std::make_shared<Value>(scalar.boolean);
+	case Scalar::Kind::kInt:
+		return std::make_shared<Value>(scalar.integer);
+	case Scalar::Kind::kFloat:
+		return std::make_shared<Value>(scalar.number);
+	default:
+		return std::make_shared<Value>();
+	}
+}
+
+std::shared_ptr<Object> SimdParser::parseObject(size_t depth)
+{
+	++next_; // for '{'
+
+	auto obj = std::make_shared<Object>();
+	if (peek() == '}')
+	{
+		++next_;
+		return obj;
+	}
+
+	while (true)
+	{
+		if (peek() != '"')
+		{
+			fail("Expected string key");
+		}
+		std::string key = parseString();
+		expect(':', "Expected colon");
+
+		// 递归解析
+		obj->insert(key, parseValue(depth + 1));
+
+		char c = peek();
+		++next_;
+		if (c == '}')
+		{
+			break;
+		}
+		if (c != ',')
+		{
+			fail("Expected comma or '}'");
+		}
+	}
+
+	return obj;
+}
+
+std::shared_ptr<Array> SimdParser::parseArray(size_t depth)
+{
+	++next_; // for '['
+
+	auto arr = std::make_shared<Array>();
+	if (peek() == ']')
+	{
+		++next_;
+		return arr;
+	}
+
+	while (true)
+	{
+		// 递归解析
+		arr->append(parseValue(depth + 1));
+
+		char c = peek();
+		++next_;
+		if (c == ']')
+		{
+			break;
+		}
+		if (c != ',')
+		{
+			fail("Expected comma or ']'");
+		}
+	}
+
+	return arr;
+}
+
+std::string SimdParser::parseString()
+{
+	// 左右引号各占一个下标
+	std::string str(index_.string(next_, &scratch_));
+	next_ += 2;
+	return str;
+}
@@ -0,0 +1,52 @@
+#ifndef LYNX_JSON_SIMD_PARSER_HPP
+#define LYNX_JSON_SIMD_PARSER_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/json/array.hpp"
+#include "lynx/json/element.hpp"
+#include "lynx/json/object.hpp"
+#include "lynx/json/ref.hpp"
+#include "lynx/json/structural_index.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+namespace lynx
+{
+namespace json
+{
+// 基于 StructuralIndex 的解析器，结果与 Parser 相同（Ref DOM），
+// 但先向量化地找出全部结构位置，再按下标构建节点。
+// 可重复使用，下标缓冲区在多次解析间复用
+class SimdParser : public base::noncopyable
+{
+  public:
+	static constexpr size_t kMaxDepth = 512;
+
+  private:
+	StructuralIndex index_;
+	std::string scratch_;
+	size_t next_;
+
+  public:
+	SimdParser() : next_(0)
+	{
+	}
+
+	// 语法错误时抛出 std::runtime_error；输入为空时返回空引用，与 Parser 一致
+	Ref parse(std::string_view text);
+	Ref parse(std::string_view text, StructuralIndex::Simd simd);
+
+  private:
+	char peek() const;
+	void expect(char c, const char* what);
+
+	std::shared_ptr<Element> parseValue(size_t depth);
+	std::shared_ptr<Object> parseObject(size_t depth);
+	std::shared_ptr<Array> parseArray(size_t depth);
+	std::string parseString();
+};
+} // namespace json
+} // namespace lynx
+
+#endif
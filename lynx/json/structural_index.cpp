@@ -0,0 +1,314 @@
+#include "lynx/json/structural_index.hpp"
+#include "lynx/json/escape.hpp"
+#include "lynx/logger/logger.hpp"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LYNX_JSON_X86 1
+#endif
+
+using namespace lynx;
+using namespace lynx::json;
+
+namespace
+{
+constexpr size_t kBlock = 64;
+
+// 一块 64 字节中各类字符的位图，第 i 位对应第 i 个字节
+struct Masks
+{
+	uint64_t quote;
+	uint64_t backslash;
+	uint64_t structural; // { } [ ] : ,
+	uint64_t whitespace;
+};
+
+using Classifier = void (*)(const char*, Masks*);
+
+void classifyScalar(const char* p, Masks* m)
+{
+	*m = Masks{0, 0, 0, 0};
+	for (size_t i = 0; i < kBlock; ++i)
+	{
+		uint64_t bit = uint64_t{1} << i;
+		switch (p[i])
+		{
+		case '"':
+			m->quote |= bit;
+			break;
+		case '\\':
+			m->backslash |= bit;
+			break;
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+		case ':':
+		case ',':
+			m->structural |= bit;
+			break;
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			m->whitespace |= bit;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+#ifdef LYNX_JSON_X86
+__attribute__((target("sse4.2"))) uint64_t eqSse(const __m128i* v,
+												 char c)
+{
+	__m128i needle = _mm_set1_epi8(c);
+	uint64_t mask = 0;
+	for (int k = 0; k < 4; ++k)
+	{
+		uint32_t bits = static_cast<uint32_t>(
+			_mm_movemask_epi8(_mm_cmpeq_epi8(v[k], needle)));
+		mask |= static_cast<uint64_t>(bits) << (16 * k);
+	}
+	return mask;
+}
+
+__attribute__((target("sse4.2"))) void classifySse42(const char* p, Masks* m)
+{
+	__m128i v[4];
+	for (int k = 0; k < 4; ++k)
+	{
+		v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+	}
+	m->quote = eqSse(v, '"');
+	m->backslash = eqSse(v, '\\');
+	m->structural = eqSse(v, '{') | eqSse(v, '}') | eqSse(v, '[') |
+					eqSse(v, ']') | eqSse(v, ':') | eqSse(v, ',');
+	m->whitespace =
+		eqSse(v, ' ') | eqSse(v, '\t') | eqSse(v, '\n') | eqSse(v, '\r');
+}
+
+__attribute__((target("avx2"))) uint64_t eqAvx2(const __m256i* v, char c)
+{
+	__m256i needle = _mm256_set1_epi8(c);
+	uint32_t lo = static_cast<uint32_t>(
+		_mm256_movemask_epi8(_mm256_cmpeq_epi8(v[0], needle)));
+	uint32_t hi = static_cast<uint32_t>(
+		_mm256_movemask_epi8(_mm256_cmpeq_epi8(v[1], needle)));
+	return static_cast<uint64_t>(hi) << 32 | lo;
+}
+
+__attribute__((target("avx2"))) void classifyAvx2(const char* p, Masks* m)
+{
+	__m256i v[2];
+	v[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	v[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+	m->quote = eqAvx2(v, '"');
+	m->backslash = eqAvx2(v, '\\');
+	m->structural = eqAvx2(v, '{') | eqAvx2(v, '}') | eqAvx2(v, '[') |
+					eqAvx2(v, ']') | eqAvx2(v, ':') | eqAvx2(v, ',');
+	m->whitespace =
+		eqAvx2(v, ' ') | eqAvx2(v, '\t') | eqAvx2(v, '\n') | eqAvx2(v, '\r');
+}
+#endif
+
+StructuralIndex::Simd detect()
+{
+#ifdef LYNX_JSON_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return StructuralIndex::Simd::kAvx2;
+	}
+	if (__builtin_cpu_supports("sse4.2"))
+	{
+		return StructuralIndex::Simd::kSse42;
+	}
+#endif
+	return StructuralIndex::Simd::kScalar;
+}
+
+Classifier classifier(StructuralIndex::Simd simd)
+{
+#ifdef LYNX_JSON_X86
+	static const StructuralIndex::Simd supported = detect();
+	if (simd > supported)
+	{
+		simd = supported;
+	}
+	switch (simd)
+	{
+	case StructuralIndex::Simd::kAvx2:
+		return classifyAvx2;
+	case StructuralIndex::Simd::kSse42:
+		return classifySse42;
+	default:
+		break;
+	}
+#endif
+	return classifyScalar;
+}
+
+// 被反斜杠转义的字符。反斜杠很少出现，逐位处理即可；
+// escaped 为上一块末尾的反斜杠是否转义了本块第一个字符
+uint64_t escapedChars(uint64_t backslash, bool* escaped)
+{
+	uint64_t result = 0;
+	if (*escaped)
+	{
+		result |= 1;
+		backslash &= ~uint64_t{1};
+	}
+	*escaped = false;
+
+	while (backslash != 0)
+	{
+		int i = __builtin_ctzll(backslash);
+		backslash &= backslash - 1;
+		if (i == 63)
+		{
+			*escaped = true;
+			break;
+		}
+		// 被转义的反斜杠不再转义下一个字符
+		uint64_t next = uint64_t{1} << (i + 1);
+		result |= next;
+		backslash &= ~next;
+	}
+	return result;
+}
+
+// 前缀异或：第 i 位为第 0..i 位的异或，即该位置之前（含）引号个数的奇偶
+uint64_t prefixXor(uint64_t x)
+{
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+} // namespace
+
+StructuralIndex::Simd StructuralIndex::best()
+{
+	static const Simd simd = detect();
+	return simd;
+}
+
+const char* StructuralIndex::name(Simd simd)
+{
+	switch (simd)
+	{
+	case Simd::kAvx2:
+		return "avx2";
+	case Simd::kSse42:
+		return "sse4.2";
+	default:
+		return "scalar";
+	}
+}
+
+void StructuralIndex::build(std::string_view text)
+{
+	build(text, best());
+}
+
+void StructuralIndex::build(std::string_view text, Simd simd)
+{
+	if (text.size() >= std::numeric_limits<uint32_t>::max())
+	{
+		LOG_ERROR << "JSON text too large";
+		throw std::runtime_error("JSON text too large");
+	}
+
+	text_ = text;
+	size_ = 0;
+	// 最坏情况下每个字节都是结构字符
+	if (capacity_ < text.size() + kBlock)
+	{
+		capacity_ = text.size() + kBlock;
+		positions_ = std::make_unique<uint32_t[]>(capacity_);
+	}
+
+	Classifier classify = classifier(simd);
+	bool escaped = false;
+	uint64_t inside_carry = 0; // 上一块结束时是否在字符串内
+	uint64_t scalar_carry = 0; // 上一块最后一个字节是否属于标量
+	uint32_t* out = positions_.get();
+
+	for (size_t base = 0; base < text.size(); base += kBlock)
+	{
+		const char* p = text.data() + base;
+		// 最后不足一块时补空白
+		char tail[kBlock];
+		if (text.size() - base < kBlock)
+		{
+			::memset(tail, ' ', kBlock);
+			::memcpy(tail, p, text.size() - base);
+			p = tail;
+		}
+
+		Masks m;
+		classify(p, &m);
+
+		uint64_t quote = m.quote & ~escapedChars(m.backslash, &escaped);
+		// 左引号与字符串内容为 1，右引号为 0
+		uint64_t inside = prefixXor(quote) ^ inside_carry;
+		inside_carry = static_cast<uint64_t>(static_cast<int64_t>(inside) >> 63);
+
+		uint64_t structural = m.structural & ~inside;
+		uint64_t scalar = ~(m.whitespace | m.structural | quote | inside);
+		uint64_t scalar_start = scalar & ~(scalar << 1 | scalar_carry);
+		scalar_carry = scalar >> 63;
+
+		uint64_t bits = structural | quote | scalar_start;
+		while (bits != 0)
+		{
+			*out++ = static_cast<uint32_t>(base + __builtin_ctzll(bits));
+			bits &= bits - 1;
+		}
+	}
+	size_ = out - positions_.get();
+
+	if (inside_carry != 0)
+	{
+		LOG_ERROR << "Unterminated string";
+		throw std::runtime_error("Unterminated string");
+	}
+}
+
+std::string_view StructuralIndex::string(size_t i, std::string* scratch) const
+{
+	size_t begin = positions_[i] + 1;
+	std::string_view str = text_.substr(begin, positions_[i + 1] - begin);
+	if (str.find('\\') == std::string_view::npos)
+	{
+		return str;
+	}
+
+	scratch->clear();
+	if (!unescape(str, scratch))
+	{
+		LOG_ERROR << "Invalid escape sequence";
+		throw std::runtime_error("Invalid escape sequence");
+	}
+	return *scratch;
+}
+
+std::string_view StructuralIndex::atom(size_t i) const
+{
+	size_t begin = positions_[i];
+	size_t end = i + 1 < size_ ? positions_[i + 1] : text_.size();
+	size_t n = begin;
+	while (n < end && text_[n] != ' ' && text_[n] != '\t' &&
+		   text_[n] != '\n' && text_[n] != '\r')
+	{
+		++n;
+	}
+	return text_.substr(begin, n - begin);
+}
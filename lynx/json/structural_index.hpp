@@ -0,0 +1,73 @@
+#ifndef LYNX_JSON_STRUCTURAL_INDEX_HPP
+#define LYNX_JSON_STRUCTURAL_INDEX_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+namespace lynx
+{
+namespace json
+{
+// JSON 解析的第一阶段：按 64 字节一块向量化地分类字符，用位运算排除字符串
+// 内部与被转义的引号，得到所有结构字符、字符串两侧引号以及标量（数字、
+// true/false/null）起始位置的有序下标。第二阶段按下标构建 DOM，
+// 不再逐字符扫描，字符串的长度也直接由一对引号的下标得出
+class StructuralIndex : public base::noncopyable
+{
+  public:
+	enum class Simd
+	{
+		kScalar,
+		kSse42,
+		kAvx2
+	};
+
+  private:
+	std::string_view text_;
+	std::unique_ptr<uint32_t[]> positions_;
+	size_t capacity_;
+	size_t size_;
+
+  public:
+	StructuralIndex() : capacity_(0), size_(0)
+	{
+	}
+
+	// 运行时检测到的最佳指令集
+	static Simd best();
+	static const char* name(Simd simd);
+
+	// 输入超过 4GB 或字符串未闭合时抛出 std::runtime_error。
+	// text 须在使用下标期间保持有效；指定的指令集不可用时退回标量实现
+	void build(std::string_view text);
+	void build(std::string_view text, Simd simd);
+
+	std::string_view text() const
+	{
+		return text_;
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	uint32_t operator[](size_t i) const
+	{
+		return positions_[i];
+	}
+
+	// 下标 i 为字符串的左引号，i + 1 为右引号。返回字符串内容，
+	// 含转义时还原到 scratch 中并返回其内容
+	std::string_view string(size_t i, std::string* scratch) const;
+
+	// 下标 i 处标量的完整文本，到空白、结构字符或引号为止
+	std::string_view atom(size_t i) const;
+};
+} // namespace json
+} // namespace lynx
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef LYNX_JSON_TOKEN_HPP
 #define LYNX_JSON_TOKEN_HPP
 
-#include <string>
+#include <string_view>
 namespace lynx
 {
 namespace json
@@ -25,7 +25,7 @@ enum class TokenType
 struct Token
 {
 	TokenType type;
-	std::string value;
+	std::string_view value;
 };
 } // namespace json
 } // namespace lynx
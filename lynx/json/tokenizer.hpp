@@ -2,6 +2,7 @@
 #define LYNX_JSON_TOKENIZER_HPP
 
 #include "lynx/base/noncopyable.hpp"
+#include "lynx/json/escape.hpp"
 #include "lynx/json/token.hpp"
 #include "lynx/logger/logger.hpp"
 #include <cctype>
@@ -9,62 +10,77 @@
 #include <cstddef>
 #include <stdexcept>
 #include <string>
-#include <utility>
+#include <string_view>
 namespace lynx
 {
 namespace json
 {
+// 借用调用方的输入，不做拷贝；输入须在 Tokenizer 使用期间保持有效
 class InputStream : public base::noncopyable
 {
   private:
-	std::string context_;
+	std::string_view context_;
 	size_t index_;
 
   public:
-	template <typename String>
-		requires std::constructible_from<std::string, String>
-	InputStream(String&& context)
-		: context_(std::forward<String>(context)), index_(0)
+	InputStream(std::string_view context) : context_(context), index_(0)
 	{
 	}
 
 	InputStream(InputStream&& rhs)
-		: context_(std::move(rhs.context_)), index_(rhs.index_)
+		: context_(rhs.context_), index_(rhs.index_)
 	{
 		rhs.index_ = 0;
 	}
 
+	// 到达末尾后返回 '\0' 且不再前进
 	char get()
 	{
-		return context_[index_++];
+		return eof() ? '\0' : context_[index_++];
 	}
 
 	char peek() const
 	{
-		return context_[index_];
+		return eof() ? '\0' : context_[index_];
 	}
 
 	bool eof() const noexcept
 	{
 		return index_ >= context_.size();
 	}
+
+	size_t position() const noexcept
+	{
+		return index_;
+	}
+
+	std::string_view slice(size_t begin, size_t end) const
+	{
+		return context_.substr(begin, end - begin);
+	}
 };
 
+// Token 的值为输入中的视图，含转义的字符串指向还原后的内部缓冲，
+// 均只在下一次 consume() 之前有效
 class Tokenizer : public base::noncopyable
 {
   private:
 	InputStream stream_;
 	char ch_;
 	Token token_;
+	std::string unescaped_;
 
   public:
-	template <typename String>
-		requires std::constructible_from<std::string, String>
-	Tokenizer(String&& context) : stream_(std::forward<String>(context))
+	Tokenizer(std::string_view context) : stream_(context)
 	{
 		consume();
 	}
 
+	// 临时字符串会在解析前析构
+	template <typename String>
+		requires std::same_as<String, std::string>
+	Tokenizer(String&&) = delete;
+
 	const Token& peek() const noexcept
 	{
 		return token_;
@@ -141,17 +157,36 @@ class Tokenizer : public base::noncopyable
 	Token parseString()
 	{
 		stream_.get(); // 跳过 "
-		std::string str;
+		size_t begin = stream_.position();
+		bool escaped = false;
 		while (stream_.peek() != '"')
 		{
-			if (stream_.peek() == '\\')
+			if (stream_.eof())
+			{
+				LOG_ERROR << "Unterminated string";
+				throw std::runtime_error("Unterminated string");
+			}
+			if (stream_.get() == '\\')
 			{
+				escaped = true;
 				stream_.get();
 			}
-			str += stream_.get();
 		}
+		std::string_view str = stream_.slice(begin, stream_.position());
 		stream_.get(); // 跳过 "
-		return {TokenType::kString, std::move(str)};
+
+		// 只有含转义的字符串才需要还原
+		if (escaped)
+		{
+			unescaped_.clear();
+			if (!unescape(str, &unescaped_))
+			{
+				LOG_ERROR << "Invalid escape sequence";
+				throw std::runtime_error("Invalid escape sequence");
+			}
+			str = unescaped_;
+		}
+		return {TokenType::kString, str};
 	}
 
 	Token parseBool()
@@ -194,53 +229,54 @@ class Tokenizer : public base::noncopyable
 
 	Token parseNumber()
 	{
-		std::string num;
+		size_t begin = stream_.position();
 
 		if (stream_.peek() == '-')
 		{
-			num += stream_.get();
+			stream_.get();
 		}
 
 		while (isdigit(stream_.peek()))
 		{
-			num += stream_.get();
+			stream_.get();
 		}
 
 		bool is_float = false;
 		if (stream_.peek() == '.')
 		{
 			is_float = true;
-			num += stream_.get();
+			stream_.get();
 
 			while (isdigit(stream_.peek()))
 			{
-				num += stream_.get();
+				stream_.get();
 			}
 		}
 
 		if (stream_.peek() == 'e' || stream_.peek() == 'E')
 		{
 			is_float = true;
-			num += stream_.get();
+			stream_.get();
 
 			if (stream_.peek() == '+' || stream_.peek() == '-')
 			{
-				num += stream_.get();
+				stream_.get();
 			}
 
 			while (isdigit(stream_.peek()))
 			{
-				num += stream_.get();
+				stream_.get();
 			}
 		}
 
+		std::string_view num = stream_.slice(begin, stream_.position());
 		if (is_float)
 		{
-			return {TokenType::kFloat, std::move(num)};
+			return {TokenType::kFloat, num};
 		}
 		else
 		{
-			return {TokenType::kInteger, std::move(num)};
+			return {TokenType::kInteger, num};
 		}
 	}
 };
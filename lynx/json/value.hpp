@@ -3,6 +3,7 @@
 
 #include "lynx/base/alloc.hpp"
 #include "lynx/json/element.hpp"
+#include "lynx/json/writer.hpp"
 #include "lynx/logger/logger.hpp"
 #include <cstddef>
 #include <cstdint>
@@ -67,31 +68,27 @@ class Value : public Element
 		return std::make_shared<Value>(*this);
 	}
 
-	std::string serialize() const override
+	void write(Writer* writer) const override
 	{
 		if (isBool())
 		{
-			return asBool() ? "true" : "false";
+			writer->boolean(std::get<bool>(val_));
 		}
 		else if (isInt())
 		{
-			return std::to_string(asInt());
+			writer->integer(std::get<int64_t>(val_));
 		}
 		else if (isFloat())
 		{
-			return std::to_string(asFloat());
+			writer->number(std::get<double>(val_));
 		}
 		else if (isStr())
 		{
-			return '\"' + asStr() + '\"'; // 字符串需要加引号
-		}
-		else if (isNull())
-		{
-			return "null";
+			writer->string(std::get<std::string>(val_));
 		}
 		else
 		{
-			return "";
+			writer->null();
 		}
 	}
 
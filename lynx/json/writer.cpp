@@ -0,0 +1,271 @@
+#include "lynx/json/writer.hpp"
+#include "lynx/json/document.hpp"
+#include "lynx/json/element.hpp"
+#include "lynx/json/scalar.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace lynx;
+using namespace lynx::json;
+
+namespace
+{
+bool needsEscape(char c)
+{
+	return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\';
+}
+
+// 返回第一个需要转义的字符位置，绝大多数字符串一个也没有
+const char* findEscape(const char* p, const char* end)
+{
+#ifdef __SSE2__
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i control = _mm_set1_epi8(0x1F);
+	for (; end - p >= 16; p += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		// 无符号 v <= 0x1F 等价于 max(v, 0x1F) == 0x1F
+		__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+								   _mm_cmpeq_epi8(v, backslash));
+		hit = _mm_or_si128(hit,
+						   _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+		int mask = _mm_movemask_epi8(hit);
+		if (mask != 0)
+		{
+			return p + __builtin_ctz(mask);
+		}
+	}
+#endif
+	while (p < end && !needsEscape(*p))
+	{
+		++p;
+	}
+	return p;
+}
+} // namespace
+
+void Writer::append(const char* data, size_t len)
+{
+	if (str_ != nullptr)
+	{
+		str_->append(data, len);
+	}
+	else
+	{
+		buf_->append(data, len);
+	}
+}
+
+void Writer::beforeValue()
+{
+	if (after_key_)
+	{
+		after_key_ = false;
+		return;
+	}
+	if (has_elements_.empty())
+	{
+		return;
+	}
+	if (has_elements_.back())
+	{
+		append(',');
+	}
+	has_elements_.back() = true;
+	newline();
+}
+
+void Writer::newline()
+{
+	if (indent_ == 0)
+	{
+		return;
+	}
+	static const std::string spaces(256, ' ');
+	append('\n');
+	size_t n = has_elements_.size() * indent_;
+	while (n > 0)
+	{
+		size_t len = std::min(n, spaces.size());
+		append(spaces.data(), len);
+		n -= len;
+	}
+}
+
+void Writer::startObject()
+{
+	beforeValue();
+	append('{');
+	has_elements_.push_back(false);
+}
+
+void Writer::endObject()
+{
+	bool non_empty = has_elements_.back();
+	has_elements_.pop_back();
+	if (non_empty)
+	{
+		newline();
+	}
+	append('}');
+}
+
+void Writer::startArray()
+{
+	beforeValue();
+	append('[');
+	has_elements_.push_back(false);
+}
+
+void Writer::endArray()
+{
+	bool non_empty = has_elements_.back();
+	has_elements_.pop_back();
+	if (non_empty)
+	{
+		newline();
+	}
+	append(']');
+}
+
+void Writer::key(std::string_view key)
+{
+	beforeValue();
+	appendEscaped(key);
+	append(indent_ > 0 ? std::string_view(": ") : std::string_view(":"));
+	after_key_ = true;
+}
+
+void Writer::null()
+{
+	beforeValue();
+	append("null");
+}
+
+void Writer::boolean(bool val)
+{
+	beforeValue();
+	append(val ? std::string_view("true") : std::string_view("false"));
+}
+
+void Writer::integer(int64_t val)
+{
+	beforeValue();
+	char buf[kMaxNumberLength];
+	append(buf, formatInt(val, buf) - buf);
+}
+
+void Writer::number(double val)
+{
+	beforeValue();
+	char buf[kMaxNumberLength];
+	append(buf, formatFloat(val, buf) - buf);
+}
+
+void Writer::string(std::string_view str)
+{
+	beforeValue();
+	appendEscaped(str);
+}
+
+void Writer::appendEscaped(std::string_view str)
+{
+	static const char kHex[] = "0123456789abcdef";
+
+	append('"');
+	const char* p = str.data();
+	const char* end = p + str.size();
+	while (p < end)
+	{
+		// 整段追加无需转义的部分
+		const char* q = findEscape(p, end);
+		append(p, q - p);
+		if (q == end)
+		{
+			break;
+		}
+
+		char c = *q;
+		switch (c)
+		{
+		case '"':
+			append("\\\"");
+			break;
+		case '\\':
+			append("\\\\");
+			break;
+		case '\b':
+			append("\\b");
+			break;
+		case '\f':
+			append("\\f");
+			break;
+		case '\n':
+			append("\\n");
+			break;
+		case '\r':
+			append("\\r");
+			break;
+		case '\t':
+			append("\\t");
+			break;
+		default:
+		{
+			char esc[] = {'\\', 'u', '0', '0', kHex[(c >> 4) & 0xF],
+						  kHex[c & 0xF]};
+			append(esc, sizeof(esc));
+			break;
+		}
+		}
+		p = q + 1;
+	}
+	append('"');
+}
+
+void Writer::write(const Element& element)
+{
+	element.write(this);
+}
+
+void Writer::write(const Node& node)
+{
+	switch (node.type())
+	{
+	case NodeType::kNull:
+		null();
+		break;
+	case NodeType::kBool:
+		boolean(node.asBool());
+		break;
+	case NodeType::kInt:
+		integer(node.asInt());
+		break;
+	case NodeType::kFloat:
+		number(node.asFloat());
+		break;
+	case NodeType::kString:
+		string(node.asStr());
+		break;
+	case NodeType::kArray:
+		startArray();
+		for (const Node& element : node.elements())
+		{
+			write(element);
+		}
+		endArray();
+		break;
+	case NodeType::kObject:
+		startObject();
+		for (const Member& member : node.members())
+		{
+			key(member.key);
+			write(member.value);
+		}
+		endObject();
+		break;
+	}
+}
@@ -0,0 +1,82 @@
+#ifndef LYNX_JSON_WRITER_HPP
+#define LYNX_JSON_WRITER_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class Buffer;
+} // namespace tcp
+
+namespace json
+{
+class Element;
+class Node;
+
+// 流式 JSON 输出：直接追加到调用方的 std::string 或连接的 tcp::Buffer，
+// 不产生中间字符串。逗号与缩进由 Writer 维护，字符串按 JSON 规则转义。
+// indent 大于 0 时按该空格数缩进输出
+class Writer : public base::noncopyable
+{
+  private:
+	std::string* str_;
+	tcp::Buffer* buf_;
+	size_t indent_;
+	// 每层容器是否已写出元素
+	std::vector<bool> has_elements_;
+	bool after_key_;
+
+  public:
+	explicit Writer(std::string* out, size_t indent = 0)
+		: str_(out), buf_(nullptr), indent_(indent), after_key_(false)
+	{
+	}
+
+	explicit Writer(tcp::Buffer* out, size_t indent = 0)
+		: str_(nullptr), buf_(out), indent_(indent), after_key_(false)
+	{
+	}
+
+	void startObject();
+	void endObject();
+	void startArray();
+	void endArray();
+	void key(std::string_view key);
+
+	void null();
+	void boolean(bool val);
+	void integer(int64_t val);
+	void number(double val);
+	void string(std::string_view str);
+
+	// 整棵树
+	void write(const Element& element);
+	void write(const Node& node);
+
+  private:
+	void append(const char* data, size_t len);
+
+	void append(std::string_view str)
+	{
+		append(str.data(), str.size());
+	}
+
+	void append(char c)
+	{
+		append(&c, 1);
+	}
+
+	void beforeValue();
+	void newline();
+	void appendEscaped(std::string_view str);
+};
+} // namespace json
+} // namespace lynx
+
+#endif
@@ -1,6 +1,7 @@
 #include "lynx/logger/async_logging.hpp"
 #include "lynx/logger/context.hpp"
 #include "lynx/logger/log_file.hpp"
+#include "lynx/metrics/registry.hpp"
 #include "lynx/time/time_stamp.hpp"
 #include <atomic>
 #include <cassert>
@@ -17,6 +18,13 @@
 using namespace lynx;
 using namespace lynx::logger;
 
+namespace
+{
+const metrics::Counter dropped_metric = metrics::Registry::instance().counter(
+	"lynx_logger_dropped_messages_total",
+	"Log messages dropped because the backend fell behind");
+} // namespace
+
 AsyncLogging::AsyncLogging(const std::string& basename,
 						   const std::string& prefix, int roll_size,
 						   int flush_interval)
@@ -93,14 +101,15 @@ void AsyncLogging::threadWorker()
 	std::vector<Buffer> buf2write;
 	buf2write.reserve(16); // only change its capacity
 
+	// 每个实例各自计数，不能用 static once_flag，否则第二个实例的构造永远阻塞
+	latch_down_.count_down();
+
 	while (!done_.load(std::memory_order_acquire))
 	{
 		{
 			std::unique_lock<std::mutex> lock(mtx_);
 			if (bufs_.empty())
 			{
-				static std::once_flag flag;
-				std::call_once(flag, [&]() { latch_down_.count_down(); });
 				cv_.wait_for(lock, std::chrono::seconds(flush_interval_));
 			}
 
@@ -133,6 +142,10 @@ void AsyncLogging::threadWorker()
 			std::cerr << err;
 
 			out_file.append(err.c_str(), err.size());
+			for (auto it = buf2write.begin() + 2; it != buf2write.end(); ++it)
+			{
+				dropped_metric.inc(it->size());
+			}
 			buf2write.erase(buf2write.begin() + 2, buf2write.end());
 		}
 
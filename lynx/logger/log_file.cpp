@@ -14,7 +14,7 @@ LogFile::LogFile(const std::string& basename, const std::string& prefix,
 				 int roll_size, int flush_interval, int check_per_count)
 	: basename_(basename), prefix_(prefix), roll_size_(roll_size),
 	  flush_interval_(flush_interval), check_per_count_(check_per_count),
-	  count_(0)
+	  count_(0), last_day_(0), last_roll_second_(0), last_flush_second_(0)
 {
 	rollFile();
 }
@@ -0,0 +1,440 @@
+#include "lynx/metrics/registry.hpp"
+#include "lynx/base/alloc.hpp"
+#include <cstdlib>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+using namespace lynx;
+using namespace lynx::metrics;
+
+// 线程退出时把分片的值并入 retired_，再释放分片
+struct Shard::Holder
+{
+	Shard* shard = nullptr;
+
+	~Holder()
+	{
+		if (shard)
+		{
+			Registry::instance().detachShard(shard);
+			local_ = nullptr;
+			delete shard;
+		}
+	}
+};
+
+namespace
+{
+const char* typeName(Registry::Type type)
+{
+	switch (type)
+	{
+	case Registry::Type::kCounter:
+		return "counter";
+	case Registry::Type::kGauge:
+		return "gauge";
+	case Registry::Type::kHistogram:
+		return "histogram";
+	}
+	return "untyped";
+}
+
+void appendEscaped(std::string* out, const std::string& s)
+{
+	for (char c : s)
+	{
+		if (c == '\\' || c == '"')
+		{
+			out->push_back('\\');
+			out->push_back(c);
+		}
+		else if (c == '\n')
+		{
+			out->append("\\n");
+		}
+		else
+		{
+			out->push_back(c);
+		}
+	}
+}
+
+// {k="v",...,extra_k="extra_v"}，没有标签时为空
+void appendLabels(std::string* out, const Labels& labels,
+				  const char* extra_key = nullptr,
+				  const std::string& extra_value = {})
+{
+	if (labels.empty() && !extra_key)
+	{
+		return;
+	}
+
+	out->push_back('{');
+	bool first = true;
+	for (const auto& [k, v] : labels)
+	{
+		if (!first)
+		{
+			out->push_back(',');
+		}
+		first = false;
+		out->append(k);
+		out->append("=\"");
+		appendEscaped(out, v);
+		out->push_back('"');
+	}
+	if (extra_key)
+	{
+		if (!first)
+		{
+			out->push_back(',');
+		}
+		out->append(extra_key);
+		out->append("=\"");
+		out->append(extra_value);
+		out->push_back('"');
+	}
+	out->push_back('}');
+}
+} // namespace
+
+Shard::Shard()
+{
+	for (auto& chunk : chunks_)
+	{
+		chunk.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+Shard::~Shard()
+{
+	for (auto& chunk : chunks_)
+	{
+		delete chunk.load(std::memory_order_relaxed);
+	}
+}
+
+Shard::Chunk* Shard::grow(size_t idx)
+{
+	Chunk* chunk = new Chunk;
+	chunks_[idx].store(chunk, std::memory_order_release);
+	return chunk;
+}
+
+Shard* Shard::attach()
+{
+	Shard* shard = new Shard;
+	Registry::instance().attachShard(shard);
+
+	thread_local Holder holder;
+	holder.shard = shard;
+	return shard;
+}
+
+Registry::Registry() : next_slot_(0)
+{
+	gaugeCallback(
+		"lynx_alloc_pool_bytes",
+		"Bytes the small object pool has obtained from the system",
+		[]() { return static_cast<double>(base::alloc::heapSize()); });
+}
+
+Registry& Registry::instance()
+{
+	// 不析构，线程退出与进程退出的顺序无关
+	static Registry* registry = new Registry;
+	return *registry;
+}
+
+Counter Registry::counter(const std::string& name, const std::string& help,
+						  const Labels& labels)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	return Counter(series(family(name, help, Type::kCounter), labels, 1).slot);
+}
+
+Gauge Registry::gauge(const std::string& name, const std::string& help,
+					  const Labels& labels)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	return Gauge(series(family(name, help, Type::kGauge), labels, 1).slot);
+}
+
+Histogram Registry::histogram(const std::string& name, const std::string& help,
+							  std::vector<double> bounds, const Labels& labels)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	Family* f = family(name, help, Type::kHistogram);
+	if (f->series.empty())
+	{
+		f->bounds = std::move(bounds);
+	}
+	uint32_t slot = series(f, labels, f->bounds.size() + 3).slot;
+	return Histogram(slot, &f->bounds);
+}
+
+void Registry::gaugeCallback(const std::string& name, const std::string& help,
+							 std::function<double()> fn, const Labels& labels)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	Family* f = family(name, help, Type::kGauge);
+	series(f, labels, 0).fn = std::move(fn);
+}
+
+std::string Registry::scrape() const
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+
+	std::string out;
+	out.reserve(4096);
+	for (const auto& f : families_)
+	{
+		out += std::format("# HELP {} {}\n# TYPE {} {}\n", f->name, f->help,
+						   f->name, typeName(f->type));
+
+		for (const auto& s : f->series)
+		{
+			if (f->type != Type::kHistogram)
+			{
+				out.append(f->name);
+				appendLabels(&out, s.labels);
+				if (s.fn)
+				{
+					out += std::format(" {}\n", s.fn());
+				}
+				else if (f->type == Type::kGauge)
+				{
+					out += std::format(" {}\n",
+									   static_cast<int64_t>(total(s.slot)));
+				}
+				else
+				{
+					out += std::format(" {}\n", total(s.slot));
+				}
+				continue;
+			}
+
+			// 桶按上界累加输出
+			size_t n = f->bounds.size();
+			uint64_t cumulative = 0;
+			for (size_t i = 0; i <= n; ++i)
+			{
+				cumulative += total(s.slot + i);
+				out.append(f->name);
+				out.append("_bucket");
+				appendLabels(&out, s.labels, "le",
+							 i < n ? std::format("{}", f->bounds[i]) : "+Inf");
+				out += std::format(" {}\n", cumulative);
+			}
+
+			// sum 按 double 存放，各分片分别转换后相加
+			double sum = 0;
+			for (Shard* shard : shards_)
+			{
+				sum += std::bit_cast<double>(shard->read(s.slot + n + 2));
+			}
+			sum += std::bit_cast<double>(retired_.read(s.slot + n + 2));
+
+			out.append(f->name);
+			out.append("_sum");
+			appendLabels(&out, s.labels);
+			out += std::format(" {}\n", sum);
+			out.append(f->name);
+			out.append("_count");
+			appendLabels(&out, s.labels);
+			out += std::format(" {}\n", total(s.slot + n + 1));
+		}
+	}
+	return out;
+}
+
+std::string Registry::merge(const std::vector<std::string>& scrapes,
+						   bool drop_gauges)
+{
+	struct Merged
+	{
+		std::string header; // HELP 与 TYPE 行
+		bool gauge = false;
+		std::vector<std::string> keys; // 首次出现的顺序
+	};
+	std::vector<Merged> families;
+	std::map<std::string, size_t, std::less<>> family_index;
+	std::map<std::string, double, std::less<>> values;
+
+	for (const std::string& text : scrapes)
+	{
+		Merged* current = nullptr;
+		std::string_view rest(text);
+		while (!rest.empty())
+		{
+			size_t eol = rest.find('\n');
+			std::string_view line = rest.substr(0, eol);
+			rest.remove_prefix(eol == std::string_view::npos ? rest.size()
+															 : eol + 1);
+			if (line.empty())
+			{
+				continue;
+			}
+
+			if (line.starts_with("# HELP "))
+			{
+				std::string_view name = line.substr(7);
+				name = name.substr(0, name.find(' '));
+				auto it = family_index.find(name);
+				if (it == family_index.end())
+				{
+					it = family_index
+							 .emplace(std::string(name), families.size())
+							 .first;
+					families.emplace_back();
+					families.back().header.append(line).append("\n");
+				}
+				current = &families[it->second];
+				continue;
+			}
+			if (line.starts_with("# TYPE "))
+			{
+				if (current && current->header.find("# TYPE ") ==
+								   std::string::npos)
+				{
+					current->header.append(line).append("\n");
+					current->gauge = line.ends_with(" gauge");
+				}
+				continue;
+			}
+			if (line[0] == '#' || !current ||
+				(drop_gauges && current->gauge))
+			{
+				continue;
+			}
+
+			size_t sp = line.rfind(' ');
+			if (sp == std::string_view::npos)
+			{
+				continue;
+			}
+			std::string_view key = line.substr(0, sp);
+			double v = std::strtod(std::string(line.substr(sp + 1)).c_str(),
+								   nullptr);
+			auto it = values.find(key);
+			if (it == values.end())
+			{
+				values.emplace(std::string(key), v);
+				current->keys.emplace_back(key);
+			}
+			else
+			{
+				it->second += v;
+			}
+		}
+	}
+
+	std::string out;
+	out.reserve(4096);
+	for (const Merged& f : families)
+	{
+		if (f.keys.empty() && drop_gauges)
+		{
+			continue;
+		}
+		out += f.header;
+		for (const std::string& key : f.keys)
+		{
+			out += std::format("{} {}\n", key, values.find(key)->second);
+		}
+	}
+	return out;
+}
+
+Registry::Family* Registry::family(const std::string& name,
+								   const std::string& help, Type type)
+{
+	auto it = by_name_.find(name);
+	if (it != by_name_.end())
+	{
+		if (it->second->type != type)
+		{
+			throw std::logic_error("metrics: " + name +
+								   " registered with another type");
+		}
+		return it->second;
+	}
+
+	families_.push_back(
+		std::make_unique<Family>(Family{name, help, type, {}, {}}));
+	by_name_.emplace(name, families_.back().get());
+	return families_.back().get();
+}
+
+Registry::Series& Registry::series(Family* family, const Labels& labels,
+								   uint32_t width)
+{
+	for (auto& s : family->series)
+	{
+		if (s.labels == labels)
+		{
+			return s;
+		}
+	}
+
+	// 在注册时检查容量，更新路径上不再检查
+	if (next_slot_ + width > Shard::kMaxSlots)
+	{
+		throw std::length_error("metrics: too many series");
+	}
+	family->series.push_back(Series{labels, next_slot_, nullptr});
+	next_slot_ += width;
+	return family->series.back();
+}
+
+uint64_t Registry::total(uint32_t slot) const
+{
+	uint64_t sum = retired_.read(slot);
+	for (Shard* shard : shards_)
+	{
+		sum += shard->read(slot);
+	}
+	return sum;
+}
+
+void Registry::attachShard(Shard* shard)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	shards_.push_back(shard);
+}
+
+void Registry::detachShard(Shard* shard)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	std::erase(shards_, shard);
+
+	// 普通值按整数累加，histogram 的 sum 按 double 累加
+	for (const auto& f : families_)
+	{
+		for (const auto& s : f->series)
+		{
+			if (s.fn)
+			{
+				continue;
+			}
+			uint32_t width =
+				f->type == Type::kHistogram ? f->bounds.size() + 3 : 1;
+			for (uint32_t i = 0; i < width; ++i)
+			{
+				uint32_t slot = s.slot + i;
+				if (f->type == Type::kHistogram && i == width - 1)
+				{
+					double v = std::bit_cast<double>(retired_.read(slot)) +
+							   std::bit_cast<double>(shard->read(slot));
+					retired_.cell(slot).store(std::bit_cast<uint64_t>(v),
+											  std::memory_order_relaxed);
+				}
+				else
+				{
+					retired_.add(slot, shard->read(slot));
+				}
+			}
+		}
+	}
+}
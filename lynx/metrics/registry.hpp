@@ -0,0 +1,248 @@
+#ifndef LYNX_METRICS_REGISTRY_HPP
+#define LYNX_METRICS_REGISTRY_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace metrics
+{
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// 每个线程一个分片，按 slot 下标存放各指标的值。分片只由所属线程写入，
+// 因此用 relaxed 的 load + store 代替 fetch_add，x86 上就是普通的 mov，
+// 热路径上没有带 lock 前缀的指令；采集线程只做 relaxed load
+class Shard : public base::noncopyable
+{
+  public:
+	static constexpr size_t kChunkBits = 10;
+	static constexpr size_t kChunkSize = 1 << kChunkBits;
+	static constexpr size_t kMaxChunks = 256;
+	static constexpr size_t kMaxSlots = kChunkSize * kMaxChunks;
+
+  private:
+	struct Chunk
+	{
+		std::atomic<uint64_t> cells[kChunkSize] = {};
+	};
+
+	std::atomic<Chunk*> chunks_[kMaxChunks];
+
+	// 常量初始化，其他翻译单元访问时不经过 TLS 包装函数
+	static inline thread_local Shard* local_ = nullptr;
+
+  public:
+	Shard();
+	~Shard();
+
+	static Shard& local()
+	{
+		if (!local_) [[unlikely]]
+		{
+			local_ = attach();
+		}
+		return *local_;
+	}
+
+	std::atomic<uint64_t>& cell(uint32_t slot)
+	{
+		Chunk* chunk =
+			chunks_[slot >> kChunkBits].load(std::memory_order_relaxed);
+		if (!chunk) [[unlikely]]
+		{
+			chunk = grow(slot >> kChunkBits);
+		}
+		return chunk->cells[slot & (kChunkSize - 1)];
+	}
+
+	void add(uint32_t slot, uint64_t n)
+	{
+		std::atomic<uint64_t>& c = cell(slot);
+		c.store(c.load(std::memory_order_relaxed) + n,
+				std::memory_order_relaxed);
+	}
+
+	// 采集线程调用，未分配的块视为 0
+	uint64_t read(uint32_t slot) const
+	{
+		Chunk* chunk =
+			chunks_[slot >> kChunkBits].load(std::memory_order_acquire);
+		return chunk ? chunk->cells[slot & (kChunkSize - 1)].load(
+						   std::memory_order_relaxed)
+					 : 0;
+	}
+
+  private:
+	struct Holder;
+
+	Chunk* grow(size_t idx);
+	static Shard* attach();
+};
+
+class Counter
+{
+  private:
+	uint32_t slot_;
+
+  public:
+	explicit Counter(uint32_t slot = 0) : slot_(slot)
+	{
+	}
+
+	void inc(uint64_t n = 1) const
+	{
+		Shard::local().add(slot_, n);
+	}
+};
+
+// 各线程分别累加增量，采集时求和，因此 add 与 sub 可以发生在不同线程
+class Gauge
+{
+  private:
+	uint32_t slot_;
+
+  public:
+	explicit Gauge(uint32_t slot = 0) : slot_(slot)
+	{
+	}
+
+	void add(int64_t n = 1) const
+	{
+		Shard::local().add(slot_, static_cast<uint64_t>(n));
+	}
+
+	void sub(int64_t n = 1) const
+	{
+		add(-n);
+	}
+};
+
+// 占用 bounds.size() + 3 个 slot：各桶（含 +Inf）、count、sum
+class Histogram
+{
+  private:
+	uint32_t slot_;
+	const std::vector<double>* bounds_;
+
+  public:
+	Histogram() : slot_(0), bounds_(nullptr)
+	{
+	}
+
+	Histogram(uint32_t slot, const std::vector<double>* bounds)
+		: slot_(slot), bounds_(bounds)
+	{
+	}
+
+	void observe(double v) const
+	{
+		if (!bounds_)
+		{
+			return;
+		}
+		Shard& shard = Shard::local();
+		size_t n = bounds_->size();
+		size_t i = std::lower_bound(bounds_->begin(), bounds_->end(), v) -
+				   bounds_->begin();
+		shard.add(slot_ + i, 1);
+		shard.add(slot_ + n + 1, 1);
+
+		std::atomic<uint64_t>& sum = shard.cell(slot_ + n + 2);
+		double old = std::bit_cast<double>(sum.load(std::memory_order_relaxed));
+		sum.store(std::bit_cast<uint64_t>(old + v), std::memory_order_relaxed);
+	}
+};
+
+// 进程内唯一的指标注册表。注册按 name + labels 去重，重复注册返回同一个指标，
+// 注册与采集加锁，更新只写当前线程的分片
+class Registry : public base::noncopyable
+{
+  public:
+	enum class Type
+	{
+		kCounter,
+		kGauge,
+		kHistogram
+	};
+
+  private:
+	struct Series
+	{
+		Labels labels;
+		uint32_t slot;
+		std::function<double()> fn; // 回调型 gauge
+	};
+
+	struct Family
+	{
+		std::string name;
+		std::string help;
+		Type type;
+		std::vector<double> bounds;
+		std::vector<Series> series;
+	};
+
+	mutable std::mutex mtx_;
+	std::vector<std::unique_ptr<Family>> families_; // 按注册顺序输出
+	std::map<std::string, Family*, std::less<>> by_name_;
+	uint32_t next_slot_;
+
+	std::vector<Shard*> shards_;
+	Shard retired_; // 已退出线程的累计值
+
+	Registry();
+
+  public:
+	static Registry& instance();
+
+	Counter counter(const std::string& name, const std::string& help,
+					const Labels& labels = {});
+	Gauge gauge(const std::string& name, const std::string& help,
+				const Labels& labels = {});
+	// bounds 须升序；同名指标沿用第一次注册的 bounds
+	Histogram histogram(const std::string& name, const std::string& help,
+						std::vector<double> bounds, const Labels& labels = {});
+	// fn 在采集线程中持锁调用，不能再访问 Registry
+	void gaugeCallback(const std::string& name, const std::string& help,
+					   std::function<double()> fn, const Labels& labels = {});
+
+	// Prometheus 文本格式（version 0.0.4）
+	std::string scrape() const;
+
+	// 合并多个进程的 scrape 输出，同名同标签的样本相加；drop_gauges 时
+	// 只保留 counter 与直方图，用于累计已退出进程的值
+	static std::string merge(const std::vector<std::string>& scrapes,
+							 bool drop_gauges = false);
+
+	// 以秒为单位的请求耗时分桶
+	static std::vector<double> latencyBuckets()
+	{
+		return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+				0.1,	0.25,  0.5,	   1,	  2.5,	 5,		10};
+	}
+
+  private:
+	friend class Shard;
+
+	Family* family(const std::string& name, const std::string& help, Type type);
+	Series& series(Family* family, const Labels& labels, uint32_t width);
+	uint64_t total(uint32_t slot) const; // 须持有 mtx_
+
+	void attachShard(Shard* shard);
+	void detachShard(Shard* shard);
+};
+} // namespace metrics
+} // namespace lynx
+
+#endif
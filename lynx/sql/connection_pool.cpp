@@ -20,6 +20,18 @@ ConnectionPool::ConnectionPool(const std::string& ip, uint16_t port,
 	  min_conn_num_(min_conn_num), max_conn_num_(max_conn_num),
 	  cur_conn_num_(0), stop_(false)
 {
+	metrics::Registry& registry = metrics::Registry::instance();
+	metrics::Labels labels = {{"pool", ip_ + ":" + std::to_string(port_)}};
+	waits_metric_ = registry.counter(
+		"lynx_sql_pool_waits_total",
+		"Connection requests that waited for a free connection", labels);
+	timeouts_metric_ = registry.counter(
+		"lynx_sql_pool_timeouts_total",
+		"Connection requests that timed out waiting", labels);
+	wait_seconds_metric_ = registry.histogram(
+		"lynx_sql_pool_wait_seconds", "Time spent waiting for a connection",
+		metrics::Registry::latencyBuckets(), labels);
+
 	for (size_t i = 0; i < min_conn_num_; i++)
 	{
 		Session* sess = createSession();
@@ -80,9 +92,17 @@ std::shared_ptr<Session> ConnectionPool::connection()
 
 		if (cur_conn_num_ >= max_conn_num_)
 		{
-			if (cv_.wait_for(lock, std::chrono::milliseconds(500)) ==
-				std::cv_status::timeout)
+			waits_metric_.inc();
+			auto start = std::chrono::steady_clock::now();
+			std::cv_status status =
+				cv_.wait_for(lock, std::chrono::milliseconds(500));
+			std::chrono::duration<double> waited =
+				std::chrono::steady_clock::now() - start;
+			wait_seconds_metric_.observe(waited.count());
+
+			if (status == std::cv_status::timeout)
 			{
+				timeouts_metric_.inc();
 				LOG_WARN << "MySQL Connection Pool busy/timeout";
 				return nullptr;
 			}
@@ -2,6 +2,7 @@
 #define LYNX_SQL_CONNECTION_POOL_HPP
 
 #include "lynx/base/noncopyable.hpp"
+#include "lynx/metrics/registry.hpp"
 #include "lynx/tcp/inet_addr.hpp"
 #include <atomic>
 #include <condition_variable>
@@ -38,6 +39,11 @@ class ConnectionPool : public base::noncopyable
 	uint32_t min_conn_num_;
 	uint32_t max_conn_num_;
 
+	// 连接数达到上限时的等待
+	metrics::Counter waits_metric_;
+	metrics::Counter timeouts_metric_;
+	metrics::Histogram wait_seconds_metric_;
+
   public:
 	ConnectionPool(const std::string& ip, uint16_t port,
 				   const std::string& user, const std::string& pass,
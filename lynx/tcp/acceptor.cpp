@@ -9,11 +9,45 @@
 #include <cstring>
 #include <fcntl.h>
 #include <memory>
+#include <sys/stat.h>
 #include <unistd.h>
 
 using namespace lynx;
 using namespace lynx::tcp;
 
+namespace
+{
+bool onFilesystem(const InetAddr& addr)
+{
+	return addr.isUnix() && !addr.path().empty() && addr.path()[0] != '@';
+}
+
+// 进程异常退出后残留的套接字文件会使 bind 失败；仍有进程在监听时保留
+void removeStaleSocket(const InetAddr& addr)
+{
+	std::string path = addr.path();
+	struct stat st;
+	if (::lstat(path.c_str(), &st) == -1 || !S_ISSOCK(st.st_mode))
+	{
+		return;
+	}
+
+	int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd == -1)
+	{
+		return;
+	}
+	bool refused = ::connect(fd, addr.sockaddr(), addr.length()) == -1 &&
+				   errno == ECONNREFUSED;
+	::close(fd);
+	if (refused)
+	{
+		LOG_INFO << "remove stale unix socket " << path;
+		::unlink(path.c_str());
+	}
+}
+} // namespace
+
 Acceptor::Acceptor(EventLoop* loop, const InetAddr& local_addr)
 	: loop_(loop), addr_(local_addr), listening_(false), idle_fd_(-1)
 {
@@ -24,10 +58,21 @@ Acceptor::Acceptor(EventLoop* loop, const InetAddr& local_addr)
 	}
 
 	int saved_errno = 0;
-	int fd = Socket::socket(&saved_errno);
+	int fd = Socket::socket(&saved_errno, local_addr.family());
 	checkErrno(saved_errno);
 
-	Socket::setReuseAddr(fd);
+	if (onFilesystem(local_addr))
+	{
+		removeStaleSocket(local_addr);
+	}
+	else if (!local_addr.isUnix())
+	{
+		Socket::setReuseAddr(fd);
+	}
+	if (local_addr.isIpv6())
+	{
+		Socket::setIpv6Only(fd, false);
+	}
 	Socket::bind(fd, local_addr, &saved_errno);
 	checkErrno(saved_errno);
 
@@ -35,8 +80,34 @@ Acceptor::Acceptor(EventLoop* loop, const InetAddr& local_addr)
 	ch_->setReadCallback(std::bind(&Acceptor::handleRead, this));
 }
 
+Acceptor::Acceptor(EventLoop* loop, int listen_fd)
+	: loop_(loop), listening_(false), idle_fd_(-1)
+{
+	idle_fd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+	if (idle_fd_ == -1)
+	{
+		LOG_WARN << "open /dev/null failed: " << ::strerror(errno);
+	}
+
+	socklen_t len = InetAddr::capacity();
+	if (::getsockname(listen_fd, addr_.sockaddr(), &len) == 0)
+	{
+		addr_.setLength(len);
+	}
+	Socket::setNonBlocking(listen_fd);
+
+	ch_ = std::make_unique<Channel>(listen_fd, loop);
+	ch_->setReadCallback(std::bind(&Acceptor::handleRead, this));
+}
+
 Acceptor::~Acceptor()
 {
+	// 监听 fd 已交给其他进程（stop 之后）时文件仍在使用，不能删除
+	if (listening_ && onFilesystem(addr_))
+	{
+		::unlink(addr_.path().c_str());
+	}
+
 	if (idle_fd_ != -1)
 	{
 		::close(idle_fd_);
@@ -59,6 +130,23 @@ void Acceptor::listen()
 	ch_->enableIN();
 }
 
+void Acceptor::stop()
+{
+	loop_->assertInLoopThread();
+	if (ch_->fd() == -1)
+	{
+		return;
+	}
+
+	listening_ = false;
+	if (ch_->inEpoll())
+	{
+		ch_->disableAll();
+		ch_->remove();
+	}
+	Socket::close(ch_->releaseFd());
+}
+
 int Acceptor::fd() const
 {
 	return ch_->fd();
@@ -24,6 +24,8 @@ class Acceptor : base::noncopyable
 
   public:
 	Acceptor(EventLoop* loop, const InetAddr& local_addr);
+	// 接管已绑定（可能已在监听）的 fd，如从旧进程继承的监听套接字
+	Acceptor(EventLoop* loop, int listen_fd);
 	~Acceptor();
 
 	void setNewConnectionCallback(std::function<void(int, const InetAddr&)> cb)
@@ -37,6 +39,8 @@ class Acceptor : base::noncopyable
 	}
 
 	void listen();
+	// 停止 accept 并关闭监听 fd；fd 已交给其他进程时监听套接字仍然有效
+	void stop();
 
 	int fd() const;
 
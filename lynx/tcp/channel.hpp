@@ -150,6 +150,11 @@ class Channel : public base::noncopyable
 		return events_ & EPOLLOUT;
 	}
 
+	bool reading() const
+	{
+		return events_ & EPOLLIN;
+	}
+
 	void setReadCallback(std::function<void()> cb)
 	{
 		read_callback_ = std::move(cb);
@@ -0,0 +1,134 @@
+#include "lynx/tcp/client.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/connector.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include <functional>
+#include <memory>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+Client::Client(EventLoop* loop, const InetAddr& serv_addr,
+			   const std::string& name)
+	: loop_(loop), connector_(std::make_shared<Connector>(loop, serv_addr)),
+	  name_(name), retry_(false), connect_(false), seq_(0)
+{
+	connector_->setNewConnectionCallback(
+		std::bind(&Client::handleNewConnection, this, std::placeholders::_1));
+}
+
+Client::~Client()
+{
+	LOG_TRACE << "Client::~Client [" << name_ << "]";
+
+	std::shared_ptr<Connection> conn;
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		conn = conn_;
+	}
+
+	if (conn)
+	{
+		// Client 即将析构，关闭回调不能再指向 this
+		loop_->runInLoop(
+			[conn]()
+			{
+				conn->setCloseCallback(
+					[](const std::shared_ptr<Connection>& c)
+					{
+						c->loop()->queueInLoop(
+							std::bind(&Connection::connDestroy, c));
+					});
+			});
+		conn->forceClose();
+	}
+	else
+	{
+		connector_->stop();
+	}
+}
+
+void Client::connect()
+{
+	LOG_INFO << "Client::connect [" << name_ << "] - connecting to "
+			 << connector_->servAddr().toFormattedString();
+	connect_.store(true, std::memory_order_release);
+	connector_->start();
+}
+
+void Client::disconnect()
+{
+	connect_.store(false, std::memory_order_release);
+
+	std::lock_guard<std::mutex> lock(mtx_);
+	if (conn_)
+	{
+		conn_->shutdown();
+	}
+}
+
+void Client::stop()
+{
+	connect_.store(false, std::memory_order_release);
+	connector_->stop();
+}
+
+void Client::setConnectTimeout(double seconds)
+{
+	connector_->setConnectTimeout(seconds);
+}
+
+void Client::setMaxRetries(int max_retries)
+{
+	connector_->setMaxRetries(max_retries);
+}
+
+void Client::setConnectFailedCallback(std::function<void()> cb)
+{
+	connector_->setConnectFailedCallback(std::move(cb));
+}
+
+void Client::handleNewConnection(int conn_fd)
+{
+	loop_->assertInLoopThread();
+
+	std::shared_ptr<Connection> conn = std::make_shared<Connection>(
+		conn_fd, loop_, connector_->servAddr(), ++seq_);
+
+	conn->setConnectCallback(connect_callback_);
+	conn->setMessageCallback(message_callback_);
+	conn->setWriteCompleteCallback(write_complete_callback_);
+	conn->setCloseCallback(
+		std::bind(&Client::handleClose, this, std::placeholders::_1));
+
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		conn_ = conn;
+	}
+
+	conn->connEstablish();
+}
+
+void Client::handleClose(const std::shared_ptr<Connection>& conn)
+{
+	loop_->assertInLoopThread();
+	assert(loop_ == conn->loop());
+
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		assert(conn_ == conn);
+		conn_.reset();
+	}
+
+	loop_->queueInLoop(std::bind(&Connection::connDestroy, conn));
+
+	if (retry_.load(std::memory_order_acquire) &&
+		connect_.load(std::memory_order_acquire))
+	{
+		LOG_INFO << "Client::handleClose [" << name_ << "] - reconnecting to "
+				 << connector_->servAddr().toFormattedString();
+		connector_->restart();
+	}
+}
@@ -0,0 +1,100 @@
+#ifndef LYNX_TCP_CLIENT_HPP
+#define LYNX_TCP_CLIENT_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class Connector;
+class Connection;
+class Buffer;
+class Client : public base::noncopyable
+{
+  private:
+	EventLoop* loop_;
+	std::shared_ptr<Connector> connector_;
+	const std::string name_;
+	std::atomic<bool> retry_;
+	std::atomic<bool> connect_;
+	uint64_t seq_;
+
+	mutable std::mutex mtx_;
+	std::shared_ptr<Connection> conn_; // guarded by mutex
+
+	std::function<void(const std::shared_ptr<Connection>&)> connect_callback_;
+	std::function<void(const std::shared_ptr<Connection>&, Buffer*)>
+		message_callback_;
+	std::function<void(const std::shared_ptr<Connection>&)>
+		write_complete_callback_;
+
+  public:
+	Client(EventLoop* loop, const InetAddr& serv_addr, const std::string& name);
+	~Client();
+
+	void connect();
+	void disconnect();
+	void stop();
+
+	std::shared_ptr<Connection> connection() const
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		return conn_;
+	}
+
+	EventLoop* loop() const
+	{
+		return loop_;
+	}
+
+	const std::string& name() const
+	{
+		return name_;
+	}
+
+	// 连接断开后自动重连
+	void enableRetry(bool on = true)
+	{
+		retry_.store(on, std::memory_order_release);
+	}
+
+	void setConnectTimeout(double seconds);
+	void setMaxRetries(int max_retries);
+
+	void setConnectionCallback(
+		std::function<void(const std::shared_ptr<Connection>&)> cb)
+	{
+		connect_callback_ = std::move(cb);
+	}
+
+	void setMessageCallback(
+		std::function<void(const std::shared_ptr<Connection>&, Buffer*)> cb)
+	{
+		message_callback_ = std::move(cb);
+	}
+
+	void setWriteCompleteCallback(
+		std::function<void(const std::shared_ptr<Connection>&)> cb)
+	{
+		write_complete_callback_ = std::move(cb);
+	}
+
+	void setConnectFailedCallback(std::function<void()> cb);
+
+  private:
+	void handleNewConnection(int conn_fd);
+	void handleClose(const std::shared_ptr<Connection>& conn);
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
@@ -0,0 +1,228 @@
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/connector.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+namespace
+{
+void discardMessage(const std::shared_ptr<Connection>&, Buffer* buf)
+{
+	buf->retrieve(buf->readableBytes());
+}
+
+// 空闲连接上不应出现数据，出现则说明对端状态异常，直接关闭
+void unexpectedMessage(const std::shared_ptr<Connection>& conn, Buffer* buf)
+{
+	LOG_WARN << "unexpected data on idle upstream connection "
+			 << conn->addr().toFormattedString();
+	buf->retrieve(buf->readableBytes());
+	conn->forceClose();
+}
+} // namespace
+
+ClientPool::ClientPool(EventLoop* loop)
+	: loop_(loop), seq_(0), connect_timeout_(3.0), max_retries_(2),
+	  max_idle_per_key_(32), idle_timeout_(60.0),
+	  alive_(std::make_shared<bool>(true))
+{
+	std::weak_ptr<bool> guard = alive_;
+	loop_->runEvery(1.0,
+					[this, guard]()
+					{
+						if (!guard.expired())
+						{
+							evictIdle();
+						}
+					});
+}
+
+ClientPool::~ClientPool()
+{
+	// 可能在 loop 析构之后（线程退出时）才被销毁，这里不能再访问 loop_
+	for (auto& item : connectors_)
+	{
+		item.second->setNewConnectionCallback(nullptr);
+		item.second->setConnectFailedCallback(nullptr);
+	}
+
+	for (auto& item : conns_)
+	{
+		item.second->setCloseCallback(nullptr);
+		item.second->setConnectCallback(nullptr);
+		item.second->setMessageCallback(nullptr);
+	}
+}
+
+ClientPool* ClientPool::local(EventLoop* loop)
+{
+	loop->assertInLoopThread();
+	thread_local std::unique_ptr<ClientPool> pool;
+	if (!pool)
+	{
+		pool = std::make_unique<ClientPool>(loop);
+	}
+	assert(pool->loop() == loop);
+	return pool.get();
+}
+
+void ClientPool::acquire(const InetAddr& addr, acquire_callback cb)
+{
+	loop_->assertInLoopThread();
+
+	auto it = idle_conns_.find(addr.toFormattedString());
+	if (it != idle_conns_.end())
+	{
+		// LIFO：最近归还的连接最不可能已被对端超时关闭
+		while (!it->second.empty())
+		{
+			std::shared_ptr<Connection> conn = std::move(it->second.back().conn);
+			it->second.pop_back();
+			if (conn->connected())
+			{
+				conn->setMessageCallback(discardMessage);
+				cb(conn);
+				return;
+			}
+		}
+	}
+
+	auto connector = std::make_shared<Connector>(loop_, addr);
+	connector->setConnectTimeout(connect_timeout_);
+	connector->setMaxRetries(max_retries_);
+	connector->setNewConnectionCallback(
+		[this, addr, cb, raw = connector.get()](int conn_fd)
+		{
+			removeConnector(raw);
+			handleNewConnection(conn_fd, addr, cb);
+		});
+	connector->setConnectFailedCallback(
+		[this, cb, raw = connector.get()]()
+		{
+			removeConnector(raw);
+			cb(nullptr);
+		});
+
+	connectors_[connector.get()] = connector;
+	connector->start();
+}
+
+void ClientPool::release(const std::shared_ptr<Connection>& conn)
+{
+	loop_->assertInLoopThread();
+	assert(conn->loop() == loop_);
+
+	if (!conn->connected())
+	{
+		return;
+	}
+
+	conn->setConnectCallback(nullptr);
+	conn->setWriteCompleteCallback(nullptr);
+	conn->setFlushCallback(nullptr);
+	conn->startRead();
+
+	std::vector<IdleConn>& idle = idle_conns_[conn->addr().toFormattedString()];
+	if (idle.size() >= max_idle_per_key_)
+	{
+		conn->shutdown();
+		return;
+	}
+
+	conn->setMessageCallback(unexpectedMessage);
+	idle.push_back({conn, time::TimeStamp::now()});
+}
+
+size_t ClientPool::idleSize() const
+{
+	size_t n = 0;
+	for (const auto& item : idle_conns_)
+	{
+		n += item.second.size();
+	}
+	return n;
+}
+
+void ClientPool::handleNewConnection(int conn_fd, const InetAddr& addr,
+									 const acquire_callback& cb)
+{
+	loop_->assertInLoopThread();
+
+	std::shared_ptr<Connection> conn =
+		std::make_shared<Connection>(conn_fd, loop_, addr, ++seq_);
+	conn->setMessageCallback(discardMessage);
+	conn->setCloseCallback(
+		std::bind(&ClientPool::handleClose, this, std::placeholders::_1));
+
+	conns_[conn->id()] = conn;
+	conn->connEstablish();
+
+	LOG_DEBUG << "ClientPool: new upstream connection to "
+			  << addr.toFormattedString();
+	cb(conn);
+}
+
+void ClientPool::handleClose(const std::shared_ptr<Connection>& conn)
+{
+	loop_->assertInLoopThread();
+
+	removeIdle(conn);
+	conns_.erase(conn->id());
+	loop_->queueInLoop(std::bind(&Connection::connDestroy, conn));
+}
+
+void ClientPool::removeConnector(Connector* connector)
+{
+	auto it = connectors_.find(connector);
+	if (it != connectors_.end())
+	{
+		// 正处于 connector 自身的回调中，延后释放
+		loop_->queueInLoop([holder = std::move(it->second)]() {});
+		connectors_.erase(it);
+	}
+}
+
+void ClientPool::removeIdle(const std::shared_ptr<Connection>& conn)
+{
+	auto it = idle_conns_.find(conn->addr().toFormattedString());
+	if (it == idle_conns_.end())
+	{
+		return;
+	}
+
+	std::erase_if(it->second, [&conn](const IdleConn& idle)
+				  { return idle.conn == conn; });
+}
+
+void ClientPool::evictIdle()
+{
+	time::TimeStamp now = time::TimeStamp::now();
+	std::vector<std::shared_ptr<Connection>> expired;
+
+	for (auto& item : idle_conns_)
+	{
+		std::erase_if(item.second,
+					  [&](const IdleConn& idle)
+					  {
+						  if (time::TimeStamp::addTime(idle.since,
+													   idle_timeout_) < now)
+						  {
+							  expired.push_back(idle.conn);
+							  return true;
+						  }
+						  return false;
+					  });
+	}
+
+	for (auto& conn : expired)
+	{
+		conn->forceClose();
+	}
+}
@@ -0,0 +1,105 @@
+#ifndef LYNX_TCP_CLIENT_POOL_HPP
+#define LYNX_TCP_CLIENT_POOL_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class Connection;
+class Connector;
+// 每个 EventLoop 一个，只在所属 loop 线程中使用，因此无需加锁
+class ClientPool : public base::noncopyable
+{
+  public:
+	using acquire_callback =
+		std::function<void(const std::shared_ptr<Connection>&)>;
+
+  private:
+	struct IdleConn
+	{
+		std::shared_ptr<Connection> conn;
+		time::TimeStamp since;
+	};
+
+	EventLoop* loop_;
+	uint64_t seq_;
+
+	double connect_timeout_;
+	int max_retries_;
+	size_t max_idle_per_key_;
+	double idle_timeout_;
+
+	// key: "ip:port"
+	std::unordered_map<std::string, std::vector<IdleConn>> idle_conns_;
+	std::unordered_map<uint64_t, std::shared_ptr<Connection>> conns_;
+	std::unordered_map<Connector*, std::shared_ptr<Connector>> connectors_;
+
+	std::shared_ptr<bool> alive_;
+
+  public:
+	explicit ClientPool(EventLoop* loop);
+	~ClientPool();
+
+	// 当前线程所属 loop 的连接池
+	static ClientPool* local(EventLoop* loop);
+
+	// 有空闲连接则直接复用，否则发起非阻塞连接；失败时回调参数为 nullptr
+	void acquire(const InetAddr& addr, acquire_callback cb);
+	// 归还一个可复用（keep-alive）的连接
+	void release(const std::shared_ptr<Connection>& conn);
+
+	void setConnectTimeout(double seconds)
+	{
+		connect_timeout_ = seconds;
+	}
+
+	void setMaxRetries(int max_retries)
+	{
+		max_retries_ = max_retries;
+	}
+
+	void setMaxIdlePerKey(size_t n)
+	{
+		max_idle_per_key_ = n;
+	}
+
+	void setIdleTimeout(double seconds)
+	{
+		idle_timeout_ = seconds;
+	}
+
+	size_t idleSize() const;
+
+	size_t size() const
+	{
+		return conns_.size();
+	}
+
+	EventLoop* loop() const
+	{
+		return loop_;
+	}
+
+  private:
+	void handleNewConnection(int conn_fd, const InetAddr& addr,
+							 const acquire_callback& cb);
+	void handleClose(const std::shared_ptr<Connection>& conn);
+	void removeConnector(Connector* connector);
+	void removeIdle(const std::shared_ptr<Connection>& conn);
+	void evictIdle();
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
@@ -1,10 +1,13 @@
 #include "lynx/tcp/connection.hpp"
 #include "lynx/logger/logger.hpp"
+#include "lynx/metrics/registry.hpp"
 #include "lynx/tcp/buffer.hpp"
 #include "lynx/tcp/channel.hpp"
 #include "lynx/tcp/event_loop.hpp"
 #include "lynx/tcp/inet_addr.hpp"
 #include "lynx/tcp/socket.hpp"
+#include "lynx/tcp/tls.hpp"
+#include <algorithm>
 #include <cerrno>
 #include <cstddef>
 #include <cstdint>
@@ -20,13 +23,27 @@ using namespace lynx::tcp;
 
 const size_t Connection::kMaxSendBytes = 16 * 1024; // 16 kB
 
+namespace
+{
+const metrics::Counter bytes_received_metric =
+	metrics::Registry::instance().counter("lynx_tcp_bytes_received_total",
+										  "Bytes read from TCP connections");
+const metrics::Counter bytes_sent_metric =
+	metrics::Registry::instance().counter("lynx_tcp_bytes_sent_total",
+										  "Bytes written to TCP connections");
+} // namespace
+
 Connection::Connection(int fd, EventLoop* loop, const InetAddr& addr,
 					   uint64_t id)
-	: loop_(loop), addr_(addr), id_(id), state_(State::kConnecting),
+	: state_(State::kConnecting), loop_(loop), addr_(addr), id_(id),
+	  created_(std::chrono::steady_clock::now()),
 	  high_water_mark_(64 * 1024 * 1024)
 {
-	Socket::setKeepAlive(fd);
-	Socket::setNoDelay(fd);
+	if (!addr.isUnix())
+	{
+		Socket::setKeepAlive(fd);
+		Socket::setNoDelay(fd);
+	}
 	ch_ = std::make_unique<Channel>(fd, loop);
 
 	ch_->setReadCallback(std::bind(&Connection::handleRead, this));
@@ -46,6 +63,20 @@ Connection::~Connection()
 	}
 }
 
+int Connection::fd() const
+{
+	return ch_->fd();
+}
+
+bool Connection::peerCredentials(struct ucred* cred) const
+{
+	if (!addr_.isUnix())
+	{
+		return false;
+	}
+	return Socket::peerCredentials(ch_->fd(), cred);
+}
+
 void Connection::send(const std::string& message)
 {
 	if (state_ == State::kConnected)
@@ -57,13 +88,27 @@ void Connection::send(const std::string& message)
 		}
 		else
 		{
-			loop_->runInLoop(std::bind(&Connection::sendInLoop,
-									   shared_from_this(), message));
+			loop_->runInLoop([self = shared_from_this(), message]()
+							 { self->sendInLoop(message); });
 		}
 	}
 }
 
+void Connection::send(const char* data, size_t len)
+{
+	loop_->assertInLoopThread();
+	if (state_ == State::kConnected)
+	{
+		sendInLoop(data, len);
+	}
+}
+
 void Connection::sendInLoop(const std::string& message)
+{
+	sendInLoop(message.data(), message.size());
+}
+
+void Connection::sendInLoop(const char* data, size_t len)
 {
 	loop_->assertInLoopThread();
 	if (state_ == State::kDisconnected)
@@ -71,24 +116,26 @@ void Connection::sendInLoop(const std::string& message)
 		return;
 	}
 
-	size_t remaining = message.size();
-	size_t n_wrote = 0;
+	size_t remaining = len;
+	ssize_t n_wrote = 0;
 	bool fault_error = false;
 
 	// 先调用write尝试发送，将剩余的数据存放至output buffer
-	if (!ch_->writing() && outbuf_->readableBytes() == 0)
+	if (!ch_->writing() && outbuf_->readableBytes() == 0 && writable())
 	{
-		n_wrote = ::write(ch_->fd(), message.data(), message.size());
+		int saved_errno = 0;
+		n_wrote = writeSome(data, len, &saved_errno);
 		if (n_wrote >= 0)
 		{
 			remaining -= n_wrote;
+			bytes_sent_metric.inc(n_wrote);
 		}
 		else
 		{
 			n_wrote = 0;
-			if (errno != EWOULDBLOCK && errno != EAGAIN)
+			if (saved_errno != EWOULDBLOCK && saved_errno != EAGAIN)
 			{
-				LOG_ERROR << "write failed: " << strerror(errno);
+				LOG_ERROR << "write failed: " << strerror(saved_errno);
 				handleError();
 				fault_error = true;
 			}
@@ -97,7 +144,7 @@ void Connection::sendInLoop(const std::string& message)
 
 	if (!fault_error && remaining > 0)
 	{
-		outbuf_->append(message.data() + n_wrote, remaining);
+		outbuf_->append(data + n_wrote, remaining);
 		if (!ch_->writing())
 		{
 			ch_->enableOUT();
@@ -139,11 +186,140 @@ void Connection::shutdownInLoop()
 
 	if (!ch_->writing())
 	{
+		if (tls_)
+		{
+			tls_->shutdown();
+		}
 		Socket::shutdown(ch_->fd());
 		LOG_INFO << "Server close write endside: " << addr_.toFormattedString();
 	}
 }
 
+void Connection::forceClose()
+{
+	if (state_ == State::kConnected || state_ == State::kDisconnecting)
+	{
+		state_ = State::kDisconnecting;
+		loop_->queueInLoop(
+			std::bind(&Connection::forceCloseInLoop, shared_from_this()));
+	}
+}
+
+void Connection::forceCloseInLoop()
+{
+	loop_->assertInLoopThread();
+	if (state_ == State::kConnected || state_ == State::kDisconnecting)
+	{
+		// 与对端主动关闭走同一条路径
+		handleClose();
+	}
+}
+
+void Connection::startRead()
+{
+	loop_->runInLoop(
+		std::bind(&Connection::startReadInLoop, shared_from_this()));
+}
+
+void Connection::stopRead()
+{
+	loop_->runInLoop(
+		std::bind(&Connection::stopReadInLoop, shared_from_this()));
+}
+
+void Connection::startReadInLoop()
+{
+	loop_->assertInLoopThread();
+	if (state_ != State::kDisconnected && !ch_->reading())
+	{
+		ch_->enableIN();
+	}
+}
+
+void Connection::stopReadInLoop()
+{
+	loop_->assertInLoopThread();
+	if (state_ != State::kDisconnected && ch_->reading())
+	{
+		ch_->disableIN();
+	}
+}
+
+size_t Connection::outputBytes() const
+{
+	return outbuf_->readableBytes();
+}
+
+size_t Connection::pendingBytes() const
+{
+	return outbuf_->readableBytes() +
+		   (file_fd_ != -1 ? file_bytes_to_send_ : 0);
+}
+
+size_t Connection::inputBytes() const
+{
+	return inbuf_->readableBytes();
+}
+
+void Connection::setDraining()
+{
+	loop_->assertInLoopThread();
+	draining_ = true;
+	if (drain_callback_)
+	{
+		std::function<void()> cb = std::move(drain_callback_);
+		drain_callback_ = nullptr;
+		cb();
+	}
+	if (!busy_ && inbuf_->readableBytes() == 0)
+	{
+		shutdown();
+	}
+}
+
+void Connection::setDrainCallback(std::function<void()> cb)
+{
+	loop_->assertInLoopThread();
+	if (draining_)
+	{
+		cb();
+		return;
+	}
+	drain_callback_ = std::move(cb);
+}
+
+void Connection::setBusy(bool on)
+{
+	busy_ = on;
+	if (!on && draining_)
+	{
+		shutdown();
+	}
+}
+
+void Connection::appendFlushCallback(std::function<void()> cb)
+{
+	if (!flush_callback_)
+	{
+		flush_callback_ = std::move(cb);
+		return;
+	}
+
+	flush_callback_ =
+		[this, prev = std::move(flush_callback_), cb = std::move(cb)]() mutable
+	{
+		prev();
+		if (flush_callback_)
+		{
+			appendFlushCallback(std::move(cb));
+		}
+		else
+		{
+			cb();
+		}
+	};
+}
+
 void Connection::connEstablish()
 {
 	loop_->assertInLoopThread();
@@ -234,7 +410,7 @@ void Connection::sendFileInLoop(const std::string& file_path)
 		ch_->enableOUT();
 	}
 
-	if (outbuf_->readableBytes() == 0)
+	if (outbuf_->readableBytes() == 0 && writable())
 	{
 		trySendFile();
 	}
@@ -247,17 +423,22 @@ void Connection::trySendFile()
 
 	while (file_bytes_to_send_ > 0)
 	{
-		ssize_t n =
-			::sendfile(ch_->fd(), file_fd_, &file_offset_,
-					   file_bytes_to_send_ < kMaxSendBytes ? file_bytes_to_send_
-														   : kMaxSendBytes);
-		if (n >= 0)
+		int saved_errno = 0;
+		ssize_t n = sendFileSome(std::min(file_bytes_to_send_, kMaxSendBytes),
+								 &saved_errno);
+		if (n > 0)
 		{
 			file_bytes_to_send_ -= n;
+			bytes_sent_metric.inc(n);
 		}
 		else
 		{
-			if (errno == EWOULDBLOCK || errno == EAGAIN)
+			if (n == 0)
+			{
+				// 文件在发送过程中被截短
+				saved_errno = EIO;
+			}
+			if (saved_errno == EWOULDBLOCK || saved_errno == EAGAIN)
 			{
 				if (!ch_->writing())
 				{
@@ -268,7 +449,7 @@ void Connection::trySendFile()
 			else
 			{
 				LOG_ERROR << "try send file failed - fd " << ch_->fd() << ": "
-						  << strerror(errno);
+						  << strerror(saved_errno);
 
 				::close(file_fd_);
 				file_fd_ = -1;
@@ -332,17 +513,44 @@ void Connection::handleClose()
 void Connection::handleRead()
 {
 	loop_->assertInLoopThread();
+	if (tls_ && !tls_->established() && !handleHandshake())
+	{
+		return;
+	}
+
 	int saved_errno = 0;
-	ssize_t n = inbuf_->readFd(ch_->fd(), &saved_errno);
+	ssize_t n =
+		tls_ ? readTls(&saved_errno) : inbuf_->readFd(ch_->fd(), &saved_errno);
 	if (n > 0)
 	{
-		message_callback_(shared_from_this(), inbuf_.get());
+		bytes_received_metric.inc(n);
+		if (message_callback_)
+		{
+			// 回调内可能重新设置 message callback（例如归还连接池），
+			// 先移出再调用，避免正在执行的函数对象被析构
+			auto cb = std::move(message_callback_);
+			cb(shared_from_this(), inbuf_.get());
+			if (!message_callback_)
+			{
+				message_callback_ = std::move(cb);
+			}
+		}
+		else
+		{
+			inbuf_->retrieve(inbuf_->readableBytes());
+		}
 		inbuf_->tryShrink();
 	}
 	else if (n == 0)
 	{
 		handleClose();
 	}
+	else if (tls_ && saved_errno != EAGAIN)
+	{
+		// TLS 记录损坏等错误无法恢复，继续读只会重复失败
+		handleError();
+		handleClose();
+	}
 	else
 	{
 		handleError();
@@ -352,22 +560,34 @@ void Connection::handleRead()
 void Connection::handleWrite()
 {
 	loop_->assertInLoopThread();
+	if (tls_ && !tls_->established() && !handleHandshake())
+	{
+		return;
+	}
 
 	if (ch_->writing())
 	{
 		if (outbuf_->readableBytes() > 0)
 		{
-			ssize_t n =
-				::write(ch_->fd(), outbuf_->peek(), outbuf_->readableBytes());
+			int saved_errno = 0;
+			ssize_t n = writeSome(outbuf_->peek(), outbuf_->readableBytes(),
+								  &saved_errno);
 			if (n > 0)
 			{
 				outbuf_->retrieve(n);
+				bytes_sent_metric.inc(n);
 			}
 			else
 			{
-				if (errno != EWOULDBLOCK && errno != EAGAIN)
+				if (saved_errno != EWOULDBLOCK && saved_errno != EAGAIN)
 				{
 					handleError();
+					if (tls_)
+					{
+						// SSL 写失败后连接不可再用
+						handleClose();
+						return;
+					}
 				}
 			}
 		}
@@ -386,6 +606,12 @@ void Connection::handleWrite()
 				loop_->queueInLoop(
 					std::bind(write_complete_callback_, shared_from_this()));
 			}
+			if (flush_callback_)
+			{
+				std::function<void()> cb = std::move(flush_callback_);
+				flush_callback_ = nullptr;
+				cb();
+			}
 			outbuf_->tryShrink();
 
 			if (state_ == State::kDisconnecting)
@@ -394,4 +620,125 @@ void Connection::handleWrite()
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+
+void Connection::startTls(const std::shared_ptr<TlsContext>& ctx,
+						  const std::string& server_name)
+{
+	if (tls_)
+	{
+		return;
+	}
+
+	tls_ = std::make_unique<TlsSession>(ctx, ch_->fd(), server_name,
+										addr_.toFormattedString());
+	// 客户端主动发出 ClientHello；服务端等待对端数据
+	if (state_ == State::kConnected && !ctx->isServer())
+	{
+		loop_->assertInLoopThread();
+		handleHandshake();
+	}
+}
+
+bool Connection::writable() const
+{
+	return !tls_ || tls_->established();
+}
+
+bool Connection::handleHandshake()
+{
+	switch (tls_->handshake())
+	{
+	case TlsSession::Result::kDone:
+		// 握手期间写入的数据留在 output buffer 中，现在可以发出
+		if (outbuf_->readableBytes() > 0 || file_fd_ != -1)
+		{
+			if (!ch_->writing())
+			{
+				ch_->enableOUT();
+			}
+		}
+		else if (ch_->writing())
+		{
+			ch_->disableOUT();
+		}
+		return true;
+	case TlsSession::Result::kWantRead:
+		if (ch_->writing())
+		{
+			ch_->disableOUT();
+		}
+		return false;
+	case TlsSession::Result::kWantWrite:
+		if (!ch_->writing())
+		{
+			ch_->enableOUT();
+		}
+		return false;
+	default:
+		handleClose();
+		return false;
+	}
+}
+
+ssize_t Connection::readTls(int* saved_errno)
+{
+	// 一次读尽已到达的记录：SSL 内部可能还缓存着明文，而 socket 已不可读
+	thread_local char buf[65536];
+	ssize_t total = 0;
+	while (true)
+	{
+		ssize_t n = tls_->read(buf, sizeof(buf), saved_errno);
+		if (n <= 0)
+		{
+			return total > 0 ? total : n;
+		}
+		inbuf_->append(buf, n);
+		total += n;
+	}
+}
+
+ssize_t Connection::writeSome(const char* data, size_t len, int* saved_errno)
+{
+	// kTLS 下内核负责加密，明文直接写入 socket
+	if (tls_ && !tls_->ktlsSend())
+	{
+		return tls_->write(data, len, saved_errno);
+	}
+
+	ssize_t n = ::write(ch_->fd(), data, len);
+	if (n < 0)
+	{
+		*saved_errno = errno;
+	}
+	return n;
+}
+
+ssize_t Connection::sendFileSome(size_t len, int* saved_errno)
+{
+	if (!tls_ || tls_->ktlsSend())
+	{
+		ssize_t n = ::sendfile(ch_->fd(), file_fd_, &file_offset_, len);
+		if (n < 0)
+		{
+			*saved_errno = errno;
+		}
+		return n;
+	}
+
+	// 用户态加密只能先读出文件。SSL_write 重试时要求数据不变，
+	// 偏移只在写出成功后前移，重试时从同一偏移读到的就是同一段数据
+	thread_local char buf[kMaxSendBytes];
+	ssize_t n = ::pread(file_fd_, buf, std::min(len, sizeof(buf)), file_offset_);
+	if (n <= 0)
+	{
+		*saved_errno = n < 0 ? errno : 0;
+		return n;
+	}
+	n = tls_->write(buf, n, saved_errno);
+	if (n > 0)
+	{
+		file_offset_ += n;
+	}
+	return n;
+}
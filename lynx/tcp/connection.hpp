@@ -4,10 +4,13 @@
 #include "lynx/base/noncopyable.hpp"
 #include "lynx/tcp/inet_addr.hpp"
 #include <any>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
+#include <sys/types.h>
 namespace lynx
 {
 namespace tcp
@@ -15,6 +18,8 @@ namespace tcp
 class Channel;
 class EventLoop;
 class Buffer;
+class TlsContext;
+class TlsSession;
 class Connection : public base::noncopyable,
 				   public std::enable_shared_from_this<Connection>
 {
@@ -36,10 +41,12 @@ class Connection : public base::noncopyable,
 	std::unique_ptr<Channel> ch_;
 	InetAddr addr_;
 	uint64_t id_;
+	std::chrono::steady_clock::time_point created_;
 
 	size_t high_water_mark_;
 	std::unique_ptr<Buffer> inbuf_;
 	std::unique_ptr<Buffer> outbuf_;
+	std::unique_ptr<TlsSession> tls_;
 
 	std::any ctx_;
 
@@ -47,6 +54,10 @@ class Connection : public base::noncopyable,
 	size_t file_bytes_to_send_{0};
 	off_t file_offset_{0};
 
+	// 服务端 drain 时置位；busy 表示有请求正在处理，由上层协议维护
+	bool draining_{false};
+	bool busy_{false};
+
 	std::function<void(const std::shared_ptr<Connection>&,
 					   Buffer*)>
 		message_callback_; // defined by user
@@ -62,12 +73,18 @@ class Connection : public base::noncopyable,
 	std::function<void(const std::shared_ptr<Connection>&, size_t)>
 		high_water_mark_callback_;
 
+	std::function<void()> flush_callback_; // one-shot
+	std::function<void()> drain_callback_; // one-shot
+
   public:
 	Connection(int fd, EventLoop* loop, const InetAddr& addr, uint64_t id);
 	~Connection();
 
 	int fd() const;
 
+	// 仅对 Unix 域连接有效：对端进程的 pid/uid/gid
+	bool peerCredentials(struct ucred* cred) const;
+
 	uint64_t id() const
 	{
 		return id_;
@@ -108,6 +125,12 @@ class Connection : public base::noncopyable,
 		return addr_;
 	}
 
+	// 对服务端连接即 accept 的时间
+	std::chrono::steady_clock::time_point createdTime() const
+	{
+		return created_;
+	}
+
 	void setMessageCallback(
 		std::function<void(const std::shared_ptr<Connection>&, Buffer*)> cb)
 	{
@@ -126,6 +149,12 @@ class Connection : public base::noncopyable,
 		connect_callback_ = std::move(cb);
 	}
 
+	const std::function<void(const std::shared_ptr<Connection>&)>&
+	connectCallback() const
+	{
+		return connect_callback_;
+	}
+
 	void setCloseCallback(
 		std::function<void(const std::shared_ptr<Connection>&)> cb)
 	{
@@ -145,7 +174,53 @@ class Connection : public base::noncopyable,
 	void setTcpNoDelay(bool on);
 
 	void send(const std::string& message);
+	// 仅限 loop 线程调用，直接写出或拷贝进 output buffer
+	void send(const char* data, size_t len);
 	void shutdown();
+	void forceClose();
+
+	// 暂停/恢复读事件，用于上下游之间的背压
+	void startRead();
+	void stopRead();
+
+	// output buffer 中尚未写出的字节数，只在 loop 线程中有意义
+	size_t outputBytes() const;
+
+	// output buffer 与待发送文件中尚未写出的字节数
+	size_t pendingBytes() const;
+	// input buffer 中尚未处理的字节数
+	size_t inputBytes() const;
+
+	// 以下只在 loop 线程中调用
+	bool draining() const
+	{
+		return draining_;
+	}
+
+	// drain 期间空闲（不 busy 且没有未处理的输入）的连接立即关闭，
+	// 否则在 setBusy(false) 时关闭
+	void setDraining();
+
+	// drain 开始时调用一次，供 WebSocket、SSE 等长期 busy 的连接
+	// 发出结束通知后清除 busy；已在 drain 中则立即调用
+	void setDrainCallback(std::function<void()> cb);
+
+	bool busy() const
+	{
+		return busy_;
+	}
+
+	void setBusy(bool on);
+
+	// output buffer 清空时调用一次
+	void setFlushCallback(std::function<void()> cb)
+	{
+		flush_callback_ = std::move(cb);
+	}
+
+	// 排在已设置的 flush callback 之后；前者若重新设置了 flush callback
+	// （如分块发送尚未结束），cb 顺延到其后
+	void appendFlushCallback(std::function<void()> cb);
 
 	void setContext(const std::any& ctx)
 	{
@@ -162,11 +237,33 @@ class Connection : public base::noncopyable,
 		return std::any_cast<T&>(ctx_);
 	}
 
+	// 类型不符或未设置时返回 nullptr
+	template <typename T> T* findContext()
+	{
+		return std::any_cast<T>(&ctx_);
+	}
+
 	void connEstablish();
 	void connDestroy();
 
 	void sendFile(const std::string& file_path);
 
+	// 在连接上启用 TLS，只在 loop 线程中或 connEstablish 之前调用。
+	// 握手期间 send 的数据在握手完成后发出；握手失败时关闭连接。
+	// 客户端连接的 server_name 用于 SNI 与证书校验
+	void startTls(const std::shared_ptr<TlsContext>& ctx,
+				  const std::string& server_name = "");
+
+	bool tlsEnabled() const
+	{
+		return tls_ != nullptr;
+	}
+
+	TlsSession* tls() const
+	{
+		return tls_.get();
+	}
+
   private:
 	void handleRead();
 	void handleWrite();
@@ -174,10 +271,22 @@ class Connection : public base::noncopyable,
 	void handleError();
 
 	void sendInLoop(const std::string& message);
+	void sendInLoop(const char* data, size_t len);
 	void shutdownInLoop();
+	void forceCloseInLoop();
+	void startReadInLoop();
+	void stopReadInLoop();
 
 	void sendFileInLoop(const std::string& file_path);
 	void trySendFile();
+
+	// TLS 握手未完成时不能写出应用数据
+	bool writable() const;
+	// 握手完成返回 true；失败时已关闭连接
+	bool handleHandshake();
+	ssize_t readTls(int* saved_errno);
+	ssize_t writeSome(const char* data, size_t len, int* saved_errno);
+	ssize_t sendFileSome(size_t len, int* saved_errno);
 };
 } // namespace tcp
 } // namespace lynx
@@ -0,0 +1,274 @@
+#include "lynx/tcp/connector.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/channel.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/socket.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+const double Connector::kInitRetryDelay = 0.5; // 500 ms
+const double Connector::kMaxRetryDelay = 30.0; // 30 s
+
+Connector::Connector(EventLoop* loop, const InetAddr& serv_addr)
+	: state_(State::kDisconnected), loop_(loop), serv_addr_(serv_addr),
+	  connect_(false), retry_delay_(kInitRetryDelay), connect_timeout_(3.0),
+	  max_retries_(-1), retries_(0)
+{
+}
+
+Connector::~Connector()
+{
+}
+
+void Connector::start()
+{
+	connect_.store(true, std::memory_order_release);
+	loop_->runInLoop(std::bind(&Connector::startInLoop, shared_from_this()));
+}
+
+void Connector::restart()
+{
+	loop_->assertInLoopThread();
+	cancelRetry();
+	state_ = State::kDisconnected;
+	retry_delay_ = kInitRetryDelay;
+	retries_ = 0;
+	connect_.store(true, std::memory_order_release);
+	startInLoop();
+}
+
+void Connector::stop()
+{
+	connect_.store(false, std::memory_order_release);
+	// 与 start 一样用 runInLoop，保证 stop(); start(); 按顺序生效
+	loop_->runInLoop(std::bind(&Connector::stopInLoop, shared_from_this()));
+}
+
+void Connector::startInLoop()
+{
+	loop_->assertInLoopThread();
+	assert(state_ == State::kDisconnected);
+
+	if (connect_.load(std::memory_order_acquire))
+	{
+		connect();
+	}
+	else
+	{
+		LOG_DEBUG << "Connector to " << serv_addr_.toFormattedString()
+				  << " is stopped";
+	}
+}
+
+void Connector::stopInLoop()
+{
+	loop_->assertInLoopThread();
+	cancelRetry();
+	if (state_ == State::kConnecting)
+	{
+		loop_->cancell(timeout_timer_);
+		int fd = removeAndResetChannel();
+		Socket::close(fd);
+		state_ = State::kDisconnected;
+	}
+}
+
+void Connector::connect()
+{
+	int saved_errno = 0;
+	int fd = Socket::socket(&saved_errno, serv_addr_.family());
+	if (fd == -1)
+	{
+		// fd 耗尽等情况，按失败处理
+		if (connect_failed_callback_)
+		{
+			connect_failed_callback_();
+		}
+		return;
+	}
+
+	Socket::connect(fd, serv_addr_, &saved_errno);
+	switch (saved_errno)
+	{
+	case 0:
+	case EINPROGRESS:
+	case EINTR:
+	case EISCONN:
+		connecting(fd);
+		break;
+
+	case EAGAIN:
+	case EADDRINUSE:
+	case EADDRNOTAVAIL:
+	case ECONNREFUSED:
+	case ENETUNREACH:
+		retry(fd);
+		break;
+
+	default:
+		LOG_ERROR << "connect to " << serv_addr_.toFormattedString()
+				  << " failed: " << ::strerror(saved_errno);
+		Socket::close(fd);
+		if (connect_failed_callback_)
+		{
+			connect_failed_callback_();
+		}
+		break;
+	}
+}
+
+void Connector::connecting(int fd)
+{
+	state_ = State::kConnecting;
+	assert(!ch_);
+	ch_ = std::make_unique<Channel>(fd, loop_);
+	ch_->setWriteCallback(std::bind(&Connector::handleWrite, this));
+	ch_->setErrorCallback(std::bind(&Connector::handleError, this));
+	ch_->enableOUT(); // 可写即表示连接完成（成功或失败）
+
+	if (connect_timeout_ > 0.0)
+	{
+		std::weak_ptr<Connector> weak_self = weak_from_this();
+		timeout_timer_ = loop_->runAfter(connect_timeout_,
+										 [weak_self]()
+										 {
+											 if (auto self = weak_self.lock())
+											 {
+												 self->handleTimeout();
+											 }
+										 });
+	}
+}
+
+int Connector::removeAndResetChannel()
+{
+	ch_->disableAll();
+	ch_->remove();
+	int fd = ch_->releaseFd();
+
+	// 当前可能正处于 Channel::handleEvent 中，不能立即析构
+	loop_->queueInLoop(
+		[ch = std::shared_ptr<Channel>(std::move(ch_))]() mutable
+		{ ch.reset(); });
+	return fd;
+}
+
+void Connector::handleWrite()
+{
+	LOG_TRACE << "Connector::handleWrite state " << static_cast<int>(state_);
+
+	if (state_ != State::kConnecting)
+	{
+		return;
+	}
+
+	loop_->cancell(timeout_timer_);
+	int fd = removeAndResetChannel();
+	int error = Socket::socketErrno(fd);
+	if (error)
+	{
+		LOG_WARN << "Connector::handleWrite - SO_ERROR = " << error << " "
+				 << ::strerror(error);
+		retry(fd);
+	}
+	else if (Socket::isSelfConnect(fd))
+	{
+		LOG_WARN << "Connector::handleWrite - Self connect";
+		retry(fd);
+	}
+	else
+	{
+		state_ = State::kConnected;
+		retries_ = 0;
+		retry_delay_ = kInitRetryDelay;
+		if (connect_.load(std::memory_order_acquire) &&
+			new_connection_callback_)
+		{
+			new_connection_callback_(fd);
+		}
+		else
+		{
+			Socket::close(fd);
+		}
+	}
+}
+
+void Connector::handleError()
+{
+	LOG_WARN << "Connector::handleError state " << static_cast<int>(state_);
+	if (state_ == State::kConnecting)
+	{
+		loop_->cancell(timeout_timer_);
+		int fd = removeAndResetChannel();
+		int error = Socket::socketErrno(fd);
+		LOG_TRACE << "SO_ERROR = " << error << " " << ::strerror(error);
+		retry(fd);
+	}
+}
+
+void Connector::handleTimeout()
+{
+	if (state_ != State::kConnecting)
+	{
+		return;
+	}
+
+	LOG_WARN << "connect to " << serv_addr_.toFormattedString()
+			 << " timed out after " << connect_timeout_ << "s";
+	int fd = removeAndResetChannel();
+	retry(fd);
+}
+
+void Connector::retry(int fd)
+{
+	Socket::close(fd);
+	state_ = State::kDisconnected;
+
+	if (!connect_.load(std::memory_order_acquire))
+	{
+		LOG_DEBUG << "do not connect";
+		return;
+	}
+
+	if (max_retries_ >= 0 && retries_ >= max_retries_)
+	{
+		LOG_WARN << "give up connecting to " << serv_addr_.toFormattedString()
+				 << " after " << retries_ << " retries";
+		connect_.store(false, std::memory_order_release);
+		if (connect_failed_callback_)
+		{
+			connect_failed_callback_();
+		}
+		return;
+	}
+
+	LOG_INFO << "Connector::retry - Retry connecting to "
+			 << serv_addr_.toFormattedString() << " in " << retry_delay_
+			 << " seconds";
+	retries_++;
+
+	std::weak_ptr<Connector> weak_self = weak_from_this();
+	retry_timer_ = loop_->runAfter(retry_delay_,
+								   [weak_self]()
+								   {
+									   if (auto self = weak_self.lock())
+									   {
+										   self->startInLoop();
+									   }
+								   });
+	// 指数退避
+	retry_delay_ = std::min(retry_delay_ * 2, kMaxRetryDelay);
+}
+
+void Connector::cancelRetry()
+{
+	if (retry_timer_.isAlive())
+	{
+		loop_->cancell(retry_timer_);
+	}
+}
@@ -0,0 +1,103 @@
+#ifndef LYNX_TCP_CONNECTOR_HPP
+#define LYNX_TCP_CONNECTOR_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/time/timer_id.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class Channel;
+class Connector : public base::noncopyable,
+				  public std::enable_shared_from_this<Connector>
+{
+  private:
+	static const double kInitRetryDelay;
+	static const double kMaxRetryDelay;
+
+	enum class State
+	{
+		kDisconnected,
+		kConnecting,
+		kConnected
+	} state_;
+	// start: Disconnected -> Connecting
+	// handleWrite: Connecting -> Connected / Disconnected(retry)
+	// timeout: Connecting -> Disconnected(retry)
+
+	EventLoop* loop_;
+	InetAddr serv_addr_;
+	std::atomic<bool> connect_;
+	std::unique_ptr<Channel> ch_;
+
+	double retry_delay_;
+	double connect_timeout_;
+	int max_retries_; // -1: retry forever
+	int retries_;
+	time::TimerId timeout_timer_;
+	time::TimerId retry_timer_;
+
+	std::function<void(int)> new_connection_callback_;
+	std::function<void()> connect_failed_callback_;
+
+  public:
+	Connector(EventLoop* loop, const InetAddr& serv_addr);
+	~Connector();
+
+	void setNewConnectionCallback(std::function<void(int)> cb)
+	{
+		new_connection_callback_ = std::move(cb);
+	}
+
+	// 重试次数耗尽时调用
+	void setConnectFailedCallback(std::function<void()> cb)
+	{
+		connect_failed_callback_ = std::move(cb);
+	}
+
+	void setConnectTimeout(double seconds)
+	{
+		connect_timeout_ = seconds;
+	}
+
+	void setMaxRetries(int max_retries)
+	{
+		max_retries_ = max_retries;
+	}
+
+	const InetAddr& servAddr() const
+	{
+		return serv_addr_;
+	}
+
+	EventLoop* loop() const
+	{
+		return loop_;
+	}
+
+	void start();
+	void restart(); // must be called in loop thread
+	void stop();
+
+  private:
+	void startInLoop();
+	void stopInLoop();
+	void connect();
+	void connecting(int fd);
+	void handleWrite();
+	void handleError();
+	void handleTimeout();
+	void retry(int fd);
+	void cancelRetry();
+	int removeAndResetChannel();
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
@@ -8,12 +8,19 @@
 
 namespace lynx
 {
+namespace http
+{
+class WebSocket;
+}
+
 namespace tcp
 {
 struct Context
 {
 	std::shared_ptr<http::Session> session_;
 	std::weak_ptr<base::Entry<tcp::Connection>> entry_;
+	// 升级为 WebSocket 后设置
+	std::shared_ptr<http::WebSocket> ws_;
 };
 } // namespace tcp
 } // namespace lynx
@@ -53,11 +53,9 @@ void Epoller::removeChannel(Channel* ch)
 	ch->setInEpoll(false);
 }
 
-time::TimeStamp Epoller::poll(std::vector<Channel*>* active_chs, int timeout)
+void Epoller::poll(std::vector<Channel*>* active_chs, int timeout)
 {
 	int nevs = ::epoll_wait(epfd_, evs_.data(), evs_.size(), timeout);
-	time::TimeStamp now = time::TimeStamp::now();
-
 	int saved_errno = errno;
 
 	if (nevs == -1)
@@ -85,6 +83,4 @@ time::TimeStamp Epoller::poll(std::vector<Channel*>* active_chs, int timeout)
 			evs_.resize(evs_.size() * 2);
 		}
 	}
-
-	return now;
 }
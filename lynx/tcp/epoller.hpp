@@ -23,7 +23,7 @@ class Epoller : public base::noncopyable
 	void updataChannel(Channel* ch);
 	void removeChannel(Channel* ch);
 
-	time::TimeStamp poll(std::vector<Channel*>* active_chs, int timeout = -1);
+	void poll(std::vector<Channel*>* active_chs, int timeout = -1);
 };
 } // namespace tcp
 } // namespace lynx
@@ -14,8 +14,9 @@ using namespace lynx::tcp;
 
 EventLoop::EventLoop()
 	: epoller_(std::make_unique<Epoller>()), tid_(base::CurrentThread::tid()),
-	  quit_(true), calling_pending_funcs_(false)
+	  quit_(true), calling_pending_funcs_(false), coarse_clock_(false)
 {
+	updateTime();
 	tq_ = std::make_unique<time::TimerQueue>(this);
 
 	wakeup_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
@@ -55,11 +56,12 @@ void EventLoop::run()
 	{
 		active_chs_.clear();
 		LOG_TRACE << "wait for tasks";
-		time::TimeStamp time_stamp = epoller_->poll(&active_chs_);
+		epoller_->poll(&active_chs_);
+		updateTime();
 		LOG_TRACE << "tasks is coming";
 		for (auto ch_ptr : active_chs_)
 		{
-			ch_ptr->handleEvent(time_stamp);
+			ch_ptr->handleEvent(now_);
 		}
 		doPendingFuncs();
 	}
@@ -67,23 +69,30 @@ void EventLoop::run()
 }
 
 time::TimerId EventLoop::runAt(time::TimeStamp time_stamp,
-							   const std::function<void()>& cb)
+							   time::TimerCallback cb)
 {
-	return tq_->addTimer(time_stamp, cb, -1);
+	int64_t delay =
+		time_stamp.microseconds() - time::TimeStamp::now().microseconds();
+	int64_t now = time::TimeStamp::monotonic(coarse_clock_).microseconds();
+	return tq_->addTimer(time::TimeStamp(now + delay), std::move(cb), -1);
 }
 
-time::TimerId EventLoop::runAfter(double delay, const std::function<void()>& cb)
+// 可能在其他线程调用，也可能在耗时的回调之后调用，缓存的 now_ 已过时，
+// 这里单独读一次时钟
+time::TimerId EventLoop::runAfter(double delay, time::TimerCallback cb)
 {
 	return tq_->addTimer(
-		time::TimeStamp::addTime(time::TimeStamp::now(), delay), cb, -1);
+		time::TimeStamp::addTime(time::TimeStamp::monotonic(coarse_clock_),
+								 delay),
+		std::move(cb), -1);
 }
 
-time::TimerId EventLoop::runEvery(double interval,
-								  const std::function<void()>& cb)
+time::TimerId EventLoop::runEvery(double interval, time::TimerCallback cb)
 {
 	return tq_->addTimer(
-		time::TimeStamp::addTime(time::TimeStamp::now(), interval), cb,
-		interval);
+		time::TimeStamp::addTime(time::TimeStamp::monotonic(coarse_clock_),
+								 interval),
+		std::move(cb), interval);
 }
 
 void EventLoop::cancell(time::TimerId timer_id)
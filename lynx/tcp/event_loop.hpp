@@ -4,6 +4,7 @@
 #include "lynx/base/current_thread.hpp"
 #include "lynx/base/noncopyable.hpp"
 #include "lynx/logger/logger.hpp"
+#include "lynx/time/time_stamp.hpp"
 #include "lynx/time/timer_id.hpp"
 #include <atomic>
 #include <cstdint>
@@ -35,6 +36,10 @@ class EventLoop : public base::noncopyable
 	std::vector<Channel*> active_chs_;
 	std::unique_ptr<time::TimerQueue> tq_;
 
+	// 每轮 poll 返回后更新一次的单调时间
+	time::TimeStamp now_;
+	bool coarse_clock_;
+
   public:
 	EventLoop();
 	~EventLoop();
@@ -95,14 +100,38 @@ class EventLoop : public base::noncopyable
 		return base::CurrentThread::tid() == tid_;
 	}
 
-	time::TimerId runAt(time::TimeStamp time_stamp,
-						const std::function<void()>& cb);
-	time::TimerId runAfter(double delay, const std::function<void()>& cb);
-	time::TimerId runEvery(double interval, const std::function<void()>& cb);
+	// 本轮 poll 返回时的单调时间（TimeStamp::monotonic），同一轮中的
+	// 事件与定时器回调共用这一次读取。只在 loop 线程中调用
+	time::TimeStamp now() const
+	{
+		return now_;
+	}
+
+	// 缓存时间改用 CLOCK_MONOTONIC_COARSE，读取更快但精度只有一个 tick，
+	// 定时器可能提前最多一个 tick。须在 run 之前设置
+	void setCoarseClock(bool on = true)
+	{
+		coarse_clock_ = on;
+		updateTime();
+	}
+
+	// 定时器按单调时钟计时，系统时间跳变不影响；time_stamp 为墙上时间，
+	// 按与当前时间的差值换算
+	// 回调不超过 48 字节时存放在池化的定时器节点内，注册不分配内存；
+	// 其他线程的注册按批投递，一批只唤醒一次 loop
+	time::TimerId runAt(time::TimeStamp time_stamp, time::TimerCallback cb);
+	time::TimerId runAfter(double delay, time::TimerCallback cb);
+	// 每次从上一次的到期时刻推进 interval，不随回调耗时漂移
+	time::TimerId runEvery(double interval, time::TimerCallback cb);
 
 	void cancell(time::TimerId timer_id);
 
   private:
+	void updateTime()
+	{
+		now_ = time::TimeStamp::monotonic(coarse_clock_);
+	}
+
 	void abortNotInLoopThread()
 	{
 		LOG_FATAL << "EventLoop was created in threadId_ = " << tid_
@@ -40,6 +40,16 @@ class EventLoopThreadPool : public base::noncopyable
 		}
 		return loop;
 	}
+
+	// 全部 sub loop，没有 sub loop 时为主 loop
+	std::vector<EventLoop*> allLoops() const
+	{
+		if (sub_loops_.empty())
+		{
+			return {main_loop_};
+		}
+		return sub_loops_;
+	}
 };
 } // namespace tcp
 } // namespace lynx
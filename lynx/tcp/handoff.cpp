@@ -0,0 +1,241 @@
+#include "lynx/tcp/handoff.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/channel.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/socket.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+namespace
+{
+bool makeAddr(const std::string& path, sockaddr_un* addr)
+{
+	if (path.size() >= sizeof(addr->sun_path))
+	{
+		LOG_ERROR << "Handoff: path too long: " << path;
+		return false;
+	}
+	std::memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	std::memcpy(addr->sun_path, path.c_str(), path.size());
+	return true;
+}
+} // namespace
+
+Handoff::Handoff(EventLoop* loop, const std::string& path)
+	: loop_(loop), path_(path)
+{
+}
+
+Handoff::~Handoff()
+{
+	if (ch_ && ch_->fd() != -1)
+	{
+		close();
+		::unlink(path_.c_str());
+	}
+}
+
+bool Handoff::listen()
+{
+	loop_->assertInLoopThread();
+
+	sockaddr_un addr;
+	if (!makeAddr(path_, &addr))
+	{
+		return false;
+	}
+
+	int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd == -1)
+	{
+		LOG_ERROR << "Handoff: socket failed: " << ::strerror(errno);
+		return false;
+	}
+
+	// 旧进程交出 fd 后不删除 path，由接手的进程覆盖。
+	// 拿到监听 fd 即可接管并让本进程 drain，只允许属主连接：
+	// 在 listen 之前 chmod，期间没有人能连上
+	::unlink(path_.c_str());
+	if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 ||
+		::chmod(path_.c_str(), 0600) == -1 || ::listen(fd, 4) == -1)
+	{
+		LOG_ERROR << "Handoff: listen on " << path_
+				  << " failed: " << ::strerror(errno);
+		::close(fd);
+		return false;
+	}
+
+	ch_ = std::make_unique<Channel>(fd, loop_);
+	ch_->setReadCallback(std::bind(&Handoff::handleRead, this));
+	ch_->enableIN();
+	return true;
+}
+
+std::vector<int> Handoff::take(const std::string& path, double timeout)
+{
+	sockaddr_un addr;
+	if (!makeAddr(path, &addr))
+	{
+		return {};
+	}
+
+	int sock = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (sock == -1)
+	{
+		return {};
+	}
+
+	// 没有旧进程在监听（ENOENT / ECONNREFUSED）时直接返回
+	if (::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) ==
+		-1)
+	{
+		::close(sock);
+		return {};
+	}
+
+	timeval tv;
+	tv.tv_sec = static_cast<time_t>(timeout);
+	tv.tv_usec = static_cast<suseconds_t>((timeout - tv.tv_sec) * 1e6);
+	::setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	std::vector<int> fds = recvFds(sock);
+	::close(sock);
+	LOG_INFO << "Handoff: took " << fds.size() << " fds from " << path;
+	return fds;
+}
+
+bool Handoff::sendFds(int sock, const std::vector<int>& fds)
+{
+	if (fds.empty() || fds.size() > kMaxFds)
+	{
+		return false;
+	}
+
+	char data = 'F';
+	iovec iov{&data, 1};
+
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFds)];
+	std::memset(control, 0, sizeof(control));
+
+	msghdr msg;
+	std::memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+
+	cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+	std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+	ssize_t n;
+	do
+	{
+		n = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+	} while (n == -1 && errno == EINTR);
+
+	if (n != 1)
+	{
+		LOG_ERROR << "Handoff: sendmsg failed: " << ::strerror(errno);
+		return false;
+	}
+	return true;
+}
+
+std::vector<int> Handoff::recvFds(int sock)
+{
+	char data;
+	iovec iov{&data, 1};
+
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFds)];
+
+	msghdr msg;
+	std::memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	ssize_t n;
+	do
+	{
+		n = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+	} while (n == -1 && errno == EINTR);
+
+	std::vector<int> fds;
+	if (n != 1)
+	{
+		return fds;
+	}
+
+	for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+		 cmsg = CMSG_NXTHDR(&msg, cmsg))
+	{
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+		{
+			size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+			size_t offset = fds.size();
+			fds.resize(offset + count);
+			std::memcpy(fds.data() + offset, CMSG_DATA(cmsg),
+						sizeof(int) * count);
+		}
+	}
+	return fds;
+}
+
+void Handoff::handleRead()
+{
+	loop_->assertInLoopThread();
+
+	int sock = ::accept4(ch_->fd(), nullptr, nullptr, SOCK_CLOEXEC);
+	if (sock == -1)
+	{
+		if (errno != EAGAIN && errno != EINTR)
+		{
+			LOG_ERROR << "Handoff: accept failed: " << ::strerror(errno);
+		}
+		return;
+	}
+
+	// 文件权限之外再校验对端进程的有效 uid
+	struct ucred cred{};
+	if (!Socket::peerCredentials(sock, &cred) || cred.uid != ::geteuid())
+	{
+		LOG_WARN << "Handoff: rejected peer pid " << cred.pid << " uid "
+				 << cred.uid;
+		::close(sock);
+		return;
+	}
+
+	bool ok = sendFds(sock, fds_);
+	::close(sock);
+	if (!ok)
+	{
+		return;
+	}
+
+	LOG_INFO << "Handoff: handed off " << fds_.size() << " fds via " << path_;
+	close();
+	if (handed_off_callback_)
+	{
+		handed_off_callback_();
+	}
+}
+
+// 可能在 ch_ 自己的回调里调用，只释放 fd 不析构 Channel
+void Handoff::close()
+{
+	ch_->disableAll();
+	ch_->remove();
+	Socket::close(ch_->releaseFd());
+}
@@ -0,0 +1,61 @@
+#ifndef LYNX_TCP_HANDOFF_HPP
+#define LYNX_TCP_HANDOFF_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class Channel;
+// 通过 Unix 域套接字（SCM_RIGHTS）把监听 fd 交给新进程，重启期间不丢连接：
+// 旧进程在 path 上 listen() 等待；新进程启动时 take(path) 取得 fd 并开始
+// accept，随后旧进程收到 handed off 回调，通常在其中调用 Server::drain
+class Handoff : public base::noncopyable
+{
+  private:
+	EventLoop* loop_;
+	std::string path_;
+	std::unique_ptr<Channel> ch_;
+	std::vector<int> fds_;
+	std::function<void()> handed_off_callback_;
+
+  public:
+	static constexpr size_t kMaxFds = 16;
+
+	Handoff(EventLoop* loop, const std::string& path);
+	~Handoff();
+
+	// 要交出的 fd，通常为 Server::listenFd()
+	void setFds(std::vector<int> fds)
+	{
+		fds_ = std::move(fds);
+	}
+
+	void setHandedOffCallback(std::function<void()> cb)
+	{
+		handed_off_callback_ = std::move(cb);
+	}
+
+	// 删除残留的 path 后监听，失败返回 false
+	bool listen();
+
+	// 连接旧进程取得监听 fd，没有旧进程或超时时返回空。阻塞，在 loop 运行前调用
+	static std::vector<int> take(const std::string& path, double timeout = 1.0);
+
+	static bool sendFds(int sock, const std::vector<int>& fds);
+	static std::vector<int> recvFds(int sock);
+
+  private:
+	void handleRead();
+	void close();
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
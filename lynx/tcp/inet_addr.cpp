@@ -0,0 +1,213 @@
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/logger/logger.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <strings.h>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+InetAddr::InetAddr() : len_(sizeof(sockaddr_in))
+{
+	::bzero(&addr_, sizeof(addr_));
+}
+
+InetAddr::InetAddr(uint16_t port, bool loopback_only, bool ipv6)
+{
+	::bzero(&addr_, sizeof(addr_));
+	if (ipv6)
+	{
+		addr_.in6_.sin6_family = AF_INET6;
+		addr_.in6_.sin6_port = ::htons(port);
+		addr_.in6_.sin6_addr = loopback_only ? in6addr_loopback : in6addr_any;
+		len_ = sizeof(sockaddr_in6);
+	}
+	else
+	{
+		addr_.in_.sin_family = AF_INET;
+		addr_.in_.sin_port = ::htons(port);
+		in_addr_t ip = loopback_only ? INADDR_LOOPBACK : INADDR_ANY;
+		addr_.in_.sin_addr.s_addr = ::htonl(ip);
+		len_ = sizeof(sockaddr_in);
+	}
+}
+
+InetAddr::InetAddr(const std::string& ip, uint16_t port)
+{
+	::bzero(&addr_, sizeof(addr_));
+	int ret;
+	if (ip.find(':') != std::string::npos)
+	{
+		addr_.in6_.sin6_family = AF_INET6;
+		addr_.in6_.sin6_port = ::htons(port);
+		len_ = sizeof(sockaddr_in6);
+		ret = ::inet_pton(AF_INET6, ip.c_str(), &addr_.in6_.sin6_addr);
+	}
+	else
+	{
+		addr_.in_.sin_family = AF_INET;
+		addr_.in_.sin_port = ::htons(port);
+		len_ = sizeof(sockaddr_in);
+		ret = ::inet_pton(AF_INET, ip.c_str(), &addr_.in_.sin_addr.s_addr);
+	}
+
+	if (ret != 1)
+	{
+		LOG_FATAL << "inet_pton failed for " << ip;
+	}
+}
+
+InetAddr::InetAddr(const sockaddr_in& addr) : len_(sizeof(sockaddr_in))
+{
+	::bzero(&addr_, sizeof(addr_));
+	addr_.in_ = addr;
+}
+
+InetAddr::InetAddr(const sockaddr_in6& addr) : len_(sizeof(sockaddr_in6))
+{
+	::bzero(&addr_, sizeof(addr_));
+	addr_.in6_ = addr;
+}
+
+InetAddr InetAddr::fromUnixPath(const std::string& path)
+{
+	InetAddr addr;
+	addr.addr_.un_.sun_family = AF_UNIX;
+	if (path.empty() || path.size() >= sizeof(addr.addr_.un_.sun_path))
+	{
+		LOG_FATAL << "invalid unix socket path: " << path;
+	}
+	::memcpy(addr.addr_.un_.sun_path, path.data(), path.size());
+	if (path[0] == '@')
+	{
+		// 抽象地址以 '\0' 开头，长度不含结尾的 '\0'
+		addr.addr_.un_.sun_path[0] = '\0';
+		addr.len_ = offsetof(sockaddr_un, sun_path) + path.size();
+	}
+	else
+	{
+		addr.len_ = offsetof(sockaddr_un, sun_path) + path.size() + 1;
+	}
+	return addr;
+}
+
+std::string InetAddr::path() const
+{
+	if (!isUnix() || len_ <= offsetof(sockaddr_un, sun_path))
+	{
+		return std::string();
+	}
+	const char* p = addr_.un_.sun_path;
+	size_t n = len_ - offsetof(sockaddr_un, sun_path);
+	if (p[0] == '\0')
+	{
+		return "@" + std::string(p + 1, n - 1);
+	}
+	return std::string(p, ::strnlen(p, n));
+}
+
+size_t InetAddr::formatIp(char* buf, size_t size) const
+{
+	const uint8_t* v4 = nullptr;
+	if (!isIpv6())
+	{
+		v4 = reinterpret_cast<const uint8_t*>(&addr_.in_.sin_addr);
+	}
+	else if (IN6_IS_ADDR_V4MAPPED(&addr_.in6_.sin6_addr))
+	{
+		v4 = addr_.in6_.sin6_addr.s6_addr + 12;
+	}
+
+	if (v4)
+	{
+		// 连接日志每次都会格式化地址，IPv4 直接拼接，不走 inet_ntop
+		char* p = buf;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (i)
+			{
+				*p++ = '.';
+			}
+			p = std::to_chars(p, buf + size, v4[i]).ptr;
+		}
+		return p - buf;
+	}
+
+	if (::inet_ntop(AF_INET6, &addr_.in6_.sin6_addr, buf, size) == nullptr)
+	{
+		LOG_ERROR << "inet_ntop failed: " << ::strerror(errno);
+		return 0;
+	}
+	return ::strlen(buf);
+}
+
+std::string InetAddr::ip() const
+{
+	if (isUnix())
+	{
+		return "unix";
+	}
+
+	char buf[INET6_ADDRSTRLEN];
+	return std::string(buf, formatIp(buf, sizeof(buf)));
+}
+
+uint16_t InetAddr::port() const
+{
+	switch (family())
+	{
+	case AF_INET:
+		return ::ntohs(addr_.in_.sin_port);
+	case AF_INET6:
+		return ::ntohs(addr_.in6_.sin6_port);
+	default:
+		return 0;
+	}
+}
+
+std::string InetAddr::toFormattedString() const
+{
+	if (isUnix())
+	{
+		return "unix:" + path();
+	}
+
+	// "[" + ip + "]:" + port
+	char buf[INET6_ADDRSTRLEN + 8];
+	char* end = buf + sizeof(buf);
+	bool bracket = isIpv6() && !IN6_IS_ADDR_V4MAPPED(&addr_.in6_.sin6_addr);
+	char* p = buf + bracket;
+	p += formatIp(p, INET6_ADDRSTRLEN);
+	if (bracket)
+	{
+		buf[0] = '[';
+		*p++ = ']';
+	}
+	*p++ = ':';
+	p = std::to_chars(p, end, port()).ptr;
+	return std::string(buf, p);
+}
+
+bool InetAddr::operator==(const InetAddr& rhs) const
+{
+	if (family() != rhs.family() || len_ != rhs.len_)
+	{
+		return false;
+	}
+
+	switch (family())
+	{
+	case AF_INET:
+		return addr_.in_.sin_port == rhs.addr_.in_.sin_port &&
+			   addr_.in_.sin_addr.s_addr == rhs.addr_.in_.sin_addr.s_addr;
+	case AF_INET6:
+		return addr_.in6_.sin6_port == rhs.addr_.in6_.sin6_port &&
+			   ::memcmp(&addr_.in6_.sin6_addr, &rhs.addr_.in6_.sin6_addr,
+						sizeof(in6_addr)) == 0;
+	default:
+		return ::memcmp(&addr_, &rhs.addr_, len_) == 0;
+	}
+}
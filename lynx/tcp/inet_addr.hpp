@@ -1,91 +1,108 @@
 #ifndef LYNX_TCP_INET_ADDR_HPP
 #define LYNX_TCP_INET_ADDR_HPP
 
-#include "lynx/logger/logger.hpp"
-#include <arpa/inet.h>
 #include <cstdint>
-#include <format>
 #include <netinet/in.h>
 #include <string>
-#include <strings.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 namespace lynx
 {
 namespace tcp
 {
+// IPv4、IPv6 或 Unix 域地址。Unix 域地址以 '@' 开头时表示 Linux
+// 抽象命名空间，不在文件系统中创建文件
 class InetAddr
 {
   private:
-	struct sockaddr_in addr_;
+	union
+	{
+		struct sockaddr_in in_;
+		struct sockaddr_in6 in6_;
+		struct sockaddr_un un_;
+		struct sockaddr_storage storage_;
+	} addr_;
+	socklen_t len_;
 
   public:
-	InetAddr()
-	{
-		::bzero(&addr_, sizeof(addr_));
-	}
+	InetAddr();
+
+	// ipv6 为 true 时监听 "::"，在 Linux 上同时接受 IPv4 连接（双栈）
+	explicit InetAddr(uint16_t port, bool loopback_only = false,
+					  bool ipv6 = false);
+
+	// ip 含 ':' 时按 IPv6 解析，如 "::1"
+	InetAddr(const std::string& ip, uint16_t port);
+
+	explicit InetAddr(const sockaddr_in& addr);
+	explicit InetAddr(const sockaddr_in6& addr);
 
-	explicit InetAddr(uint16_t port, bool loopback_only = false)
+	static InetAddr fromUnixPath(const std::string& path);
+
+	const struct sockaddr* sockaddr() const
 	{
-		::bzero(&addr_, sizeof(addr_));
-		addr_.sin_family = AF_INET;
-		addr_.sin_port = ::htons(port);
-		in_addr_t ip = loopback_only ? INADDR_LOOPBACK : INADDR_ANY;
-		addr_.sin_addr.s_addr = ::htonl(ip);
+		return reinterpret_cast<const struct sockaddr*>(&addr_);
 	}
 
-	InetAddr(const std::string& ip, uint16_t port)
+	struct sockaddr* sockaddr()
 	{
-		::bzero(&addr_, sizeof(addr_));
-		addr_.sin_family = AF_INET;
-		addr_.sin_port = ::htons(port);
-		if (::inet_pton(AF_INET, ip.c_str(), &addr_.sin_addr.s_addr) != 1)
-		{
-			LOG_FATAL << "inet_pton failed: " << ::strerror(errno);
-		}
+		return reinterpret_cast<struct sockaddr*>(&addr_);
 	}
 
-	explicit InetAddr(const sockaddr_in& addr) : addr_(addr)
+	// sockaddr() 可容纳的最大长度，供 accept/getsockname 使用
+	static socklen_t capacity()
 	{
+		return sizeof(addr_);
 	}
 
-	const struct sockaddr* sockaddr() const
+	socklen_t length() const
 	{
-		return reinterpret_cast<const struct sockaddr*>(&addr_);
+		return len_;
 	}
 
-	struct sockaddr* sockaddr()
+	void setLength(socklen_t len)
 	{
-		return reinterpret_cast<struct sockaddr*>(&addr_);
+		len_ = len;
 	}
 
 	void setSockaddr(const sockaddr_in& addr)
 	{
-		addr_ = addr;
+		*this = InetAddr(addr);
 	}
 
-	std::string ip() const
+	sa_family_t family() const
 	{
-		char buf[INET_ADDRSTRLEN];
-		::bzero(buf, sizeof(buf));
-		if (::inet_ntop(AF_INET, &addr_.sin_addr, buf, sizeof(buf)) == nullptr)
-		{
-			LOG_ERROR << "inet_ntop failed: " << ::strerror(errno);
-		}
-
-		return std::string(buf);
+		return addr_.storage_.ss_family;
 	}
 
-	uint16_t port() const
+	bool isIpv6() const
 	{
-		return ::ntohs(addr_.sin_port);
+		return family() == AF_INET6;
 	}
 
-	std::string toFormattedString() const
+	bool isUnix() const
 	{
-		return std::format("{}:{}", ip(), port());
+		return family() == AF_UNIX;
 	}
+
+	// Unix 域地址的路径，抽象地址以 '@' 开头；未命名的对端为空
+	std::string path() const;
+
+	// IPv4 映射的 IPv6 地址（双栈监听收到的 IPv4 连接）按 IPv4 输出
+	std::string ip() const;
+
+	uint16_t port() const;
+
+	// "1.2.3.4:80"、"[::1]:80" 或 "unix:/path"
+	std::string toFormattedString() const;
+
+	bool operator==(const InetAddr& rhs) const;
+
+  private:
+	// 把 ip 写入 buf，返回长度
+	size_t formatIp(char* buf, size_t size) const;
 };
 } // namespace tcp
 } // namespace lynx
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,382 @@
+#include "lynx/tcp/master.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/metrics/registry.hpp"
+#include "lynx/tcp/channel.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/socket.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+namespace
+{
+// 启动后不足该时间就退出的 worker 延迟重启，避免崩溃循环
+constexpr double kMinWorkerLifetime = 1.0;
+
+sigset_t handledSignals()
+{
+	sigset_t mask;
+	::sigemptyset(&mask);
+	::sigaddset(&mask, SIGCHLD);
+	::sigaddset(&mask, SIGTERM);
+	::sigaddset(&mask, SIGINT);
+	return mask;
+}
+
+void closeChannelFd(const std::unique_ptr<Channel>& ch)
+{
+	if (ch && ch->fd() != -1)
+	{
+		Socket::close(ch->releaseFd());
+	}
+}
+} // namespace
+
+Master::Master(EventLoop* loop, const InetAddr& addr, const std::string& name,
+			   size_t worker_num)
+	: loop_(loop), addr_(addr), name_(name), workers_(worker_num),
+	  report_interval_(1.0), stopping_(false)
+{
+}
+
+Master::~Master()
+{
+	loop_->assertInLoopThread();
+	for (Worker& w : workers_)
+	{
+		if (w.report_ch)
+		{
+			w.report_ch->disableAll();
+			w.report_ch->remove();
+		}
+		if (w.listen_fd != -1)
+		{
+			Socket::close(w.listen_fd);
+		}
+	}
+	if (signal_ch_)
+	{
+		signal_ch_->disableAll();
+		signal_ch_->remove();
+	}
+}
+
+void Master::run()
+{
+	loop_->assertInLoopThread();
+
+	// 信号改由 signalfd 在 loop 中处理，掩码会被 worker 继承
+	sigset_t mask = handledSignals();
+	::sigprocmask(SIG_BLOCK, &mask, nullptr);
+	int sfd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (sfd == -1)
+	{
+		LOG_FATAL << "signalfd failed: " << ::strerror(errno);
+	}
+	signal_ch_ = std::make_unique<Channel>(sfd, loop_);
+	signal_ch_->setReadCallback(std::bind(&Master::handleSignal, this));
+	signal_ch_->enableIN();
+
+	int saved_errno = 0;
+	for (Worker& w : workers_)
+	{
+		w.listen_fd = Socket::socket(&saved_errno, addr_.family());
+		checkErrno(saved_errno);
+		Socket::setReuseAddr(w.listen_fd);
+		Socket::setReusePort(w.listen_fd);
+		if (addr_.isIpv6())
+		{
+			Socket::setIpv6Only(w.listen_fd, false);
+		}
+		Socket::bind(w.listen_fd, addr_, &saved_errno);
+		checkErrno(saved_errno);
+		// master 持有的 socket 一直在监听，worker 重启期间连接在队列中等待
+		Socket::listen(w.listen_fd, &saved_errno);
+		checkErrno(saved_errno);
+	}
+
+	LOG_INFO << "Master [" << name_ << "] listening on "
+			 << addr_.toFormattedString() << " with " << workers_.size()
+			 << " workers";
+	for (size_t i = 0; i < workers_.size(); ++i)
+	{
+		spawn(i);
+	}
+}
+
+void Master::stop()
+{
+	loop_->assertInLoopThread();
+	stopping_ = true;
+
+	bool alive = false;
+	for (Worker& w : workers_)
+	{
+		if (w.pid > 0)
+		{
+			::kill(w.pid, SIGTERM);
+			alive = true;
+		}
+	}
+	if (!alive)
+	{
+		loop_->quit();
+	}
+}
+
+std::string Master::scrape() const
+{
+	std::vector<std::string> reports;
+	reports.reserve(workers_.size() + 1);
+	reports.push_back(retired_);
+	for (const Worker& w : workers_)
+	{
+		reports.push_back(w.report);
+	}
+	return metrics::Registry::merge(reports);
+}
+
+void Master::spawn(size_t index)
+{
+	Worker& w = workers_[index];
+
+	int fds[2];
+	if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0,
+					 fds) == -1)
+	{
+		LOG_ERROR << "socketpair failed: " << ::strerror(errno);
+		fds[0] = fds[1] = -1;
+	}
+
+	pid_t pid = ::fork();
+	if (pid == -1)
+	{
+		LOG_ERROR << "fork worker " << index
+				  << " failed: " << ::strerror(errno);
+		::close(fds[0]);
+		::close(fds[1]);
+		loop_->runAfter(kMinWorkerLifetime,
+						[this, index]()
+						{
+							if (!stopping_)
+							{
+								spawn(index);
+							}
+						});
+		return;
+	}
+	if (pid == 0)
+	{
+		::close(fds[0]);
+		runWorker(index, fds[1]);
+	}
+
+	::close(fds[1]);
+	w.pid = pid;
+	w.started = std::chrono::steady_clock::now();
+	w.report.clear();
+	if (fds[0] != -1)
+	{
+		w.report_ch = std::make_unique<Channel>(fds[0], loop_);
+		w.report_ch->setReadCallback(
+			std::bind(&Master::handleReport, this, index));
+		w.report_ch->enableIN();
+	}
+	LOG_INFO << "Master [" << name_ << "] started worker " << index
+			 << " pid " << pid;
+}
+
+void Master::runWorker(size_t index, int report_fd)
+{
+	// 关掉继承来的 master 端 fd。master 的 loop 与其 epoll 与父进程共享，
+	// 不能在这里修改，只关闭 fd
+	closeChannelFd(signal_ch_);
+	for (size_t i = 0; i < workers_.size(); ++i)
+	{
+		closeChannelFd(workers_[i].report_ch);
+		if (i != index)
+		{
+			Socket::close(workers_[i].listen_fd);
+		}
+	}
+
+	// worker 只用 signalfd 接收 SIGTERM / SIGINT
+	sigset_t mask = handledSignals();
+	::sigdelset(&mask, SIGCHLD);
+	sigset_t chld;
+	::sigemptyset(&chld);
+	::sigaddset(&chld, SIGCHLD);
+	::sigprocmask(SIG_UNBLOCK, &chld, nullptr);
+
+	{
+		EventLoop loop;
+
+		int sfd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+		Channel signal_ch(sfd, &loop);
+		signal_ch.setReadCallback(
+			[&loop, sfd]()
+			{
+				signalfd_siginfo info;
+				while (::read(sfd, &info, sizeof(info)) == sizeof(info))
+				{
+				}
+				loop.quit();
+			});
+		signal_ch.enableIN();
+
+		if (report_fd != -1)
+		{
+			loop.runEvery(report_interval_,
+						  [report_fd]()
+						  {
+							  std::string text =
+								  metrics::Registry::instance().scrape();
+							  // master 忙时丢弃本次上报，不阻塞 worker
+							  ::send(report_fd, text.data(), text.size(),
+									 MSG_DONTWAIT | MSG_NOSIGNAL);
+						  });
+		}
+
+		if (worker_callback_)
+		{
+			worker_callback_(&loop, workers_[index].listen_fd, index);
+		}
+
+		signal_ch.disableAll();
+		signal_ch.remove();
+	}
+	::_exit(EXIT_SUCCESS);
+}
+
+void Master::handleSignal()
+{
+	signalfd_siginfo info;
+	while (::read(signal_ch_->fd(), &info, sizeof(info)) == sizeof(info))
+	{
+		if (info.ssi_signo == SIGCHLD)
+		{
+			reap();
+		}
+		else if (!stopping_)
+		{
+			LOG_INFO << "Master [" << name_ << "] received signal "
+					 << info.ssi_signo << ", stopping workers";
+			stop();
+		}
+	}
+}
+
+void Master::handleReport(size_t index)
+{
+	Worker& w = workers_[index];
+	if (!w.report_ch)
+	{
+		return;
+	}
+	int fd = w.report_ch->fd();
+	while (true)
+	{
+		// 每次上报是一个 SEQPACKET 报文，先取长度再整条读出
+		ssize_t len = ::recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+		if (len > 0)
+		{
+			w.report.resize(len);
+			::recv(fd, w.report.data(), len, 0);
+			continue;
+		}
+		if (len == 0)
+		{
+			// worker 已退出，由 SIGCHLD 处理
+			w.report_ch->disableAll();
+		}
+		break;
+	}
+}
+
+void Master::reap()
+{
+	int status = 0;
+	pid_t pid;
+	while ((pid = ::waitpid(-1, &status, WNOHANG)) > 0)
+	{
+		size_t index = 0;
+		while (index < workers_.size() && workers_[index].pid != pid)
+		{
+			++index;
+		}
+		if (index == workers_.size())
+		{
+			continue;
+		}
+
+		Worker& w = workers_[index];
+		w.pid = -1;
+		if (w.report_ch)
+		{
+			w.report_ch->disableAll();
+			w.report_ch->remove();
+			// 本轮 poll 中可能还有它的 EOF 事件，延后析构
+			std::shared_ptr<Channel> ch(std::move(w.report_ch));
+			loop_->queueInLoop([ch]() {});
+		}
+		// 已退出 worker 的计数继续计入总量，gauge 随进程消失
+		retired_ = metrics::Registry::merge({retired_, w.report}, true);
+		w.report.clear();
+
+		if (stopping_)
+		{
+			LOG_INFO << "Master [" << name_ << "] worker " << index
+					 << " exited";
+			continue;
+		}
+
+		if (WIFSIGNALED(status))
+		{
+			LOG_WARN << "Master [" << name_ << "] worker " << index << " pid "
+					 << pid << " killed by signal " << WTERMSIG(status);
+		}
+		else
+		{
+			LOG_WARN << "Master [" << name_ << "] worker " << index << " pid "
+					 << pid << " exited with status " << WEXITSTATUS(status);
+		}
+
+		std::chrono::duration<double> lived =
+			std::chrono::steady_clock::now() - w.started;
+		if (lived.count() < kMinWorkerLifetime)
+		{
+			loop_->runAfter(kMinWorkerLifetime,
+							[this, index]()
+							{
+								if (!stopping_)
+								{
+									spawn(index);
+								}
+							});
+		}
+		else
+		{
+			spawn(index);
+		}
+	}
+
+	if (stopping_)
+	{
+		for (const Worker& w : workers_)
+		{
+			if (w.pid > 0)
+			{
+				return;
+			}
+		}
+		LOG_INFO << "Master [" << name_ << "] all workers exited";
+		loop_->quit();
+	}
+}
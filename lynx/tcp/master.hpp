@@ -0,0 +1,98 @@
+#ifndef LYNX_TCP_MASTER_HPP
+#define LYNX_TCP_MASTER_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class Channel;
+// 多进程模式：master 为每个 worker 创建一个 SO_REUSEPORT 监听 socket 后
+// fork，由内核在各 socket 间分配连接。worker 崩溃后 master 用同一个 socket
+// 重新 fork，队列中的连接不丢失；worker 定期把指标发回 master 汇总。
+// master 须在启动任何线程（包括异步日志）之前 run
+class Master : public base::noncopyable
+{
+  public:
+	// 在 worker 进程中调用：用 listen_fd 构造 Server 并运行 loop，
+	// 收到 SIGTERM 时 loop 退出，回调返回后 worker 退出
+	using WorkerCallback =
+		std::function<void(EventLoop* loop, int listen_fd, size_t index)>;
+
+  private:
+	struct Worker
+	{
+		pid_t pid = -1;
+		int listen_fd = -1;
+		std::unique_ptr<Channel> report_ch; // master 端的 socketpair
+		std::string report;					// 最近一次上报的指标
+		std::chrono::steady_clock::time_point started;
+	};
+
+	EventLoop* loop_;
+	InetAddr addr_;
+	std::string name_;
+	std::vector<Worker> workers_;
+	WorkerCallback worker_callback_;
+	double report_interval_;
+
+	std::unique_ptr<Channel> signal_ch_;
+	std::string retired_; // 已退出 worker 的 counter 与直方图
+	bool stopping_;
+
+  public:
+	Master(EventLoop* loop, const InetAddr& addr, const std::string& name,
+		   size_t worker_num);
+	~Master();
+
+	void setWorkerCallback(WorkerCallback cb)
+	{
+		worker_callback_ = std::move(cb);
+	}
+
+	void setReportInterval(double seconds)
+	{
+		report_interval_ = seconds;
+	}
+
+	// 创建监听 socket 并 fork 全部 worker，之后由 loop 处理 SIGCHLD 与
+	// SIGTERM / SIGINT
+	void run();
+	// 向 worker 发送 SIGTERM，全部退出后 loop 退出
+	void stop();
+
+	size_t workerNum() const
+	{
+		return workers_.size();
+	}
+
+	pid_t workerPid(size_t index) const
+	{
+		return workers_[index].pid;
+	}
+
+	// 各 worker 指标之和（Prometheus 文本格式）
+	std::string scrape() const;
+
+  private:
+	void spawn(size_t index);
+	[[noreturn]] void runWorker(size_t index, int report_fd);
+
+	void handleSignal();
+	void handleReport(size_t index);
+	void reap();
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
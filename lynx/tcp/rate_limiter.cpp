@@ -0,0 +1,94 @@
+#include "lynx/tcp/rate_limiter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+bool TokenBucket::take(double rate, double burst, int64_t now_us)
+{
+	double elapsed = static_cast<double>(now_us - last_us) / 1e6;
+	tokens = std::min(burst, tokens + elapsed * rate);
+	last_us = now_us;
+	if (tokens < 1)
+	{
+		return false;
+	}
+	tokens -= 1;
+	return true;
+}
+
+RateLimiter::RateLimiter(double rate, double burst, size_t max_keys)
+	: rate_(rate), burst_(std::max(burst, 1.0)), max_keys_(max_keys),
+	  last_sweep_us_(0)
+{
+}
+
+int64_t RateLimiter::now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+bool RateLimiter::allow(std::string_view key, int64_t now_us)
+{
+	auto it = buckets_.find(key);
+	if (it != buckets_.end())
+	{
+		return it->second.take(rate_, burst_, now_us);
+	}
+
+	if (buckets_.size() >= max_keys_)
+	{
+		sweep(now_us);
+		if (buckets_.size() >= max_keys_)
+		{
+			return true;
+		}
+	}
+
+	TokenBucket bucket{burst_, now_us};
+	bool ok = bucket.take(rate_, burst_, now_us);
+	buckets_.emplace(key, bucket);
+	return ok;
+}
+
+void RateLimiter::sweep(int64_t now_us)
+{
+	// 表满时每秒最多扫描一次
+	if (now_us - last_sweep_us_ < 1000000)
+	{
+		return;
+	}
+	last_sweep_us_ = now_us;
+
+	std::erase_if(buckets_,
+				  [this, now_us](const auto& item)
+				  {
+					  const TokenBucket& b = item.second;
+					  double elapsed =
+						  static_cast<double>(now_us - b.last_us) / 1e6;
+					  return b.tokens + elapsed * rate_ >= burst_;
+				  });
+}
+
+RateLimiter& RateLimiter::local(uint64_t id, double rate, double burst)
+{
+	thread_local std::unordered_map<uint64_t, std::unique_ptr<RateLimiter>>
+		shards;
+	std::unique_ptr<RateLimiter>& limiter = shards[id];
+	if (!limiter)
+	{
+		limiter = std::make_unique<RateLimiter>(rate, burst);
+	}
+	return *limiter;
+}
+
+uint64_t RateLimiter::nextId()
+{
+	static std::atomic<uint64_t> next{1};
+	return next.fetch_add(1, std::memory_order_relaxed);
+}
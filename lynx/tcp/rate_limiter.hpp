@@ -0,0 +1,80 @@
+#ifndef LYNX_TCP_RATE_LIMITER_HPP
+#define LYNX_TCP_RATE_LIMITER_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+namespace lynx
+{
+namespace tcp
+{
+// 令牌桶：每秒补充 rate 个令牌，最多积攒 burst 个
+struct TokenBucket
+{
+	double tokens;
+	int64_t last_us;
+
+	bool take(double rate, double burst, int64_t now_us);
+};
+
+// 以客户端地址等为 key 的令牌桶表，只在一个线程中使用，不加锁。
+// key 数达到 max_keys 时清理已补满（长时间空闲）的桶；仍然满时
+// 新 key 直接放行而不记录，避免地址过多时拒绝正常客户端
+class RateLimiter : public base::noncopyable
+{
+  private:
+	struct Hash
+	{
+		using is_transparent = void;
+
+		size_t operator()(std::string_view key) const
+		{
+			return std::hash<std::string_view>{}(key);
+		}
+	};
+
+	double rate_;
+	double burst_;
+	size_t max_keys_;
+	std::unordered_map<std::string, TokenBucket, Hash, std::equal_to<>>
+		buckets_;
+	int64_t last_sweep_us_;
+
+  public:
+	RateLimiter(double rate, double burst, size_t max_keys = 65536);
+
+	static int64_t now();
+
+	bool allow(std::string_view key)
+	{
+		return allow(key, now());
+	}
+
+	bool allow(std::string_view key, int64_t now_us);
+
+	size_t size() const
+	{
+		return buckets_.size();
+	}
+
+	double rate() const
+	{
+		return rate_;
+	}
+
+	// 当前线程中 id 对应的限流器，首次使用时创建。每个 loop 独占一个线程，
+	// 因此状态按 loop 分片，请求路径上无锁
+	static RateLimiter& local(uint64_t id, double rate, double burst);
+	static uint64_t nextId();
+
+  private:
+	void sweep(int64_t now_us);
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
@@ -2,9 +2,12 @@
 #include "lynx/logger/logger.hpp"
 #include "lynx/tcp/acceptor.hpp"
 #include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
 #include "lynx/tcp/event_loop.hpp"
 #include "lynx/tcp/event_loop_thread_pool.hpp"
 #include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/rate_limiter.hpp"
+#include "lynx/tcp/socket.hpp"
 #include <atomic>
 #include <csignal>
 #include <functional>
@@ -16,8 +19,48 @@ using namespace lynx::tcp;
 
 Server::Server(EventLoop* loop, const InetAddr& addr, const std::string& name,
 			   size_t sub_reactor_num)
-	: main_reactor_(loop), name_(name), seq_(0)
+	: Server(loop, std::make_unique<Acceptor>(loop, addr), name,
+			 sub_reactor_num)
 {
+}
+
+Server::Server(EventLoop* loop, const std::string& ip, uint16_t port,
+			   const std::string& name, size_t sub_reactor_num)
+	: Server(loop, InetAddr(ip, port), name, sub_reactor_num)
+{
+}
+
+Server::Server(EventLoop* loop, int listen_fd, const std::string& name,
+			   size_t sub_reactor_num)
+	: Server(loop, std::make_unique<Acceptor>(loop, listen_fd), name,
+			 sub_reactor_num)
+{
+}
+
+Server::Server(EventLoop* loop, std::unique_ptr<Acceptor> acceptor,
+			   const std::string& name, size_t sub_reactor_num)
+	: main_reactor_(loop), name_(name), acceptor_(std::move(acceptor)),
+	  seq_(0), draining_(false), max_conns_per_ip_(0)
+{
+	metrics::Registry& registry = metrics::Registry::instance();
+	accepted_metric_ = registry.counter("lynx_tcp_connections_accepted_total",
+										"Accepted TCP connections",
+										{{"server", name_}});
+	closed_metric_ = registry.counter("lynx_tcp_connections_closed_total",
+									  "Closed TCP connections",
+									  {{"server", name_}});
+	active_metric_ =
+		registry.gauge("lynx_tcp_connections_active", "Open TCP connections",
+					   {{"server", name_}});
+	rejected_limit_metric_ =
+		registry.counter("lynx_tcp_connections_rejected_total",
+						 "Connections rejected by admission control",
+						 {{"server", name_}, {"reason", "limit"}});
+	rejected_rate_metric_ =
+		registry.counter("lynx_tcp_connections_rejected_total",
+						 "Connections rejected by admission control",
+						 {{"server", name_}, {"reason", "rate"}});
+
 	static bool ignored = []()
 	{
 		struct sigaction sa;
@@ -32,23 +75,21 @@ Server::Server(EventLoop* loop, const InetAddr& addr, const std::string& name,
 	sub_reactor_pool_ =
 		std::make_unique<EventLoopThreadPool>(loop, sub_reactor_num);
 
-	acceptor_ = std::make_unique<Acceptor>(loop, addr);
 	acceptor_->setNewConnectionCallback(std::bind(&Server::handleNewConnection,
 												  this, std::placeholders::_1,
 												  std::placeholders::_2));
 }
 
-Server::Server(EventLoop* loop, const std::string& ip, uint16_t port,
-			   const std::string& name, size_t sub_reactor_num)
-	: Server(loop, InetAddr(ip, port), name, sub_reactor_num)
-{
-}
-
 Server::~Server()
 {
 	main_reactor_->assertInLoopThread();
 	LOG_TRACE << "Server::~Server [" << name_ << "] is a shutting down";
 
+	if (drain_timer_.isAlive())
+	{
+		main_reactor_->cancell(drain_timer_);
+	}
+
 	for (auto& item : conn_map_)
 	{
 		std::shared_ptr<Connection> conn(item.second);
@@ -74,12 +115,35 @@ void Server::run()
 	acceptor_->listen();
 }
 
+int Server::listenFd() const
+{
+	return acceptor_->fd();
+}
+
+void Server::drain(double timeout, std::function<void()> cb)
+{
+	main_reactor_->runInLoop(
+		[this, timeout, cb = std::move(cb)]() mutable
+		{ drainInLoop(timeout, std::move(cb)); });
+}
+
+void Server::setConnectionRate(double rate, double burst)
+{
+	accept_limiter_ = std::make_unique<RateLimiter>(rate, burst);
+}
+
 void Server::handleNewConnection(int conn_fd, const InetAddr& addr)
 {
 	main_reactor_->assertInLoopThread();
 
 	LOG_TRACE << "New connection from " << addr.toFormattedString();
 
+	if (!admit(addr))
+	{
+		Socket::close(conn_fd);
+		return;
+	}
+
 	EventLoop* io_loop = sub_reactor_pool_->nextLoop();
 	seq_.fetch_add(1, std::memory_order_acq_rel);
 
@@ -92,8 +156,14 @@ void Server::handleNewConnection(int conn_fd, const InetAddr& addr)
 	conn->setHighWaterMarkCallback(high_water_mark_callback_, high_water_mark_);
 	conn->setCloseCallback(
 		std::bind(&Server::handleClose, this, std::placeholders::_1));
+	if (tls_ctx_)
+	{
+		conn->startTls(tls_ctx_);
+	}
 
 	conn_map_[seq_] = conn;
+	accepted_metric_.inc();
+	active_metric_.add();
 
 	io_loop->runInLoop(std::bind(&Connection::connEstablish, conn));
 }
@@ -110,6 +180,115 @@ void Server::handleCloseInLoop(const std::shared_ptr<Connection>& conn)
 	decltype(conn_map_)::iterator iter = conn_map_.find(conn->id());
 	assert(iter != conn_map_.end());
 	conn_map_.erase(iter);
+	closed_metric_.inc();
+	active_metric_.sub();
+
+	if (max_conns_per_ip_ != 0 && !conn->addr().isUnix())
+	{
+		auto it = conns_per_ip_.find(conn->addr().ip());
+		if (it != conns_per_ip_.end() && --it->second == 0)
+		{
+			conns_per_ip_.erase(it);
+		}
+	}
 
 	conn->loop()->queueInLoop(std::bind(&Connection::connDestroy, conn));
+	checkDrained();
+}
+
+bool Server::admit(const InetAddr& addr)
+{
+	// Unix 域连接来自本机，访问控制交给文件权限
+	if ((max_conns_per_ip_ == 0 && !accept_limiter_) || addr.isUnix())
+	{
+		return true;
+	}
+
+	std::string ip = addr.ip();
+	if (max_conns_per_ip_ != 0)
+	{
+		auto it = conns_per_ip_.find(ip);
+		if (it != conns_per_ip_.end() && it->second >= max_conns_per_ip_)
+		{
+			LOG_DEBUG << "Server [" << name_ << "] rejects " << ip
+					  << ": too many connections";
+			rejected_limit_metric_.inc();
+			return false;
+		}
+	}
+	if (accept_limiter_ && !accept_limiter_->allow(ip))
+	{
+		LOG_DEBUG << "Server [" << name_ << "] rejects " << ip
+				  << ": connection rate exceeded";
+		rejected_rate_metric_.inc();
+		return false;
+	}
+
+	if (max_conns_per_ip_ != 0)
+	{
+		++conns_per_ip_[ip];
+	}
+	return true;
+}
+
+void Server::drainInLoop(double timeout, std::function<void()> cb)
+{
+	main_reactor_->assertInLoopThread();
+	if (draining_)
+	{
+		return;
+	}
+
+	LOG_INFO << "Server [" << name_ << "] draining " << conn_map_.size()
+			 << " connections";
+	draining_ = true;
+	drained_callback_ = std::move(cb);
+	acceptor_->stop();
+
+	for (auto& item : conn_map_)
+	{
+		const std::shared_ptr<Connection>& conn = item.second;
+		conn->loop()->runInLoop(std::bind(&Server::drainConnection, conn));
+	}
+
+	drain_timer_ = main_reactor_->runAfter(
+		timeout,
+		[this]()
+		{
+			LOG_WARN << "Server [" << name_ << "] drain timed out, closing "
+					 << conn_map_.size() << " connections";
+			for (auto& item : conn_map_)
+			{
+				item.second->forceClose();
+			}
+		});
+	checkDrained();
+}
+
+void Server::checkDrained()
+{
+	if (!draining_ || !conn_map_.empty() || !drained_callback_)
+	{
+		return;
+	}
+
+	if (drain_timer_.isAlive())
+	{
+		main_reactor_->cancell(drain_timer_);
+	}
+	LOG_INFO << "Server [" << name_ << "] drained";
+	std::function<void()> cb = std::move(drained_callback_);
+	drained_callback_ = nullptr;
+	cb();
+}
+
+void Server::drainConnection(const std::shared_ptr<Connection>& conn)
+{
+	// 已读入半个 HTTP 请求的连接等待该请求处理完，由 Router 清除 busy
+	Context* ctx = conn->findContext<Context>();
+	if (ctx && ctx->session_ && !ctx->session_->idle())
+	{
+		conn->setBusy(true);
+	}
+	conn->setDraining();
 }
\ No newline at end of file
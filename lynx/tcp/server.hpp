@@ -2,7 +2,9 @@
 #define LYNX_TCP_SERVER_HPP
 
 #include "lynx/base/noncopyable.hpp"
+#include "lynx/metrics/registry.hpp"
 #include "lynx/tcp/inet_addr.hpp"
+#include "lynx/time/timer_id.hpp"
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -10,6 +12,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 namespace lynx
 {
@@ -20,6 +23,8 @@ class Acceptor;
 class Connection;
 class EventLoopThreadPool;
 class Buffer;
+class RateLimiter;
+class TlsContext;
 class Server : public base::noncopyable
 {
   private:
@@ -41,11 +46,31 @@ class Server : public base::noncopyable
 		high_water_mark_callback_;
 	size_t high_water_mark_;
 
+	metrics::Counter accepted_metric_;
+	metrics::Counter closed_metric_;
+	metrics::Gauge active_metric_;
+
+	bool draining_;
+	std::function<void()> drained_callback_;
+	time::TimerId drain_timer_;
+
+	// 准入控制，只在主 loop 中访问
+	size_t max_conns_per_ip_; // 0 表示不限
+	std::unordered_map<std::string, size_t> conns_per_ip_;
+	std::unique_ptr<RateLimiter> accept_limiter_;
+	metrics::Counter rejected_limit_metric_;
+	metrics::Counter rejected_rate_metric_;
+
+	std::shared_ptr<TlsContext> tls_ctx_;
+
   public:
 	Server(EventLoop* loop, const InetAddr& addr, const std::string& name,
 		   size_t sub_reactor_num);
 	Server(EventLoop* loop, const std::string& ip, uint16_t port,
 		   const std::string& name, size_t sub_reactor_num);
+	// 使用已绑定的监听 fd，如通过 Handoff 从旧进程继承的套接字
+	Server(EventLoop* loop, int listen_fd, const std::string& name,
+		   size_t sub_reactor_num);
 	~Server();
 
 	size_t connectionNum() const
@@ -54,6 +79,29 @@ class Server : public base::noncopyable
 	}
 
 	void run();
+
+	// 监听 fd，可通过 Handoff 交给新进程；drain 之后为 -1
+	int listenFd() const;
+
+	// 停止 accept，等待现有连接处理完请求后关闭（HTTP 响应改为
+	// Connection: close），超过 timeout 秒强制关闭剩余连接；
+	// 全部连接关闭后在主 loop 中调用 cb。线程安全
+	void drain(double timeout, std::function<void()> cb);
+
+	// 同一 IP 的并发连接上限与新建连接速率（每秒 rate 个，突发 burst 个）。
+	// 超出的连接在 accept 后立即关闭，不创建 Connection。须在 run 之前设置
+	void setMaxConnectionsPerIp(size_t n)
+	{
+		max_conns_per_ip_ = n;
+	}
+	void setConnectionRate(double rate, double burst);
+
+	// 所有新连接先完成 TLS 握手再交付数据，须在 run 之前设置
+	void setTlsContext(std::shared_ptr<TlsContext> ctx)
+	{
+		tls_ctx_ = std::move(ctx);
+	}
+
 	void setConnectionCallback(
 		std::function<void(const std::shared_ptr<Connection>&)> cb)
 	{
@@ -81,9 +129,17 @@ class Server : public base::noncopyable
 	}
 
   private:
+	Server(EventLoop* loop, std::unique_ptr<Acceptor> acceptor,
+		   const std::string& name, size_t sub_reactor_num);
+
 	void handleNewConnection(int conn_fd, const InetAddr& addr);
+	bool admit(const InetAddr& addr);
 	void handleClose(const std::shared_ptr<Connection>& conn);
 	void handleCloseInLoop(const std::shared_ptr<Connection>& conn);
+
+	void drainInLoop(double timeout, std::function<void()> cb);
+	void checkDrained();
+	static void drainConnection(const std::shared_ptr<Connection>& conn);
 };
 } // namespace tcp
 } // namespace lynx
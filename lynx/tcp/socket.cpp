@@ -4,6 +4,7 @@
 #include <cerrno>
 #include <fcntl.h>
 #include <netinet/tcp.h>
+#include <strings.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -23,14 +24,14 @@ int Socket::socketErrno(int fd)
 	return error;
 }
 
-int Socket::socket(int* saved_errno)
+int Socket::socket(int* saved_errno, int family)
 {
 	if (saved_errno)
 	{
 		*saved_errno = 0;
 	}
 
-	int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	int fd = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
 	if (fd == -1)
 	{
 		if (saved_errno)
@@ -78,6 +79,18 @@ void Socket::setReuseAddr(int fd, bool on)
 				  << ::strerror(errno);
 	}
 }
+
+void Socket::setReusePort(int fd, bool on)
+{
+	int optval = on ? 1 : 0;
+	if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) ==
+		-1)
+	{
+		LOG_ERROR << "setsockopt(SO_REUSEPORT) failed for fd " << fd << ": "
+				  << ::strerror(errno);
+	}
+}
+
 void Socket::setKeepAlive(int fd, bool on)
 {
 	int optval = on ? 1 : 0;
@@ -99,6 +112,17 @@ void Socket::setNoDelay(int fd, bool on)
 	}
 }
 
+void Socket::setIpv6Only(int fd, bool on)
+{
+	int optval = on ? 1 : 0;
+	if (::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &optval, sizeof(optval)) ==
+		-1)
+	{
+		LOG_ERROR << "setsockopt(IPV6_V6ONLY) failed for fd " << fd << ": "
+				  << ::strerror(errno);
+	}
+}
+
 bool Socket::bind(int fd, const InetAddr& local_addr, int* saved_errno)
 {
 	if (saved_errno)
@@ -106,7 +130,7 @@ bool Socket::bind(int fd, const InetAddr& local_addr, int* saved_errno)
 		*saved_errno = 0;
 	}
 
-	if (::bind(fd, local_addr.sockaddr(), sizeof(struct sockaddr_in)) == -1)
+	if (::bind(fd, local_addr.sockaddr(), local_addr.length()) == -1)
 	{
 		if (saved_errno)
 		{
@@ -143,7 +167,7 @@ int Socket::accept(int fd, InetAddr* peer_addr, int* saved_errno)
 	{
 		*saved_errno = 0;
 	}
-	socklen_t addr_len = sizeof(sockaddr);
+	socklen_t addr_len = InetAddr::capacity();
 	int conn_fd = ::accept4(fd, peer_addr ? peer_addr->sockaddr() : nullptr,
 							&addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
 	if (conn_fd == -1)
@@ -153,6 +177,10 @@ int Socket::accept(int fd, InetAddr* peer_addr, int* saved_errno)
 			*saved_errno = errno;
 		}
 	}
+	else if (peer_addr)
+	{
+		peer_addr->setLength(addr_len);
+	}
 
 	return conn_fd;
 }
@@ -165,11 +193,12 @@ bool Socket::connect(int fd, const InetAddr& serv_addr, int* saved_errno)
 		*saved_errno = 0;
 	}
 
-	if (::connect(fd, serv_addr.sockaddr(), sizeof(sockaddr)) == -1)
+	if (::connect(fd, serv_addr.sockaddr(), serv_addr.length()) == -1)
 	{
+		// 非阻塞 connect 的 EINPROGRESS 只能从 errno 取得，SO_ERROR 此时为 0
 		if (saved_errno)
 		{
-			*saved_errno = socketErrno(fd);
+			*saved_errno = errno;
 		}
 		return false;
 	}
@@ -177,6 +206,45 @@ bool Socket::connect(int fd, const InetAddr& serv_addr, int* saved_errno)
 	return true;
 }
 
+bool Socket::isSelfConnect(int fd)
+{
+	InetAddr local_addr;
+	InetAddr peer_addr;
+
+	socklen_t len = InetAddr::capacity();
+	if (::getsockname(fd, local_addr.sockaddr(), &len) == -1)
+	{
+		LOG_ERROR << "getsockname failed for fd " << fd << ": "
+				  << ::strerror(errno);
+		return false;
+	}
+	local_addr.setLength(len);
+
+	len = InetAddr::capacity();
+	if (::getpeername(fd, peer_addr.sockaddr(), &len) == -1)
+	{
+		LOG_ERROR << "getpeername failed for fd " << fd << ": "
+				  << ::strerror(errno);
+		return false;
+	}
+	peer_addr.setLength(len);
+
+	// Unix 域套接字不会自连接
+	return !local_addr.isUnix() && local_addr == peer_addr;
+}
+
+bool Socket::peerCredentials(int fd, struct ucred* cred)
+{
+	socklen_t len = sizeof(*cred);
+	if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, cred, &len) == -1)
+	{
+		LOG_ERROR << "getsockopt(SO_PEERCRED) failed for fd " << fd << ": "
+				  << ::strerror(errno);
+		return false;
+	}
+	return true;
+}
+
 void Socket::shutdown(int fd)
 {
 	if (::shutdown(fd, SHUT_WR) == -1)
@@ -22,17 +22,23 @@ namespace Socket
 {
 // only for connecting, because it is deferred
 int socketErrno(int fd);
-int socket(int* saved_errno);
+int socket(int* saved_errno, int family = AF_INET);
 
 void setNonBlocking(int fd, bool on = true);
 void setReuseAddr(int fd, bool on = true);
+void setReusePort(int fd, bool on = true);
 void setKeepAlive(int fd, bool on = true);
 void setNoDelay(int fd, bool on = true);
+// 关闭后 IPv6 通配地址同时接受 IPv4 连接（双栈）
+void setIpv6Only(int fd, bool on);
 
 bool bind(int fd, const InetAddr& local_addr, int* saved_errno);
 bool listen(int fd, int* saved_errno, int backlog = SOMAXCONN);
 int accept(int fd, InetAddr* peer_addr, int* saved_errno);
 bool connect(int fd, const InetAddr& serv_addr, int* saved_errno);
+bool isSelfConnect(int fd);
+// Unix 域连接对端进程的 pid/uid/gid（SO_PEERCRED）
+bool peerCredentials(int fd, struct ucred* cred);
 
 void shutdown(int fd);
 void close(int fd);
@@ -0,0 +1,306 @@
+#include "lynx/tcp/tls.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/metrics/registry.hpp"
+#include <cerrno>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+namespace
+{
+metrics::Counter handshakeCounter(const std::string& result)
+{
+	return metrics::Registry::instance().counter(
+		"lynx_tls_handshakes_total", "Completed and failed TLS handshakes",
+		{{"result", result}});
+}
+
+metrics::Counter full_metric = handshakeCounter("full");
+metrics::Counter resumed_metric = handshakeCounter("resumed");
+metrics::Counter failed_metric = handshakeCounter("failed");
+metrics::Counter ktls_metric = metrics::Registry::instance().counter(
+	"lynx_tls_ktls_connections_total",
+	"TLS connections whose send path was offloaded to the kernel");
+
+std::string sslError()
+{
+	unsigned long err = ERR_get_error();
+	ERR_clear_error();
+	if (err == 0)
+	{
+		return "unknown error";
+	}
+	char buf[256];
+	ERR_error_string_n(err, buf, sizeof(buf));
+	return buf;
+}
+
+SSL_CTX* newContext(const SSL_METHOD* method)
+{
+	SSL_CTX* ctx = SSL_CTX_new(method);
+	if (ctx == nullptr)
+	{
+		LOG_ERROR << "SSL_CTX_new failed: " << sslError();
+		return nullptr;
+	}
+
+	SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+	// 对端不发 close_notify 直接断开时按正常关闭处理
+	SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS | SSL_OP_NO_RENEGOTIATION |
+								 SSL_OP_IGNORE_UNEXPECTED_EOF);
+	// 非阻塞写：允许部分写入，重试时 output buffer 可能已搬移
+	SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
+							  SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+							  SSL_MODE_RELEASE_BUFFERS);
+	return ctx;
+}
+
+int newClientSession(SSL* ssl, SSL_SESSION* session)
+{
+	auto* ctx =
+		static_cast<TlsContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+	auto* tls = static_cast<TlsSession*>(SSL_get_app_data(ssl));
+	if (ctx == nullptr || tls == nullptr)
+	{
+		return 0;
+	}
+	ctx->saveSession(tls->key(), session);
+	return 1;
+}
+
+std::shared_ptr<TlsContext> newClient(SSL_CTX* ctx)
+{
+	// 会话由 TlsContext 按 key 保存，不使用 OpenSSL 内部缓存
+	SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT |
+											SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(ctx, newClientSession);
+	return std::make_shared<TlsContext>(ctx, false);
+}
+} // namespace
+
+std::shared_ptr<TlsContext> TlsContext::server(const std::string& cert_file,
+											   const std::string& key_file)
+{
+	SSL_CTX* ctx = newContext(TLS_server_method());
+	if (ctx == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (SSL_CTX_use_certificate_chain_file(ctx, cert_file.c_str()) != 1 ||
+		SSL_CTX_use_PrivateKey_file(ctx, key_file.c_str(), SSL_FILETYPE_PEM) !=
+			1 ||
+		SSL_CTX_check_private_key(ctx) != 1)
+	{
+		LOG_ERROR << "load certificate " << cert_file << " failed: "
+				  << sslError();
+		SSL_CTX_free(ctx);
+		return nullptr;
+	}
+
+	static const unsigned char kSessionIdContext[] = "lynx";
+	SSL_CTX_set_session_id_context(ctx, kSessionIdContext,
+								   sizeof(kSessionIdContext) - 1);
+	SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+	SSL_CTX_sess_set_cache_size(ctx, 20480);
+	return std::make_shared<TlsContext>(ctx, true);
+}
+
+std::shared_ptr<TlsContext> TlsContext::client(const std::string& ca_file)
+{
+	SSL_CTX* ctx = newContext(TLS_client_method());
+	if (ctx == nullptr)
+	{
+		return nullptr;
+	}
+
+	int ok = ca_file.empty()
+				 ? SSL_CTX_set_default_verify_paths(ctx)
+				 : SSL_CTX_load_verify_locations(ctx, ca_file.c_str(), nullptr);
+	if (ok != 1)
+	{
+		LOG_ERROR << "load CA " << (ca_file.empty() ? "<default>" : ca_file)
+				  << " failed: " << sslError();
+		SSL_CTX_free(ctx);
+		return nullptr;
+	}
+	SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+	return newClient(ctx);
+}
+
+std::shared_ptr<TlsContext> TlsContext::insecureClient()
+{
+	SSL_CTX* ctx = newContext(TLS_client_method());
+	if (ctx == nullptr)
+	{
+		return nullptr;
+	}
+
+	LOG_WARN << "TLS client context without certificate verification";
+	SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+	return newClient(ctx);
+}
+
+TlsContext::TlsContext(SSL_CTX* ctx, bool server) : ctx_(ctx), server_(server)
+{
+	SSL_CTX_set_app_data(ctx_, this);
+}
+
+TlsContext::~TlsContext()
+{
+	for (auto& item : sessions_)
+	{
+		SSL_SESSION_free(item.second);
+	}
+	SSL_CTX_free(ctx_);
+}
+
+SSL_SESSION* TlsContext::session(const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	auto it = sessions_.find(key);
+	if (it == sessions_.end())
+	{
+		return nullptr;
+	}
+	// TLS 1.3 的会话票据只用一次，取出后删除，新连接会收到新票据
+	SSL_SESSION* session = it->second;
+	sessions_.erase(it);
+	return session;
+}
+
+void TlsContext::saveSession(const std::string& key, SSL_SESSION* session)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	SSL_SESSION*& slot = sessions_[key];
+	if (slot != nullptr)
+	{
+		SSL_SESSION_free(slot);
+	}
+	slot = session;
+}
+
+TlsSession::TlsSession(std::shared_ptr<TlsContext> ctx, int fd,
+					   const std::string& server_name,
+					   const std::string& session_key)
+	: ctx_(std::move(ctx)), ssl_(SSL_new(ctx_->native())), key_(session_key),
+	  established_(false), ktls_send_(false), ktls_recv_(false)
+{
+	// socket BIO 不关闭 fd，fd 仍归 Channel 所有
+	SSL_set_fd(ssl_, fd);
+	SSL_set_app_data(ssl_, this);
+
+	if (ctx_->isServer())
+	{
+		SSL_set_accept_state(ssl_);
+		return;
+	}
+
+	SSL_set_connect_state(ssl_);
+	if (!server_name.empty())
+	{
+		SSL_set_tlsext_host_name(ssl_, server_name.c_str());
+		if (SSL_get_verify_mode(ssl_) & SSL_VERIFY_PEER)
+		{
+			SSL_set1_host(ssl_, server_name.c_str());
+		}
+	}
+
+	if (SSL_SESSION* session = ctx_->session(key_))
+	{
+		SSL_set_session(ssl_, session);
+		SSL_SESSION_free(session);
+	}
+}
+
+TlsSession::~TlsSession()
+{
+	SSL_free(ssl_);
+}
+
+TlsSession::Result TlsSession::handshake()
+{
+	ERR_clear_error();
+	int ret = SSL_do_handshake(ssl_);
+	if (ret == 1)
+	{
+		established_ = true;
+		ktls_send_ = BIO_get_ktls_send(SSL_get_wbio(ssl_));
+		ktls_recv_ = BIO_get_ktls_recv(SSL_get_rbio(ssl_));
+		(resumed() ? resumed_metric : full_metric).inc();
+		if (ktls_send_)
+		{
+			ktls_metric.inc();
+		}
+		LOG_DEBUG << "TLS handshake done: " << SSL_get_version(ssl_) << " "
+				  << SSL_get_cipher_name(ssl_) << (resumed() ? " resumed" : "")
+				  << (ktls_send_ ? " ktls" : "");
+		return Result::kDone;
+	}
+
+	switch (SSL_get_error(ssl_, ret))
+	{
+	case SSL_ERROR_WANT_READ:
+		return Result::kWantRead;
+	case SSL_ERROR_WANT_WRITE:
+		return Result::kWantWrite;
+	default:
+		LOG_WARN << "TLS handshake failed: " << sslError();
+		failed_metric.inc();
+		return Result::kError;
+	}
+}
+
+ssize_t TlsSession::read(char* buf, size_t len, int* saved_errno)
+{
+	ERR_clear_error();
+	return result(SSL_read(ssl_, buf, static_cast<int>(len)), saved_errno);
+}
+
+ssize_t TlsSession::write(const char* data, size_t len, int* saved_errno)
+{
+	ERR_clear_error();
+	return result(SSL_write(ssl_, data, static_cast<int>(len)), saved_errno);
+}
+
+void TlsSession::shutdown()
+{
+	if (established_)
+	{
+		ERR_clear_error();
+		SSL_shutdown(ssl_);
+	}
+}
+
+bool TlsSession::resumed() const
+{
+	return SSL_session_reused(ssl_) == 1;
+}
+
+ssize_t TlsSession::result(int ret, int* saved_errno)
+{
+	if (ret > 0)
+	{
+		return ret;
+	}
+
+	switch (SSL_get_error(ssl_, ret))
+	{
+	case SSL_ERROR_WANT_READ:
+	case SSL_ERROR_WANT_WRITE:
+		*saved_errno = EAGAIN;
+		return -1;
+	case SSL_ERROR_ZERO_RETURN:
+		return 0;
+	case SSL_ERROR_SYSCALL:
+		*saved_errno = errno != 0 ? errno : EIO;
+		return -1;
+	default:
+		LOG_WARN << "TLS error: " << sslError();
+		*saved_errno = EIO;
+		return -1;
+	}
+}
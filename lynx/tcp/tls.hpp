@@ -0,0 +1,126 @@
+#ifndef LYNX_TCP_TLS_HPP
+#define LYNX_TCP_TLS_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+
+typedef struct ssl_ctx_st SSL_CTX;
+typedef struct ssl_st SSL;
+typedef struct ssl_session_st SSL_SESSION;
+
+namespace lynx
+{
+namespace tcp
+{
+// 一组证书与 TLS 参数，所有连接共享同一个 SSL_CTX：服务端的会话缓存与
+// 会话票据密钥因此在各 sub reactor 之间共享，任一线程上的连接都能恢复会话。
+// 握手完成后若内核支持则启用 kTLS，由内核加解密
+class TlsContext : public base::noncopyable
+{
+  private:
+	SSL_CTX* ctx_;
+	bool server_;
+
+	// 客户端按对端缓存的会话，用于重连时恢复
+	std::mutex mtx_;
+	std::unordered_map<std::string, SSL_SESSION*> sessions_;
+
+  public:
+	// 证书链与私钥均为 PEM 文件，加载失败返回 nullptr
+	static std::shared_ptr<TlsContext> server(const std::string& cert_file,
+											  const std::string& key_file);
+	// 校验服务端证书，ca_file 为空时使用系统默认的 CA
+	static std::shared_ptr<TlsContext> client(const std::string& ca_file = "");
+	// 不校验服务端证书，连接可被中间人劫持，仅用于测试等明确需要的场合
+	static std::shared_ptr<TlsContext> insecureClient();
+
+	TlsContext(SSL_CTX* ctx, bool server);
+	~TlsContext();
+
+	SSL_CTX* native() const
+	{
+		return ctx_;
+	}
+
+	bool isServer() const
+	{
+		return server_;
+	}
+
+	// 取出 key 对应的会话（引用计数已加一），没有时返回 nullptr
+	SSL_SESSION* session(const std::string& key);
+	// 接管 session 的引用
+	void saveSession(const std::string& key, SSL_SESSION* session);
+};
+
+// 单个连接上的 TLS 状态，只在连接所在的 loop 线程中使用
+class TlsSession : public base::noncopyable
+{
+  private:
+	std::shared_ptr<TlsContext> ctx_;
+	SSL* ssl_;
+	std::string key_;
+	bool established_;
+	bool ktls_send_;
+	bool ktls_recv_;
+
+  public:
+	enum class Result
+	{
+		kDone,
+		kWantRead,
+		kWantWrite,
+		kError
+	};
+
+	// 客户端：server_name 用于 SNI 与证书校验，可以为空；
+	// session_key 为会话缓存的 key，通常为对端地址
+	TlsSession(std::shared_ptr<TlsContext> ctx, int fd,
+			   const std::string& server_name, const std::string& session_key);
+	~TlsSession();
+
+	Result handshake();
+
+	// 与 read/write 相同的返回约定：无数据可读或不可写时返回 -1 且
+	// saved_errno 为 EAGAIN；对端关闭返回 0；协议错误返回 -1 且为 EIO
+	ssize_t read(char* buf, size_t len, int* saved_errno);
+	ssize_t write(const char* data, size_t len, int* saved_errno);
+
+	// 发送 close_notify
+	void shutdown();
+
+	bool established() const
+	{
+		return established_;
+	}
+
+	// 发送方向已交给内核，可直接 write/sendfile 明文
+	bool ktlsSend() const
+	{
+		return ktls_send_;
+	}
+
+	bool ktlsRecv() const
+	{
+		return ktls_recv_;
+	}
+
+	bool resumed() const;
+
+	const std::string& key() const
+	{
+		return key_;
+	}
+
+  private:
+	ssize_t result(int ret, int* saved_errno);
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
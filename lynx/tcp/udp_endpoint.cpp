@@ -0,0 +1,339 @@
+#include "lynx/tcp/udp_endpoint.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/channel.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/socket.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <strings.h>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+namespace
+{
+metrics::Counter droppedCounter(const std::string& name,
+								const std::string& reason)
+{
+	return metrics::Registry::instance().counter(
+		"lynx_udp_datagrams_dropped_total", "Dropped UDP datagrams",
+		{{"endpoint", name}, {"reason", reason}});
+}
+} // namespace
+
+UdpEndpoint::UdpEndpoint(EventLoop* loop, const InetAddr& local_addr,
+						 const std::string& name, bool reuse_port)
+	: loop_(loop), name_(name), local_addr_(local_addr), gro_(false),
+	  gso_(false), pool_(kBatch * kMaxDatagram), out_head_(0),
+	  flush_queued_(false)
+{
+	metrics::Registry& registry = metrics::Registry::instance();
+	received_metric_ = registry.counter("lynx_udp_datagrams_received_total",
+										"Received UDP datagrams",
+										{{"endpoint", name_}});
+	sent_metric_ =
+		registry.counter("lynx_udp_datagrams_sent_total",
+						 "Sent UDP datagrams", {{"endpoint", name_}});
+	truncated_metric_ = droppedCounter(name_, "truncated");
+	overflow_metric_ = droppedCounter(name_, "overflow");
+	error_metric_ = droppedCounter(name_, "error");
+
+	int fd = ::socket(local_addr.family(),
+					  SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd == -1)
+	{
+		LOG_FATAL << "create udp socket failed: " << ::strerror(errno);
+		exit(EXIT_FAILURE);
+	}
+
+	Socket::setReuseAddr(fd);
+	if (reuse_port)
+	{
+		Socket::setReusePort(fd);
+	}
+	if (local_addr.isIpv6())
+	{
+		Socket::setIpv6Only(fd, false);
+	}
+
+	int saved_errno = 0;
+	Socket::bind(fd, local_addr, &saved_errno);
+	checkErrno(saved_errno);
+
+	socklen_t len = InetAddr::capacity();
+	if (::getsockname(fd, local_addr_.sockaddr(), &len) == 0)
+	{
+		local_addr_.setLength(len);
+	}
+
+	// 能读取 UDP_SEGMENT 说明内核支持 GSO（4.18+）
+	int segment = 0;
+	len = sizeof(segment);
+	gso_ = ::getsockopt(fd, SOL_UDP, UDP_SEGMENT, &segment, &len) == 0;
+
+	// 接收用的 iovec 与 msghdr 固定指向缓冲池，每次 recvmmsg 只需重置长度
+	for (size_t i = 0; i < kBatch; ++i)
+	{
+		recv_iovs_[i].iov_base = pool_.data() + i * kMaxDatagram;
+		recv_iovs_[i].iov_len = kMaxDatagram;
+	}
+
+	ch_ = std::make_unique<Channel>(fd, loop);
+	ch_->setReadCallback(std::bind(&UdpEndpoint::handleRead, this));
+	ch_->setWriteCallback(std::bind(&UdpEndpoint::handleWrite, this));
+}
+
+UdpEndpoint::~UdpEndpoint()
+{
+}
+
+void UdpEndpoint::enableGro(bool on)
+{
+	int optval = on ? 1 : 0;
+	if (::setsockopt(ch_->fd(), SOL_UDP, UDP_GRO, &optval, sizeof(optval)) ==
+		-1)
+	{
+		LOG_WARN << "setsockopt(UDP_GRO) failed for fd " << ch_->fd() << ": "
+				 << ::strerror(errno);
+		return;
+	}
+	gro_ = on;
+}
+
+void UdpEndpoint::start()
+{
+	loop_->assertInLoopThread();
+	ch_->tie(shared_from_this());
+	ch_->enableIN();
+}
+
+void UdpEndpoint::stop()
+{
+	loop_->assertInLoopThread();
+	if (ch_->inEpoll())
+	{
+		ch_->disableAll();
+		ch_->remove();
+	}
+}
+
+void UdpEndpoint::handleRead()
+{
+	loop_->assertInLoopThread();
+
+	for (size_t i = 0; i < kBatch; ++i)
+	{
+		msghdr& hdr = recv_hdrs_[i].msg_hdr;
+		hdr.msg_name = recv_peers_[i].sockaddr();
+		hdr.msg_namelen = InetAddr::capacity();
+		hdr.msg_iov = &recv_iovs_[i];
+		hdr.msg_iovlen = 1;
+		hdr.msg_control = gro_ ? recv_ctrls_[i].data() : nullptr;
+		hdr.msg_controllen = gro_ ? recv_ctrls_[i].size() : 0;
+		hdr.msg_flags = 0;
+	}
+
+	int n = ::recvmmsg(ch_->fd(), recv_hdrs_.data(), kBatch, MSG_DONTWAIT,
+					   nullptr);
+	if (n == -1)
+	{
+		if (errno != EAGAIN && errno != EINTR)
+		{
+			LOG_ERROR << "recvmmsg failed for fd " << ch_->fd() << ": "
+					  << ::strerror(errno);
+		}
+		return;
+	}
+
+	for (int i = 0; i < n; ++i)
+	{
+		msghdr& hdr = recv_hdrs_[i].msg_hdr;
+		if (hdr.msg_flags & MSG_TRUNC)
+		{
+			truncated_metric_.inc();
+			continue;
+		}
+
+		int segment = 0;
+		if (gro_)
+		{
+			for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg;
+				 cmsg = CMSG_NXTHDR(&hdr, cmsg))
+			{
+				if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+				{
+					::memcpy(&segment, CMSG_DATA(cmsg), sizeof(segment));
+				}
+			}
+		}
+
+		recv_peers_[i].setLength(hdr.msg_namelen);
+		deliver(std::string_view(static_cast<char*>(recv_iovs_[i].iov_base),
+								 recv_hdrs_[i].msg_len),
+				recv_peers_[i], segment);
+	}
+}
+
+void UdpEndpoint::deliver(std::string_view data, const InetAddr& peer,
+						  int segment)
+{
+	// GRO 合并的数据报按 segment 长度切回，最后一个可能较短
+	size_t step = segment > 0 ? static_cast<size_t>(segment) : data.size();
+	do
+	{
+		std::string_view datagram = data.substr(0, step);
+		data.remove_prefix(datagram.size());
+		received_metric_.inc();
+		if (message_callback_)
+		{
+			message_callback_(this, datagram, peer);
+		}
+	} while (!data.empty());
+}
+
+void UdpEndpoint::send(const InetAddr& peer, std::string_view data,
+					   size_t segment)
+{
+	if (loop_->InLoopThread())
+	{
+		sendInLoop(peer, data, segment);
+	}
+	else
+	{
+		loop_->runInLoop(
+			[self = shared_from_this(), peer, copy = std::string(data),
+			 segment]() { self->sendInLoop(peer, copy, segment); });
+	}
+}
+
+void UdpEndpoint::sendInLoop(const InetAddr& peer, std::string_view data,
+							 size_t segment)
+{
+	loop_->assertInLoopThread();
+	if (out_buf_.size() + data.size() > kMaxPendingBytes)
+	{
+		overflow_metric_.inc(segment > 0 ? (data.size() + segment - 1) / segment
+										 : 1);
+		return;
+	}
+
+	if (segment >= data.size())
+	{
+		segment = 0;
+	}
+
+	// 内核不支持 GSO，或超出单次 GSO 的段数与长度上限时在用户态切分
+	if (segment > 0 && (!gso_ || data.size() > kMaxGsoBytes ||
+						data.size() > segment * kMaxGsoSegments))
+	{
+		for (size_t off = 0; off < data.size(); off += segment)
+		{
+			out_queue_.push_back({peer, out_buf_.size() + off,
+								  std::min(segment, data.size() - off), 0});
+		}
+	}
+	else
+	{
+		out_queue_.push_back({peer, out_buf_.size(), data.size(),
+							  static_cast<uint16_t>(segment)});
+	}
+	out_buf_.append(data);
+
+	// 同一轮 loop 中的发送合并到一次 sendmmsg
+	if (!flush_queued_ && !ch_->writing())
+	{
+		flush_queued_ = true;
+		loop_->queueInLoop(
+			[weak = weak_from_this()]()
+			{
+				if (auto self = weak.lock())
+				{
+					self->flush_queued_ = false;
+					self->flush();
+				}
+			});
+	}
+}
+
+void UdpEndpoint::handleWrite()
+{
+	flush();
+}
+
+void UdpEndpoint::flush()
+{
+	loop_->assertInLoopThread();
+
+	while (out_head_ < out_queue_.size())
+	{
+		size_t n = std::min(kBatch, out_queue_.size() - out_head_);
+		for (size_t i = 0; i < n; ++i)
+		{
+			Outgoing& out = out_queue_[out_head_ + i];
+			send_iovs_[i].iov_base = out_buf_.data() + out.offset;
+			send_iovs_[i].iov_len = out.len;
+
+			msghdr& hdr = send_hdrs_[i].msg_hdr;
+			::bzero(&hdr, sizeof(hdr));
+			hdr.msg_name = out.peer.sockaddr();
+			hdr.msg_namelen = out.peer.length();
+			hdr.msg_iov = &send_iovs_[i];
+			hdr.msg_iovlen = 1;
+			if (out.segment > 0)
+			{
+				hdr.msg_control = send_ctrls_[i].data();
+				hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+				cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+				cmsg->cmsg_level = SOL_UDP;
+				cmsg->cmsg_type = UDP_SEGMENT;
+				cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+				::memcpy(CMSG_DATA(cmsg), &out.segment, sizeof(uint16_t));
+			}
+		}
+
+		int sent = ::sendmmsg(ch_->fd(), send_hdrs_.data(), n, MSG_DONTWAIT);
+		if (sent == -1)
+		{
+			if (errno == EAGAIN || errno == ENOBUFS)
+			{
+				// 发送缓冲区满，等可写后继续
+				if (!ch_->writing())
+				{
+					ch_->enableOUT();
+				}
+				return;
+			}
+			if (errno != EINTR)
+			{
+				// 只影响队首的数据报（如对端不可达），丢弃后继续
+				LOG_WARN << "sendmmsg to "
+						 << out_queue_[out_head_].peer.toFormattedString()
+						 << " failed: " << ::strerror(errno);
+				error_metric_.inc();
+				++out_head_;
+			}
+			continue;
+		}
+
+		for (int i = 0; i < sent; ++i)
+		{
+			const Outgoing& out = out_queue_[out_head_ + i];
+			sent_metric_.inc(out.segment > 0
+								 ? (out.len + out.segment - 1) / out.segment
+								 : 1);
+		}
+		out_head_ += sent;
+	}
+
+	out_queue_.clear();
+	out_buf_.clear();
+	out_head_ = 0;
+	if (ch_->writing())
+	{
+		ch_->disableOUT();
+	}
+}
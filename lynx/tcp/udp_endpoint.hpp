@@ -0,0 +1,142 @@
+#ifndef LYNX_TCP_UDP_ENDPOINT_HPP
+#define LYNX_TCP_UDP_ENDPOINT_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/metrics/registry.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class Channel;
+// 一个 UDP socket，收发都按批进行：一次 recvmmsg 最多收 kBatch 个数据报，
+// 同一轮 loop 中的 send 在 loop 末尾合并为 sendmmsg。
+// 收到的数据直接指向预分配的缓冲池，只在回调期间有效
+class UdpEndpoint : public base::noncopyable,
+					public std::enable_shared_from_this<UdpEndpoint>
+{
+  public:
+	static constexpr size_t kBatch = 32;
+	// 开启 GRO 时内核可能把多个数据报合并成一个，最大 64KB
+	static constexpr size_t kMaxDatagram = 65536;
+	static constexpr size_t kMaxPendingBytes = 4 * 1024 * 1024;
+	static constexpr size_t kMaxGsoSegments = 64;
+	static constexpr size_t kMaxGsoBytes = 65507;
+
+	using message_callback =
+		std::function<void(UdpEndpoint*, std::string_view, const InetAddr&)>;
+
+  private:
+	struct Outgoing
+	{
+		InetAddr peer;
+		size_t offset;
+		size_t len;
+		uint16_t segment; // 非 0 时使用 GSO 按此长度切分
+	};
+
+	using Control = std::array<char, CMSG_SPACE(sizeof(int))>;
+
+	EventLoop* loop_;
+	const std::string name_;
+	InetAddr local_addr_;
+	std::unique_ptr<Channel> ch_;
+	bool gro_;
+	bool gso_;
+
+	// 接收缓冲池：kBatch 个 kMaxDatagram 大小的槽，构造时分配一次
+	std::vector<char> pool_;
+	std::array<mmsghdr, kBatch> recv_hdrs_;
+	std::array<iovec, kBatch> recv_iovs_;
+	std::array<InetAddr, kBatch> recv_peers_;
+	std::array<Control, kBatch> recv_ctrls_;
+
+	std::string out_buf_;
+	std::vector<Outgoing> out_queue_;
+	size_t out_head_;
+	bool flush_queued_;
+	std::array<mmsghdr, kBatch> send_hdrs_;
+	std::array<iovec, kBatch> send_iovs_;
+	std::array<Control, kBatch> send_ctrls_;
+
+	message_callback message_callback_;
+
+	metrics::Counter received_metric_;
+	metrics::Counter sent_metric_;
+	metrics::Counter truncated_metric_;
+	metrics::Counter overflow_metric_;
+	metrics::Counter error_metric_;
+
+  public:
+	// reuse_port 为 true 时多个 endpoint 可绑定同一地址，由内核按四元组分流
+	UdpEndpoint(EventLoop* loop, const InetAddr& local_addr,
+				const std::string& name, bool reuse_port = false);
+	~UdpEndpoint();
+
+	void setMessageCallback(message_callback cb)
+	{
+		message_callback_ = std::move(cb);
+	}
+
+	// 接收端合并（UDP_GRO），回调中仍按原始数据报逐个交付
+	void enableGro(bool on = true);
+
+	// 发送端是否支持 UDP_SEGMENT，不支持时 send 在用户态切分
+	bool gsoSupported() const
+	{
+		return gso_;
+	}
+
+	// 在 loop 线程中开始/停止接收，析构前须先 stop
+	void start();
+	void stop();
+
+	// segment 非 0 时 data 按 segment 字节切成多个数据报，内核支持时
+	// 一次系统调用发出（GSO）。非 loop 线程调用时会复制 data。
+	// 待发送数据超过 kMaxPendingBytes 时丢弃
+	void send(const InetAddr& peer, std::string_view data, size_t segment = 0);
+
+	// 绑定端口为 0 时为内核分配的实际地址
+	const InetAddr& localAddr() const
+	{
+		return local_addr_;
+	}
+
+	size_t pendingBytes() const
+	{
+		return out_buf_.size();
+	}
+
+	EventLoop* loop() const
+	{
+		return loop_;
+	}
+
+	const std::string& name() const
+	{
+		return name_;
+	}
+
+  private:
+	void handleRead();
+	void handleWrite();
+	void sendInLoop(const InetAddr& peer, std::string_view data,
+					size_t segment);
+	void flush();
+	void deliver(std::string_view data, const InetAddr& peer, int segment);
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
@@ -0,0 +1,52 @@
+#include "lynx/tcp/udp_server.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/event_loop_thread_pool.hpp"
+#include <memory>
+
+using namespace lynx;
+using namespace lynx::tcp;
+
+UdpServer::UdpServer(EventLoop* loop, const InetAddr& addr,
+					 const std::string& name, size_t sub_reactor_num)
+	: main_reactor_(loop), addr_(addr), name_(name),
+	  sub_reactor_pool_(
+		  std::make_unique<EventLoopThreadPool>(loop, sub_reactor_num)),
+	  gro_(false)
+{
+}
+
+UdpServer::~UdpServer()
+{
+	main_reactor_->assertInLoopThread();
+	// 各 endpoint 在自己的 loop 中停止，回调执行完之前由 shared_ptr 保活
+	for (const std::shared_ptr<UdpEndpoint>& ep : endpoints_)
+	{
+		ep->loop()->runInLoop([ep]() { ep->stop(); });
+	}
+}
+
+void UdpServer::run()
+{
+	main_reactor_->assertInLoopThread();
+	sub_reactor_pool_->run();
+
+	// 端口为 0 时后续 endpoint 绑定第一个分到的端口
+	InetAddr addr = addr_;
+	for (EventLoop* l : sub_reactor_pool_->allLoops())
+	{
+		auto ep = std::make_shared<UdpEndpoint>(l, addr, name_, true);
+		addr = ep->localAddr();
+		ep->setMessageCallback(message_callback_);
+		if (gro_)
+		{
+			ep->enableGro();
+		}
+		l->runInLoop([ep]() { ep->start(); });
+		endpoints_.push_back(std::move(ep));
+	}
+
+	LOG_INFO << "UdpServer [" << name_ << "] listening on "
+			 << addr.toFormattedString() << " with " << endpoints_.size()
+			 << " sockets";
+}
@@ -0,0 +1,57 @@
+#ifndef LYNX_TCP_UDP_SERVER_HPP
+#define LYNX_TCP_UDP_SERVER_HPP
+
+#include "lynx/base/noncopyable.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/udp_endpoint.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+namespace lynx
+{
+namespace tcp
+{
+class EventLoop;
+class EventLoopThreadPool;
+// 在每个 sub reactor 上各绑定一个 SO_REUSEPORT 的 UdpEndpoint，
+// 由内核按对端地址把数据报分到不同线程；没有 sub reactor 时只在主 loop 上收发
+class UdpServer : public base::noncopyable
+{
+  private:
+	EventLoop* main_reactor_;
+	InetAddr addr_;
+	const std::string name_;
+	std::unique_ptr<EventLoopThreadPool> sub_reactor_pool_;
+	std::vector<std::shared_ptr<UdpEndpoint>> endpoints_;
+	UdpEndpoint::message_callback message_callback_;
+	bool gro_;
+
+  public:
+	UdpServer(EventLoop* loop, const InetAddr& addr, const std::string& name,
+			  size_t sub_reactor_num);
+	~UdpServer();
+
+	// 回调在收到数据报的 endpoint 所在线程中执行，回复用 endpoint->send
+	void setMessageCallback(UdpEndpoint::message_callback cb)
+	{
+		message_callback_ = std::move(cb);
+	}
+
+	void enableGro(bool on = true)
+	{
+		gro_ = on;
+	}
+
+	void run();
+
+	const std::vector<std::shared_ptr<UdpEndpoint>>& endpoints() const
+	{
+		return endpoints_;
+	}
+};
+} // namespace tcp
+} // namespace lynx
+
+#endif
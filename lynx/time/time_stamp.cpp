@@ -28,6 +28,15 @@ TimeStamp TimeStamp::now()
 	return TimeStamp(micro_seconds);
 }
 
+TimeStamp TimeStamp::monotonic(bool coarse)
+{
+	timespec ts;
+	::clock_gettime(coarse ? CLOCK_MONOTONIC_COARSE : CLOCK_MONOTONIC, &ts);
+
+	return TimeStamp(static_cast<int64_t>(ts.tv_sec) * kMicroSecond2Second +
+					 ts.tv_nsec / 1000);
+}
+
 TimeStamp TimeStamp::addTime(TimeStamp time_stamp, double add_seconds)
 {
 	int64_t delta = static_cast<int64_t>(add_seconds * kMicroSecond2Second);
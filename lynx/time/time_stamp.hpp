@@ -25,6 +25,9 @@ class TimeStamp
 	~TimeStamp() = default;
 
 	static TimeStamp now();
+	// 单调时钟，不受系统时间调整影响，用于定时器与计算时间间隔。
+	// coarse 为 true 时使用 CLOCK_MONOTONIC_COARSE，精度为一个 tick（1~4ms）
+	static TimeStamp monotonic(bool coarse = false);
 	static TimeStamp addTime(TimeStamp time_stamp, double add_seconds);
 
 	std::string toFormattedString(bool date = true, bool time = true) const;
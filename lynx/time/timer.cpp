@@ -2,7 +2,6 @@
 #include "lynx/time/time_stamp.hpp"
 #include <atomic>
 #include <cstdint>
-#include <functional>
 #include <utility>
 
 namespace lynx
@@ -16,12 +15,32 @@ std::atomic<uint64_t> Timer::id_creator_(1);
 using namespace lynx;
 using namespace lynx::time;
 
-Timer::Timer(TimeStamp expiration, std::function<void()> cb, double interval)
-	: expiration_(expiration), callback_(std::move(cb)), interval_(interval),
-	  repeating_(interval > 0.0), on_(false)
+Timer::Timer()
+	: interval_(0.0), repeating_(false), id_(0), heap_index_(kNotInHeap),
+	  on_(false)
 {
 }
 
 Timer::~Timer()
 {
-}
\ No newline at end of file
+}
+
+void Timer::repeat(TimeStamp now)
+{
+	int64_t step = static_cast<int64_t>(interval_ * kMicroSecond2Second);
+	if (step <= 0)
+	{
+		step = 1;
+	}
+
+	int64_t next = expiration_.microseconds() + step;
+	if (next <= now.microseconds())
+	{
+		next += ((now.microseconds() - next) / step + 1) * step;
+	}
+	expiration_ = TimeStamp(next);
+}
+bool TimerId::isAlive() const
+{
+	return timer_ != nullptr && id_ != 0 && timer_->id() == id_;
+}
@@ -3,28 +3,37 @@
 
 #include "lynx/base/noncopyable.hpp"
 #include "lynx/time/time_stamp.hpp"
+#include "lynx/time/timer_id.hpp"
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <utility>
 namespace lynx
 {
 namespace time
 {
+// TimerQueue 池中的定时器节点，回收后重复使用
 class Timer : public base::noncopyable
 {
   private:
+	friend class TimerQueue;
+
+	static constexpr size_t kNotInHeap = static_cast<size_t>(-1);
+
 	TimeStamp expiration_;
 	double interval_;
 	bool repeating_;
 	static std::atomic<uint64_t> id_creator_;
-	// int64_t id_;
+	// 0 表示节点空闲；TimerId::isAlive 可能在其他线程读取
+	std::atomic<uint64_t> id_;
+	size_t heap_index_;
 
 	bool on_;
 
-	std::function<void()> callback_;
+	TimerCallback callback_;
 
   public:
-	Timer(TimeStamp expiration, std::function<void()> cb, double interval);
+	Timer();
 	~Timer();
 
 	bool repeating() const
@@ -32,10 +41,10 @@ class Timer : public base::noncopyable
 		return repeating_;
 	}
 
-	// int64_t seq() const
-	// {
-	// 	return seq_;
-	// }
+	uint64_t id() const
+	{
+		return id_.load(std::memory_order_relaxed);
+	}
 
 	static uint64_t generateId()
 	{
@@ -57,17 +66,33 @@ class Timer : public base::noncopyable
 		return expiration_;
 	}
 
-	void run() const
+	void run()
 	{
 		callback_();
 	}
 
-	void repeat()
+	// 从上一次的到期时刻推进一个周期，回调耗时不会累积为漂移；
+	// 落后超过一个周期时跳过错过的周期，不连续补触发
+	void repeat(TimeStamp now);
+
+  private:
+	void init(TimeStamp expiration, TimerCallback&& cb, double interval)
+	{
+		expiration_ = expiration;
+		interval_ = interval;
+		repeating_ = interval > 0.0;
+		callback_ = std::move(cb);
+		on_ = true;
+		id_.store(generateId(), std::memory_order_relaxed);
+	}
+
+	void clear()
 	{
-		expiration_ = TimeStamp::addTime(TimeStamp::now(), interval_);
+		id_.store(0, std::memory_order_relaxed);
+		callback_.reset();
 	}
 };
 } // namespace time
 } // namespace lynx
 
-#endif
\ No newline at end of file
+#endif
@@ -1,40 +1,42 @@
 #ifndef LYNX_TIME_TIMER_ID_HPP
 #define LYNX_TIME_TIMER_ID_HPP
 
+#include "lynx/base/inline_function.hpp"
 #include <cstdint>
-#include <memory>
 namespace lynx
 {
 namespace time
 {
+// 定时器回调，48 字节以内的 lambda 存放在定时器节点内部，不分配内存
+using TimerCallback = base::InlineFunction<void()>;
+
 class Timer;
+// 指向 TimerQueue 池中的节点与注册时的序号。节点回收后序号清零，
+// 复用后序号不同，旧的 TimerId 随之失效。只在所属 EventLoop 存活期间使用
 class TimerId
 {
-	// friend class TimerQueue;
-
   private:
-	std::weak_ptr<Timer> timer_;
+	Timer* timer_;
 	uint64_t id_;
 
   public:
-	TimerId() : id_(0)
+	TimerId() : timer_(nullptr), id_(0)
 	{
 	}
 
-	TimerId(std::weak_ptr<Timer> timer, uint64_t id) : timer_(timer), id_(id)
+	TimerId(Timer* timer, uint64_t id) : timer_(timer), id_(id)
 	{
 	}
 
 	TimerId(const TimerId&) = default;
+	TimerId& operator=(const TimerId&) = default;
 
-	bool isAlive() const
-	{
-		return !timer_.expired();
-	}
+	// 已注册且尚未到期（重复定时器未取消）
+	bool isAlive() const;
 
-	std::shared_ptr<Timer> timer() const
+	Timer* timer() const
 	{
-		return timer_.lock();
+		return timer_;
 	}
 
 	uint64_t id() const
@@ -45,4 +47,4 @@ class TimerId
 } // namespace time
 } // namespace lynx
 
-#endif
\ No newline at end of file
+#endif
@@ -5,13 +5,16 @@
 #include "lynx/time/time_stamp.hpp"
 #include "lynx/time/timer.hpp"
 #include "lynx/time/timer_id.hpp"
+#include <algorithm>
 #include <cerrno>
 #include <cstdint>
 #include <cstring>
 #include <ctime>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <sys/timerfd.h>
+#include <utility>
 
 using namespace lynx;
 using namespace lynx::time;
@@ -29,40 +32,87 @@ TimerQueue::~TimerQueue()
 	ch_->disableAll();
 	ch_->remove();
 
-	timers_.clear();
+	heap_.clear();
 }
 
-TimerId TimerQueue::addTimer(TimeStamp time_stamp,
-							 const std::function<void()>& cb, double interval)
+TimerId TimerQueue::addTimer(TimeStamp time_stamp, TimerCallback cb,
+							 double interval)
 {
-	auto timer = std::make_shared<Timer>(time_stamp, cb, interval);
-	loop_->runInLoop(std::bind(&TimerQueue::addTimerInLoop, this, timer));
+	Timer* timer = acquire();
+	timer->init(time_stamp, std::move(cb), interval);
+	TimerId timer_id(timer, timer->id());
 
-	return TimerId(timer, Timer::generateId());
+	if (loop_->InLoopThread())
+	{
+		if (insert(timer))
+		{
+			resetTimerFd();
+		}
+		return timer_id;
+	}
+
+	// 只有本批的第一个注册者投递任务，loop 在一次任务中取走整批
+	bool first = false;
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		first = pending_.empty();
+		pending_.push_back(timer);
+	}
+	if (first)
+	{
+		loop_->queueInLoop([this]() { addPending(); });
+	}
+
+	return timer_id;
 }
 
-void TimerQueue::addTimerInLoop(std::shared_ptr<Timer> timer)
+void TimerQueue::addPending()
 {
 	loop_->assertInLoopThread();
 
-	if (insert(timer))
 	{
-		resetTimerFd(timer);
+		std::lock_guard<std::mutex> lock(mtx_);
+		std::swap(adding_, pending_);
 	}
 
-	timer->setOn(true);
+	bool reset = false;
+	for (Timer* timer : adding_)
+	{
+		// 注册后、加入堆之前已被取消
+		if (!timer->on())
+		{
+			release(timer);
+		}
+		else if (insert(timer))
+		{
+			reset = true;
+		}
+	}
+	adding_.clear();
+
+	if (reset)
+	{
+		resetTimerFd();
+	}
 }
 
 void TimerQueue::cancell(TimerId timer_id)
 {
-	loop_->runInLoop(std::bind(&TimerQueue::cancellInLoop, this, timer_id));
+	if (loop_->InLoopThread())
+	{
+		cancellInLoop(timer_id);
+	}
+	else
+	{
+		loop_->queueInLoop([this, timer_id]() { cancellInLoop(timer_id); });
+	}
 }
 
 void TimerQueue::cancellInLoop(TimerId timer_id)
 {
 	loop_->assertInLoopThread();
 
-	auto timer = timer_id.timer();
+	Timer* timer = timer_id.timer();
 
 	if (timer_id.id() == 0)
 	{
@@ -76,7 +126,22 @@ void TimerQueue::cancellInLoop(TimerId timer_id)
 		return;
 	}
 
-	timer->setOn(false);
+	// 已到期或已取消，节点可能已被复用
+	if (timer->id() != timer_id.id())
+	{
+		return;
+	}
+
+	if (timer->heap_index_ != Timer::kNotInHeap)
+	{
+		remove(timer);
+		release(timer);
+	}
+	else
+	{
+		// 正在等待加入堆或本轮已到期，由持有者回收
+		timer->setOn(false);
+	}
 }
 
 void TimerQueue::readTimerFd()
@@ -95,64 +160,71 @@ void TimerQueue::handleRead()
 
 	readTimerFd();
 
-	auto max_shared_ptr = std::shared_ptr<Timer>(
-		reinterpret_cast<Timer*>(UINTPTR_MAX), [](Timer*) {});
-	auto end = timers_.upper_bound(Entry(TimeStamp::now(), max_shared_ptr));
-	active_timers_.insert(active_timers_.end(), timers_.begin(), end);
+	// 使用 loop 本轮缓存的时间。timerfd 已到期说明设定的时刻已过，
+	// 粗粒度时钟可能还没走到，取两者较大者
+	TimeStamp now = std::max(loop_->now(), armed_);
+	armed_ = TimeStamp();
 
-	timers_.erase(timers_.begin(), end);
-	for (auto& entry : active_timers_)
+	// 先取出本轮全部到期的定时器再执行，回调中新加的定时器留到下一轮
+	while (!heap_.empty() && heap_.front()->expiration() <= now)
 	{
-		auto timer = entry.second;
+		Timer* timer = heap_.front();
+		remove(timer);
+		active_timers_.push_back(timer);
+	}
 
+	for (Timer* timer : active_timers_)
+	{
 		if (timer->on())
 		{
 			timer->run();
 		}
 	}
-	resetTimer(); // sync
-}
 
-void TimerQueue::resetTimer()
-{
-	for (auto& entry : active_timers_)
+	for (Timer* timer : active_timers_)
 	{
-		auto timer = entry.second;
-
 		if (timer->on() && timer->repeating())
 		{
-			timer->repeat();
+			timer->repeat(now);
 			insert(timer);
 		}
+		else
+		{
+			release(timer);
+		}
 	}
-
 	active_timers_.clear();
 
-	if (!timers_.empty())
-	{
-		resetTimerFd(timers_.begin()->second);
-	}
+	resetTimerFd();
 }
 
-void TimerQueue::resetTimerFd(std::shared_ptr<Timer> timer)
+void TimerQueue::resetTimerFd()
 {
+	// 堆顶未变时不必重新设定
+	if (heap_.empty() || heap_.front()->expiration() == armed_)
+	{
+		return;
+	}
+
 	itimerspec value;
 	::bzero(&value, sizeof(value));
 
-	int64_t micro_seconds_diff =
-		timer->expiration().microseconds() - TimeStamp::now().microseconds();
-	if (micro_seconds_diff < 100)
+	// 到期时刻与 timerfd 同为 CLOCK_MONOTONIC，按绝对时间设定，
+	// 无需再读当前时间；已过期的时刻会立即触发
+	int64_t micro_seconds = heap_.front()->expiration().microseconds();
+	if (micro_seconds <= 0)
 	{
-		micro_seconds_diff = 100;
+		micro_seconds = 1;
 	}
+	armed_ = TimeStamp(micro_seconds);
 
 	value.it_value.tv_sec =
-		static_cast<time_t>(micro_seconds_diff / kMicroSecond2Second);
+		static_cast<time_t>(micro_seconds / kMicroSecond2Second);
 	// 纳秒
 	value.it_value.tv_nsec =
-		static_cast<long>(micro_seconds_diff % kMicroSecond2Second) * 1000;
+		static_cast<long>(micro_seconds % kMicroSecond2Second) * 1000;
 
-	int ret = ::timerfd_settime(ch_->fd(), 0, &value, nullptr);
+	int ret = ::timerfd_settime(ch_->fd(), TFD_TIMER_ABSTIME, &value, nullptr);
 	assert(ret != -1);
 	if (ret == -1)
 	{
@@ -161,18 +233,110 @@ void TimerQueue::resetTimerFd(std::shared_ptr<Timer> timer)
 	}
 }
 
-bool TimerQueue::insert(std::shared_ptr<Timer> timer)
+Timer* TimerQueue::acquire()
 {
-	bool reset_instantly = false;
+	std::lock_guard<std::mutex> lock(mtx_);
+	if (free_.empty())
+	{
+		nodes_.emplace_back();
+		return &nodes_.back();
+	}
+
+	Timer* timer = free_.back();
+	free_.pop_back();
+	return timer;
+}
+
+void TimerQueue::release(Timer* timer)
+{
+	// 在锁外析构回调，回调捕获的对象析构时可能再注册或取消定时器
+	timer->clear();
+
+	std::lock_guard<std::mutex> lock(mtx_);
+	free_.push_back(timer);
+}
 
-	if (timers_.empty() || timer->expiration() < timers_.begin()->first)
+namespace
+{
+// 到期时刻相同时先注册的在前
+bool earlier(const Timer* lhs, const Timer* rhs)
+{
+	if (lhs->expiration() != rhs->expiration())
 	{
-		reset_instantly = true;
+		return lhs->expiration() < rhs->expiration();
 	}
+	return lhs->id() < rhs->id();
+}
+} // namespace
+
+bool TimerQueue::insert(Timer* timer)
+{
+	heap_.push_back(timer);
+	place(timer, heap_.size() - 1);
+	siftUp(heap_.size() - 1);
 
-	Entry e(timer->expiration(), timer);
+	// 成为堆顶时需要重新设定 timerfd
+	return timer->heap_index_ == 0;
+}
 
-	timers_.insert(e);
+void TimerQueue::remove(Timer* timer)
+{
+	size_t index = timer->heap_index_;
+	Timer* last = heap_.back();
+	heap_.pop_back();
+	timer->heap_index_ = Timer::kNotInHeap;
 
-	return reset_instantly;
+	if (last != timer)
+	{
+		place(last, index);
+		siftUp(index);
+		siftDown(last->heap_index_);
+	}
+}
+
+void TimerQueue::siftUp(size_t index)
+{
+	Timer* timer = heap_[index];
+	while (index > 0)
+	{
+		size_t parent = (index - 1) / 2;
+		if (!earlier(timer, heap_[parent]))
+		{
+			break;
+		}
+		place(heap_[parent], index);
+		index = parent;
+	}
+	place(timer, index);
+}
+
+void TimerQueue::siftDown(size_t index)
+{
+	Timer* timer = heap_[index];
+	size_t n = heap_.size();
+	while (true)
+	{
+		size_t child = index * 2 + 1;
+		if (child >= n)
+		{
+			break;
+		}
+		if (child + 1 < n && earlier(heap_[child + 1], heap_[child]))
+		{
+			++child;
+		}
+		if (!earlier(heap_[child], timer))
+		{
+			break;
+		}
+		place(heap_[child], index);
+		index = child;
+	}
+	place(timer, index);
+}
+
+void TimerQueue::place(Timer* timer, size_t index)
+{
+	heap_[index] = timer;
+	timer->heap_index_ = index;
 }
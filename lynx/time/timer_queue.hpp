@@ -5,10 +5,9 @@
 #include "lynx/time/time_stamp.hpp"
 #include "lynx/time/timer_id.hpp"
 #include <cstddef>
-#include <functional>
+#include <deque>
 #include <memory>
-#include <set>
-#include <utility>
+#include <mutex>
 #include <vector>
 namespace lynx
 {
@@ -21,16 +20,25 @@ class Channel;
 namespace time
 {
 class Timer;
+// 定时器节点放在池中重复使用，按到期时刻组成二叉堆，节点记录自己在堆中
+// 的位置，取消时直接从堆中删除。其他线程注册的定时器先放入 pending_，
+// 同一批注册只唤醒 loop 一次
 class TimerQueue : public base::noncopyable
 {
   private:
-	using Entry = std::pair<TimeStamp, std::shared_ptr<Timer>>;
-
 	tcp::EventLoop* loop_;
 	std::unique_ptr<tcp::Channel> ch_;
 
-	std::set<Entry> timers_;
-	std::vector<Entry> active_timers_;
+	std::vector<Timer*> heap_;
+	std::vector<Timer*> active_timers_;
+	std::vector<Timer*> adding_;
+	// timerfd 当前设定的到期时刻（单调时钟）
+	TimeStamp armed_;
+
+	std::mutex mtx_;
+	std::deque<Timer> nodes_;	  // guarded by mutex，元素地址不变
+	std::vector<Timer*> free_;	  // guarded by mutex
+	std::vector<Timer*> pending_; // guarded by mutex
 
   public:
 	TimerQueue(tcp::EventLoop* loop);
@@ -38,28 +46,33 @@ class TimerQueue : public base::noncopyable
 
 	void TimerDestroy();
 
-	TimerId addTimer(TimeStamp time_stamp, const std::function<void()>& cb,
-					 double interval);
+	// time_stamp 为单调时钟时刻（TimeStamp::monotonic）
+	TimerId addTimer(TimeStamp time_stamp, TimerCallback cb, double interval);
 	void cancell(TimerId timer_id);
 
 	size_t size() const
 	{
-		return timers_.size();
+		return heap_.size();
 	}
 
   private:
 	void readTimerFd();
 	void handleRead();
-	void resetTimer();
-	void resetTimerFd(std::shared_ptr<Timer> timer);
+	void resetTimerFd();
+
+	Timer* acquire();
+	void release(Timer* timer);
 
-	bool insert(std::shared_ptr<Timer> timer);
-	bool remove(std::shared_ptr<Timer> timer);
+	bool insert(Timer* timer);
+	void remove(Timer* timer);
+	void siftUp(size_t index);
+	void siftDown(size_t index);
+	void place(Timer* timer, size_t index);
 
-	void addTimerInLoop(std::shared_ptr<Timer> timer);
+	void addPending();
 	void cancellInLoop(TimerId timer_id);
 };
 } // namespace time
 } // namespace lynx
 
-#endif
\ No newline at end of file
+#endif
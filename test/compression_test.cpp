@@ -0,0 +1,195 @@
+#include "lynx/http/compression.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <zlib.h>
+
+using namespace lynx;
+
+namespace
+{
+std::string inflateAll(const std::string& in, bool gzip)
+{
+	z_stream zs{};
+	assert(inflateInit2(&zs, gzip ? 15 + 16 : 15) == Z_OK);
+	zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+	zs.avail_in = static_cast<uInt>(in.size());
+
+	std::string out;
+	char buf[16384];
+	int ret;
+	do
+	{
+		zs.next_out = reinterpret_cast<Bytef*>(buf);
+		zs.avail_out = sizeof(buf);
+		ret = inflate(&zs, Z_NO_FLUSH);
+		assert(ret == Z_OK || ret == Z_STREAM_END);
+		out.append(buf, sizeof(buf) - zs.avail_out);
+	} while (ret != Z_STREAM_END);
+	inflateEnd(&zs);
+	return out;
+}
+
+std::string dechunk(const std::string& in)
+{
+	std::string out;
+	size_t pos = 0;
+	while (true)
+	{
+		size_t eol = in.find("\r\n", pos);
+		size_t len = std::stoul(in.substr(pos, eol - pos), nullptr, 16);
+		if (len == 0)
+		{
+			return out;
+		}
+		out.append(in, eol + 2, len);
+		pos = eol + 2 + len + 2;
+	}
+}
+} // namespace
+
+int main()
+{
+	using http::Encoding;
+	assert(http::negotiate("gzip, deflate, br") == Encoding::kGzip);
+	assert(http::negotiate("deflate") == Encoding::kDeflate);
+	assert(http::negotiate("gzip;q=0, deflate;q=0.5") == Encoding::kDeflate);
+	assert(http::negotiate("br") == Encoding::kIdentity);
+	assert(http::negotiate("*") == Encoding::kGzip);
+	// 显式的 q=0 优先于 "*"
+	assert(http::negotiate("gzip;q=0, *") == Encoding::kDeflate);
+	assert(http::negotiate("*, gzip;q=0, deflate;q=0") == Encoding::kIdentity);
+	assert(http::negotiate("deflate, *;q=0") == Encoding::kDeflate);
+	assert(http::negotiate("") == Encoding::kIdentity);
+	assert(http::compressible("application/json"));
+	assert(http::compressible("text/html; charset=utf-8"));
+	assert(!http::compressible("image/png"));
+
+	std::string json;
+	for (int i = 0; i < 200; ++i)
+	{
+		json += "{\"id\":" + std::to_string(i) + ",\"name\":\"lynx\"},";
+	}
+	assert(inflateAll(http::compress(json, Encoding::kDeflate), false) == json);
+
+	// 小 body 与不可压缩类型保持原样
+	{
+		http::Response res;
+		res.setCompression(Encoding::kGzip);
+		res.setContentType("application/json");
+		res.setBody("{}");
+		assert(res.toFormattedString().find("Content-Encoding") ==
+			   std::string::npos);
+	}
+	{
+		http::Response res;
+		res.setCompression(Encoding::kGzip);
+		res.setContentType("application/json");
+		res.setBody(json);
+		std::string out = res.toFormattedString();
+		size_t body = out.find("\r\n\r\n") + 4;
+		assert(out.find("Content-Encoding: gzip\r\n") < body);
+		assert(out.find("Content-Length: " +
+						std::to_string(out.size() - body)) < body);
+		assert(inflateAll(out.substr(body), true) == json);
+	}
+
+	// 大文件边读边压缩，以 chunked 发送
+	const std::string path = "/tmp/lynx_compression_test.html";
+	std::string content;
+	for (int i = 0; i < 20000; ++i)
+	{
+		content += "<p>line " + std::to_string(i) + " of lynx</p>\n";
+	}
+	std::ofstream(path) << content;
+
+	tcp::EventLoop loop;
+	http::Router router;
+	router.enableCompression();
+	router.addRoute("GET", "/index.html",
+					[&path](const auto&, auto* res, const auto& conn)
+					{ http::Router::sendFile(conn, res, path); });
+
+	tcp::Server server(&loop, "127.0.0.1", 18084, "Compression", 0);
+	server.setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+
+	http::ResponseParser parser;
+	std::string body;
+	tcp::ClientPool::local(&loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18084),
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[&](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					[[maybe_unused]] bool ok = parser.parseHeader(buf);
+					assert(ok);
+					if (!parser.headerCompleted())
+					{
+						return;
+					}
+					size_t n =
+						parser.consumeBody(buf->peek(), buf->readableBytes());
+					body.append(buf->peek(), n);
+					buf->retrieve(n);
+					if (parser.completed())
+					{
+						c->forceClose();
+						loop.quit();
+					}
+				});
+			conn->send("GET /index.html HTTP/1.1\r\n"
+					   "Host: localhost\r\n"
+					   "Accept-Encoding: gzip\r\n\r\n");
+		});
+
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(parser.completed());
+	assert(parser.header("content-encoding") == "gzip");
+	assert(parser.chunked());
+	std::string compressed = dechunk(body);
+	assert(compressed.size() < content.size() / 4);
+	assert(inflateAll(compressed, true) == content);
+	LOG_INFO << "compression test passed";
+}
@@ -0,0 +1,232 @@
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/handoff.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+
+using namespace lynx;
+
+namespace
+{
+void setup(tcp::Server* server, http::Router* router)
+{
+	server->setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server->setMessageCallback(
+		[router](const std::shared_ptr<tcp::Connection>& conn,
+				 tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router->dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+}
+
+// 读完一个响应后调用 done(parser)
+std::function<void(const std::shared_ptr<tcp::Connection>&, tcp::Buffer*)>
+readResponse(std::shared_ptr<http::ResponseParser> parser,
+			 std::function<void(const http::ResponseParser&)> done)
+{
+	return [parser, done](const std::shared_ptr<tcp::Connection>&,
+						  tcp::Buffer* buf)
+	{
+		[[maybe_unused]] bool ok = parser->parseHeader(buf);
+		assert(ok);
+		if (!parser->headerCompleted())
+		{
+			return;
+		}
+		buf->retrieve(parser->consumeBody(buf->peek(), buf->readableBytes()));
+		if (parser->completed())
+		{
+			done(*parser);
+		}
+	};
+}
+} // namespace
+
+int main()
+{
+	const std::string path = "/tmp/lynx_drain_test.sock";
+	const tcp::InetAddr addr("127.0.0.1", 18089);
+
+	tcp::EventLoop loop;
+	http::Router router;
+	router.addRoute("GET", "/hello",
+					[](const auto&, auto* res, const auto& conn)
+					{
+						res->setStatusCode(200);
+						res->setBody("hello");
+						conn->send(res->toFormattedString());
+					});
+	// 异步响应的完成方在处理函数返回前就已完成（如文件一次写完）
+	router.addRoute("GET", "/sync",
+					[](const auto&, auto* res, const auto& conn)
+					{
+						res->setDeferred();
+						res->setStatusCode(200);
+						res->setBody("sync");
+						conn->send(res->toFormattedString());
+						conn->setBusy(false);
+					});
+
+	tcp::Server old_server(&loop, addr, "Old", 0);
+	setup(&old_server, &router);
+	old_server.run();
+
+	std::unique_ptr<tcp::Server> new_server;
+	std::thread taker;
+	bool drained = false;
+	bool closed_response = false;
+	bool new_response = false;
+
+	auto maybeQuit = [&]()
+	{
+		if (drained && closed_response && new_response)
+		{
+			loop.quit();
+		}
+	};
+
+	std::weak_ptr<tcp::Connection> busy_conn;
+	time::TimeStamp drain_start;
+	tcp::Handoff handoff(&loop, path);
+	handoff.setFds({old_server.listenFd()});
+	handoff.setHandedOffCallback(
+		[&]()
+		{
+			drain_start = time::TimeStamp::now();
+			old_server.drain(3.0,
+							 [&]()
+							 {
+								 // 不应等到超时强制关闭
+								 assert(time::TimeStamp::now() <
+										time::TimeStamp::addTime(drain_start,
+																 1.0));
+								 drained = true;
+								 maybeQuit();
+							 });
+			// 半个请求在 drain 之后补全，响应应带 Connection: close
+			loop.runAfter(0.05, [&]() { busy_conn.lock()->send("\r\n"); });
+		});
+	[[maybe_unused]] bool listening = handoff.listen();
+	assert(listening);
+	// 只有属主可以连接
+	struct stat st;
+	assert(::stat(path.c_str(), &st) == 0 && (st.st_mode & 0777) == 0600);
+
+	// 新进程：取得监听 fd 后在同一端口继续服务
+	auto takeOver = [&]()
+	{
+		taker = std::thread(
+			[&]()
+			{
+				std::vector<int> fds = tcp::Handoff::take(path);
+				assert(fds.size() == 1);
+				loop.runInLoop(
+					[&, fd = fds[0]]()
+					{
+						new_server =
+							std::make_unique<tcp::Server>(&loop, fd, "New", 0);
+						setup(new_server.get(), &router);
+						new_server->run();
+
+						tcp::ClientPool::local(&loop)->acquire(
+							addr,
+							[&](const std::shared_ptr<tcp::Connection>& conn)
+							{
+								assert(conn);
+								conn->setMessageCallback(readResponse(
+									std::make_shared<http::ResponseParser>(),
+									[&](const http::ResponseParser& p)
+									{
+										assert(p.statusCode() == 200);
+										new_response = true;
+										maybeQuit();
+									}));
+								conn->send("GET /hello HTTP/1.1\r\n\r\n");
+							});
+					});
+			});
+	};
+
+	// 一个连接停在请求头中间，一个连接处理完请求后空闲
+	int connected = 0;
+	tcp::ClientPool::local(&loop)->acquire(
+		addr,
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			busy_conn = conn;
+			conn->setMessageCallback(readResponse(
+				std::make_shared<http::ResponseParser>(),
+				[&](const http::ResponseParser& p)
+				{
+					assert(p.statusCode() == 200 && !p.keepAlive());
+					closed_response = true;
+					maybeQuit();
+				}));
+			conn->send("GET /hello HTTP/1.1\r\n");
+			// 等服务端 accept 并读到半个请求后再交接
+			if (++connected == 2)
+			{
+				loop.runAfter(0.1, takeOver);
+			}
+		});
+	tcp::ClientPool::local(&loop)->acquire(
+		addr,
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(readResponse(
+				std::make_shared<http::ResponseParser>(),
+				[&](const http::ResponseParser& p)
+				{
+					assert(p.statusCode() == 200 && p.keepAlive());
+					if (++connected == 2)
+					{
+						loop.runAfter(0.1, takeOver);
+					}
+				}));
+			conn->send("GET /sync HTTP/1.1\r\n\r\n");
+		});
+
+	// 客户端收到 FIN 后关闭，drain 应早于超时完成
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+	taker.join();
+
+	assert(drained && closed_response && new_response);
+	assert(old_server.listenFd() == -1);
+	LOG_INFO << "drain test passed";
+}
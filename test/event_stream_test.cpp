@@ -0,0 +1,172 @@
+#include "lynx/http/event_stream.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <cassert>
+#include <memory>
+#include <string>
+
+using namespace lynx;
+
+namespace
+{
+void serve(tcp::Server* server, http::Router* router)
+{
+	server->setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server->setMessageCallback(
+		[router](const std::shared_ptr<tcp::Connection>& conn,
+				 tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router->dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server->run();
+}
+
+// 客户端收到响应头后停止读取，服务端持续广播直到超过高水位：
+// 连接应被断开，而不是静默丢弃事件
+void slowConsumerTest(tcp::EventLoop* loop)
+{
+	http::EventStreamHub hub;
+	hub.setHighWaterMark(64 * 1024);
+
+	bool opened = false;
+	bool closed = false;
+	hub.setOpenCallback([&opened](const std::shared_ptr<http::EventStream>&)
+						{ opened = true; });
+	hub.setCloseCallback(
+		[&closed, loop](const std::shared_ptr<http::EventStream>&)
+		{
+			closed = true;
+			loop->quit();
+		});
+
+	http::Router router;
+	router.addRoute("GET", "/events", hub.handler());
+
+	tcp::Server server(loop, "127.0.0.1", 18096, "SlowConsumer", 0);
+	serve(&server, &router);
+
+	tcp::ClientPool::local(loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18096),
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[](const std::shared_ptr<tcp::Connection>& c, tcp::Buffer*)
+				{ c->stopRead(); });
+			conn->send("GET /events HTTP/1.1\r\n"
+					   "Host: localhost\r\n\r\n");
+		});
+
+	const std::string payload(256 * 1024, 'x');
+	time::TimerId ticker =
+		loop->runEvery(0.01, [&hub, &payload]() { hub.broadcast(payload); });
+	time::TimerId timeout = loop->runAfter(5.0, [loop]() { loop->quit(); });
+	loop->run();
+	loop->cancell(ticker);
+	loop->cancell(timeout);
+
+	assert(opened);
+	assert(closed);
+	assert(hub.size() == 0);
+}
+} // namespace
+
+int main()
+{
+	assert(http::EventStream::encode("a\nb", "msg", "7") ==
+		   "event: msg\nid: 7\ndata: a\ndata: b\n\n");
+
+	tcp::EventLoop loop;
+	slowConsumerTest(&loop);
+
+	http::EventStreamHub hub;
+	hub.setHeartbeatInterval(0.2);
+	hub.setOpenCallback(
+		[&hub](const std::shared_ptr<http::EventStream>& stream)
+		{
+			assert(stream->lastEventId() == "41");
+			hub.broadcast("hello\nworld", "greeting", "42");
+		});
+
+	http::Router router;
+	router.addRoute("GET", "/events", hub.handler());
+
+	tcp::Server server(&loop, "127.0.0.1", 18083, "EventStream", 0);
+	serve(&server, &router);
+
+	std::string received;
+	bool draining = false;
+	bool drained = false;
+	time::TimeStamp drain_start;
+	tcp::ClientPool::local(&loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18083),
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[&](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					received += buf->retrieveString(buf->readableBytes());
+					// 先收到事件，空闲后收到心跳注释；之后 drain 应立即结束流，
+					// 而不是等到超时
+					if (!draining &&
+						received.find(": ping\n\n") != std::string::npos)
+					{
+						draining = true;
+						drain_start = time::TimeStamp::now();
+						server.drain(3.0,
+									 [&]()
+									 {
+										 drained = true;
+										 loop.quit();
+									 });
+					}
+				});
+			conn->send("GET /events HTTP/1.1\r\n"
+					   "Host: localhost\r\n"
+					   "Last-Event-ID: 41\r\n\r\n");
+		});
+
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(received.starts_with("HTTP/1.1 200 OK\r\n"));
+	assert(received.find("Content-Type: text/event-stream\r\n") !=
+		   std::string::npos);
+	size_t event = received.find(
+		"event: greeting\nid: 42\ndata: hello\ndata: world\n\n");
+	assert(event != std::string::npos);
+	assert(received.find(": ping\n\n") > event);
+	assert(drained);
+	assert(time::TimeStamp::now() < time::TimeStamp::addTime(drain_start, 1.0));
+	assert(hub.size() == 0);
+	LOG_INFO << "event stream test passed";
+}
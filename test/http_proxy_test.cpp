@@ -0,0 +1,172 @@
+#include "lynx/http/proxy.hpp"
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <memory>
+#include <string>
+
+using namespace lynx;
+
+namespace
+{
+void serve(tcp::Server* server, http::Router* router)
+{
+	server->setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+
+	server->setMessageCallback(
+		[router](const std::shared_ptr<tcp::Connection>& conn,
+				 tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			if (!session->parser(buf))
+			{
+				conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
+				conn->shutdown();
+				return;
+			}
+
+			if (session->completed())
+			{
+				http::Response res;
+				router->dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+}
+
+// 发送一个请求并读取完整响应
+void request(tcp::EventLoop* loop, uint16_t port, const std::string& req,
+			 std::function<void(int, const std::string&)> cb)
+{
+	auto parser = std::make_shared<http::ResponseParser>();
+	auto body = std::make_shared<std::string>();
+	tcp::ClientPool::local(loop)->acquire(
+		tcp::InetAddr("127.0.0.1", port),
+		[=](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[=](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					[[maybe_unused]] bool ok = parser->parseHeader(buf);
+					assert(ok);
+					if (!parser->headerCompleted())
+					{
+						return;
+					}
+					size_t n =
+						parser->consumeBody(buf->peek(), buf->readableBytes());
+					body->append(buf->peek(), n);
+					buf->retrieve(n);
+					if (parser->completed())
+					{
+						c->forceClose();
+						cb(parser->statusCode(), *body);
+					}
+				});
+			conn->send(req);
+		});
+}
+} // namespace
+
+int main()
+{
+	tcp::EventLoop loop;
+
+	// 两个上游：一个固定长度响应，一个 chunked 响应
+	http::Router backend_router;
+	backend_router.addRoute(
+		"GET", "/api/*",
+		[](const http::Request& req, http::Response* res,
+		   const std::shared_ptr<tcp::Connection>& conn)
+		{
+			res->setStatusCode(200);
+			res->setBody(req.target + " " + req.header("x-forwarded-for"));
+			conn->send(res->toFormattedString());
+		});
+	backend_router.addRoute(
+		"GET", "/chunked",
+		[](const http::Request&, http::Response*,
+		   const std::shared_ptr<tcp::Connection>& conn)
+		{
+			conn->send("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+					   "5\r\nhello\r\n6;ext=1\r\n world\r\n0\r\n\r\n");
+		});
+
+	tcp::Server backend(&loop, "127.0.0.1", 18081, "Backend", 0);
+	serve(&backend, &backend_router);
+	backend.run();
+
+	http::Proxy proxy({tcp::InetAddr("127.0.0.1", 18081)});
+	http::Proxy dead_proxy({tcp::InetAddr("127.0.0.1", 1)});
+	tcp::ClientPool::local(&loop)->setMaxRetries(0);
+
+	http::Router router;
+	router.addRoute("GET", "/api/*", proxy.handler());
+	router.addRoute("GET", "/chunked", proxy.handler());
+	router.addRoute("GET", "/dead", dead_proxy.handler());
+
+	tcp::Server front(&loop, "127.0.0.1", 18090, "Proxy", 0);
+	serve(&front, &router);
+	front.run();
+
+	int finished = 0;
+	request(&loop, 18090,
+			"GET /api/v1/users?b=2&a=1&a=3&debug HTTP/1.1\r\nHost: t\r\n\r\n",
+			[&](int code, const std::string& body)
+			{
+				assert(code == 200);
+				assert(body == "/api/v1/users?b=2&a=1&a=3&debug 127.0.0.1");
+				++finished;
+			});
+	request(&loop, 18090, "GET /chunked HTTP/1.1\r\nHost: t\r\n\r\n",
+			[&](int code, const std::string& body)
+			{
+				assert(code == 200);
+				assert(body.find("hello") != std::string::npos);
+				assert(body.ends_with("0\r\n\r\n"));
+				++finished;
+			});
+	request(&loop, 18090, "GET /dead HTTP/1.1\r\nHost: t\r\n\r\n",
+			[&](int code, const std::string&)
+			{
+				assert(code == 502);
+				++finished;
+			});
+
+	loop.runEvery(0.1,
+				  [&]()
+				  {
+					  if (finished == 3)
+					  {
+						  loop.quit();
+					  }
+				  });
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(finished == 3);
+	assert(proxy.balancer().upstream(0)->active.load() == 0);
+	LOG_INFO << "http proxy test passed";
+}
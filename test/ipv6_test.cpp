@@ -0,0 +1,85 @@
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <memory>
+#include <set>
+#include <string>
+
+using namespace lynx;
+
+namespace
+{
+void testAddr()
+{
+	assert(tcp::InetAddr("10.0.0.255", 80).toFormattedString() ==
+		   "10.0.0.255:80");
+	assert(tcp::InetAddr().toFormattedString() == "0.0.0.0:0");
+
+	tcp::InetAddr v6("2001:db8::1", 8080);
+	assert(v6.isIpv6());
+	assert(v6.ip() == "2001:db8::1");
+	assert(v6.port() == 8080);
+	assert(v6.toFormattedString() == "[2001:db8::1]:8080");
+	assert(v6 == tcp::InetAddr("2001:db8::1", 8080));
+	assert(!(v6 == tcp::InetAddr("2001:db8::1", 8081)));
+
+	// 双栈监听收到的 IPv4 连接按 IPv4 输出
+	tcp::InetAddr mapped("::ffff:192.168.1.2", 443);
+	assert(mapped.ip() == "192.168.1.2");
+	assert(mapped.toFormattedString() == "192.168.1.2:443");
+
+	tcp::InetAddr any(80, false, true);
+	assert(any.toFormattedString() == "[::]:80");
+	assert(tcp::InetAddr(80, true, true).ip() == "::1");
+}
+} // namespace
+
+int main()
+{
+	testAddr();
+
+	tcp::EventLoop loop;
+	tcp::Server server(&loop, tcp::InetAddr(18093, false, true), "Ipv6", 0);
+	server.setMessageCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn, tcp::Buffer* buf)
+		{
+			buf->retrieve(buf->readableBytes());
+			conn->send(conn->addr().ip());
+		});
+	server.run();
+
+	// 同一个 "::" 监听 socket 同时接受 IPv4 与 IPv6 客户端
+	std::set<std::string> peers;
+	for (const char* ip : {"127.0.0.1", "::1"})
+	{
+		tcp::ClientPool::local(&loop)->acquire(
+			tcp::InetAddr(ip, 18093),
+			[&](const std::shared_ptr<tcp::Connection>& conn)
+			{
+				assert(conn);
+				conn->setMessageCallback(
+					[&](const std::shared_ptr<tcp::Connection>& c,
+						tcp::Buffer* buf)
+					{
+						peers.insert(buf->retrieveString(buf->readableBytes()));
+						c->forceClose();
+						if (peers.size() == 2)
+						{
+							loop.quit();
+						}
+					});
+				conn->send("ping");
+			});
+	}
+
+	loop.runAfter(2.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert((peers == std::set<std::string>{"127.0.0.1", "::1"}));
+	LOG_INFO << "ipv6 test passed";
+}
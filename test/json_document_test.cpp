@@ -0,0 +1,142 @@
+#include "lynx/json/document.hpp"
+#include "lynx/json/parser.hpp"
+#include "lynx/json/ref.hpp"
+#include "lynx/json/tokenizer.hpp"
+#include "lynx/logger/logger.hpp"
+#include <cassert>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace lynx;
+
+namespace
+{
+bool fails(json::Document* doc, std::string_view text)
+{
+	try
+	{
+		doc->parse(text);
+	}
+	catch (const std::runtime_error&)
+	{
+		return true;
+	}
+	return false;
+}
+} // namespace
+
+int main()
+{
+	const std::string text = R"JSON({
+		"user": {"id": 42, "name": "lynx", "active": true, "score": 9.5},
+		"tags": ["a", "b", "c"],
+		"empty_object": {},
+		"empty_array": [],
+		"nested": [[1, 2], [3, [4, 5]], {"k": null}],
+		"min_int": -9223372036854775808
+	})JSON";
+
+	json::Document doc;
+	doc.parse(text);
+
+	const json::Node& root = doc.root();
+	assert(root.isObject());
+	assert(root.size() == 6);
+	assert(doc["user"]["id"].asInt() == 42);
+	assert(doc["user"]["name"].asStr() == "lynx");
+	assert(doc["user"]["active"].asBool());
+	assert(doc["user"]["score"].asFloat() == 9.5);
+	assert(doc["tags"].size() == 3);
+	assert(doc["tags"][2].asStr() == "c");
+	assert(doc["empty_object"].isObject() && doc["empty_object"].size() == 0);
+	assert(doc["empty_array"].isArray() && doc["empty_array"].size() == 0);
+	assert(doc["nested"][1][1][0].asInt() == 4);
+	assert(doc["nested"][2]["k"].isNull());
+	assert(doc["min_int"].asInt() == INT64_MIN);
+	assert(root.find("missing") == nullptr);
+
+	// 成员保持输入顺序
+	std::string keys;
+	for (const json::Member& member : root.members())
+	{
+		keys += std::string(member.key) + ",";
+	}
+	assert(keys == "user,tags,empty_object,empty_array,nested,min_int,");
+
+	assert(doc["nested"].serialize() == "[[1,2],[3,[4,5]],{\"k\":null}]");
+
+	// 复用同一 Document：arena 保留上一次的块，用量不随解析次数增长
+	size_t usage = doc.memoryUsage();
+	assert(usage > 0);
+	for (int i = 0; i < 100; ++i)
+	{
+		doc.parse(text);
+	}
+	assert(doc.memoryUsage() == usage);
+	assert(doc["tags"][0].asStr() == "a");
+
+	// 跨越多个 arena 块的大文档
+	std::string big = "[";
+	for (int i = 0; i < 5000; ++i)
+	{
+		big += (i > 0 ? "," : "") + std::string("{\"id\":") +
+			   std::to_string(i) + ",\"name\":\"item\"}";
+	}
+	big += "]";
+	for (int i = 0; i < 3; ++i)
+	{
+		doc.parse(big);
+		assert(doc.root().size() == 5000);
+		assert(doc[4999]["id"].asInt() == 4999);
+		assert(doc[123]["name"].asStr() == "item");
+	}
+
+	// 错误输入抛出异常，之前的内容被清空
+	assert(fails(&doc, "{\"a\": 1,}"));
+	assert(doc.root().isNull());
+	assert(fails(&doc, "[1, 2"));
+	assert(fails(&doc, "{\"a\" 1}"));
+	assert(fails(&doc, "[1] 2"));
+	assert(fails(&doc, ""));
+	assert(fails(&doc, "{\"a\": \"unterminated"));
+	assert(fails(&doc, "[\"bad \\x escape\"]"));
+	assert(fails(&doc, std::string(json::Document::kMaxDepth + 1, '[') +
+						   std::string(json::Document::kMaxDepth + 1, ']')));
+
+	doc.parse("\"scalar\"");
+	assert(doc.root().asStr() == "scalar");
+
+	// 只有含转义的字符串会被还原
+	doc.parse(R"({"k\"": "a\n\u00e9\ud83d\ude00", "plain": "x"})");
+	assert(doc["k\""].asStr() == "a\n\xc3\xa9\xf0\x9f\x98\x80");
+	assert(doc["plain"].asStr() == "x");
+
+	// 数字：最短可还原输出，大整数退化为 double
+	doc.parse("[0.1, 3.14159265358979, 1e300, -2.5e-8, 5.0, "
+			  "12345678901234567890, -9223372036854775808]");
+	assert(doc.root().serialize() ==
+		   "[0.1,3.14159265358979,1e+300,-2.5e-08,5.0,12345678901234567168.0,"
+		   "-9223372036854775808]");
+	assert(doc[5].isFloat());
+	assert(doc[6].asInt() == INT64_MIN);
+	assert(fails(&doc, "[1e999]"));
+	assert(fails(&doc, "[-]"));
+	assert(fails(&doc, "[01]"));
+
+	{
+		// Ref 的两种输出方式一致
+		json::Tokenizer tokenizer(
+			std::string_view("{\"price\": 19.99, \"qty\": 3, \"r\": 1e-7}"));
+		json::Ref ref = json::Parser(&tokenizer).parse();
+		assert(ref["price"].asFloat() == 19.99);
+		assert(ref.serialize() == "{\"price\":19.99,\"qty\":3,\"r\":1e-07}");
+		std::ostringstream os;
+		os << ref;
+		assert(os.str() == ref.serialize());
+	}
+
+	LOG_INFO << "json document test passed";
+}
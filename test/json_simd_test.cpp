@@ -0,0 +1,133 @@
+#include "lynx/json/parser.hpp"
+#include "lynx/json/ref.hpp"
+#include "lynx/json/simd_parser.hpp"
+#include "lynx/json/structural_index.hpp"
+#include "lynx/json/tokenizer.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace lynx;
+
+namespace
+{
+using Simd = json::StructuralIndex::Simd;
+
+std::vector<uint32_t> positions(std::string_view text, Simd simd)
+{
+	json::StructuralIndex index;
+	index.build(text, simd);
+	std::vector<uint32_t> out;
+	for (size_t i = 0; i < index.size(); ++i)
+	{
+		out.push_back(index[i]);
+	}
+	return out;
+}
+
+bool fails(std::string_view text)
+{
+	try
+	{
+		json::SimdParser().parse(text);
+	}
+	catch (const std::runtime_error&)
+	{
+		return true;
+	}
+	return false;
+}
+
+// 不含转义的较大文档，字符串长度各异以便跨越 64 字节边界
+std::string makeDocument(int n)
+{
+	std::string text = "{\"items\": [";
+	for (int i = 0; i < n; ++i)
+	{
+		if (i > 0)
+		{
+			text += ",\n  ";
+		}
+		text += "{\"id\": " + std::to_string(i) + ", \"name\": \"" +
+				std::string(i % 70, 'a' + i % 26) + "\", \"ok\": " +
+				(i % 2 ? "true" : "false") + ", \"v\": " +
+				std::to_string(i * -3) + ".25, \"n\": null, \"t\": []}";
+	}
+	text += "], \"count\": " + std::to_string(n) + "}";
+	return text;
+}
+} // namespace
+
+int main()
+{
+	std::cout << "best: " << json::StructuralIndex::name(
+									 json::StructuralIndex::best())
+			  << std::endl;
+
+	// 各指令集得到的下标一致，包括转义引号与跨块字符串
+	std::string tricky = makeDocument(200);
+	tricky += R"( ["a\"b", "c\\", "\\\"", "x)" + std::string(100, '\\') +
+			  R"(y", {"k\"ey": "v"}])";
+	std::vector<uint32_t> scalar = positions(tricky, Simd::kScalar);
+	assert(positions(tricky, Simd::kSse42) == scalar);
+	assert(positions(tricky, Simd::kAvx2) == scalar);
+
+	{
+		// 引号、结构字符与标量起始位置
+		std::string_view text = R"({"a": [1, true], "b\"": null})";
+		std::vector<uint32_t> expected = {0,  1,  3,  4,  6,  7,  8,
+										  10, 14, 15, 17, 21, 22, 24, 28};
+		assert(positions(text, Simd::kScalar) == expected);
+	}
+
+	// 与 Parser 的结果一致
+	std::string text = makeDocument(500);
+	assert(text.size() > 5000);
+	json::SimdParser parser;
+	json::Ref ref = parser.parse(text);
+	json::Tokenizer tokenizer(text);
+	std::string expected = json::Parser(&tokenizer).parse().serialize();
+	assert(ref.serialize() == expected);
+	for (Simd simd : {Simd::kScalar, Simd::kSse42, Simd::kAvx2})
+	{
+		assert(parser.parse(text, simd).serialize() == expected);
+	}
+	assert(ref["count"].asInt() == 500);
+	assert(ref["items"][7]["name"].asStr() == std::string(7, 'h'));
+	assert(ref["items"][3]["ok"].asBool());
+	assert(ref["items"][2]["v"].asFloat() == -6.25);
+
+	// 转义还原
+	json::Ref esc = parser.parse(
+		R"({"s": "a\"b\\c\/d\n\t", "u": "é中😀"})");
+	assert(esc["s"].asStr() == "a\"b\\c/d\n\t");
+	assert(esc["u"].asStr() == "\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80");
+
+	// 标量与空输入
+	assert(parser.parse("  42 ").asInt() == 42);
+	assert(parser.parse("-0.5e1").asFloat() == -5.0);
+	assert(parser.parse(" \"\" ").asStr().empty());
+	assert(parser.parse("   ").get() == nullptr);
+	// 超出 int64_t 的整数退化为 double
+	assert(parser.parse("99999999999999999999").asFloat() == 1e20);
+
+	assert(fails(R"({"a": "unterminated)"));
+	assert(fails(R"({"a": tru})"));
+	assert(fails(R"({"a": 01})"));
+	assert(fails(R"({"a": 1.})"));
+	assert(fails(R"({"a" 1})"));
+	assert(fails(R"([1, 2)"));
+	assert(fails(R"([1 2])"));
+	assert(fails(R"({"a": 1} x)"));
+	assert(fails(R"(["\x"])"));
+	assert(fails(R"(["\ud800"])"));
+	assert(fails(R"(1e999)"));
+	assert(fails(std::string(600, '[') + std::string(600, ']')));
+
+	std::cout << "json simd test passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,144 @@
+#include "lynx/json/document.hpp"
+#include "lynx/json/parser.hpp"
+#include "lynx/json/ref.hpp"
+#include "lynx/json/tokenizer.hpp"
+#include "lynx/json/writer.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using namespace lynx;
+
+namespace
+{
+// 逐字符转义，作为向量化扫描的对照
+std::string escapeReference(std::string_view str)
+{
+	static const char kHex[] = "0123456789abcdef";
+	std::string out = "\"";
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"':
+			out += "\\\"";
+			break;
+		case '\\':
+			out += "\\\\";
+			break;
+		case '\b':
+			out += "\\b";
+			break;
+		case '\f':
+			out += "\\f";
+			break;
+		case '\n':
+			out += "\\n";
+			break;
+		case '\r':
+			out += "\\r";
+			break;
+		case '\t':
+			out += "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				out += "\\u00";
+				out += kHex[c >> 4];
+				out += kHex[c & 0xF];
+			}
+			else
+			{
+				out += c;
+			}
+		}
+	}
+	return out + "\"";
+}
+
+std::string writeString(std::string_view str)
+{
+	std::string out;
+	json::Writer(&out).string(str);
+	return out;
+}
+} // namespace
+
+int main()
+{
+	// 需要转义的字符出现在 16 字节块的各个位置
+	const std::string specials = std::string("\"\\\b\f\n\r\t\x01\x1f", 9);
+	for (size_t len = 0; len < 70; ++len)
+	{
+		for (size_t pos = 0; pos < len; ++pos)
+		{
+			std::string str(len, 'x');
+			str[pos] = specials[(len + pos) % specials.size()];
+			assert(writeString(str) == escapeReference(str));
+		}
+	}
+	// UTF-8 与 0x7f 原样输出
+	assert(writeString("中文\x7f/") == "\"中文\x7f/\"");
+
+	// 逐项写出
+	std::string out;
+	{
+		json::Writer writer(&out);
+		writer.startObject();
+		writer.key("a\"b");
+		writer.startArray();
+		writer.integer(-1);
+		writer.number(0.1);
+		writer.boolean(true);
+		writer.null();
+		writer.startObject();
+		writer.endObject();
+		writer.endArray();
+		writer.key("s");
+		writer.string("line\n");
+		writer.endObject();
+	}
+	assert(out == R"({"a\"b":[-1,0.1,true,null,{}],"s":"line\n"})");
+
+	// 缩进输出
+	json::Tokenizer tokenizer(out);
+	json::Ref ref = json::Parser(&tokenizer).parse();
+	std::string pretty;
+	json::Writer(&pretty, 2).write(*ref.get());
+	assert(pretty == "{\n"
+					 "  \"a\\\"b\": [\n"
+					 "    -1,\n"
+					 "    0.1,\n"
+					 "    true,\n"
+					 "    null,\n"
+					 "    {}\n"
+					 "  ],\n"
+					 "  \"s\": \"line\\n\"\n"
+					 "}");
+
+	// serialize 的输出可被重新解析，转义往返一致
+	std::string text = ref.serialize();
+	assert(text == out);
+	std::ostringstream os;
+	os << ref;
+	assert(os.str() == out);
+
+	json::Document doc;
+	doc.parse(out);
+	assert(doc.root().serialize() == out);
+	std::string indented;
+	json::Writer(&indented, 2).write(doc.root());
+	assert(indented == pretty);
+
+	// 直接写入连接的输出缓冲区
+	tcp::Buffer buf;
+	json::Writer(&buf).write(doc.root());
+	assert(buf.retrieveString(buf.readableBytes()) == out);
+
+	std::cout << "json writer test passed" << std::endl;
+	return 0;
+}
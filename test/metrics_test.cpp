@@ -0,0 +1,190 @@
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/metrics/registry.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lynx;
+
+namespace
+{
+bool contains(const std::string& text, const std::string& line)
+{
+	return text.find(line + "\n") != std::string::npos;
+}
+
+void testRegistry()
+{
+	metrics::Registry& registry = metrics::Registry::instance();
+	metrics::Counter counter =
+		registry.counter("test_events_total", "Events", {{"kind", "a\"b"}});
+	metrics::Gauge gauge = registry.gauge("test_inflight", "In flight");
+	metrics::Histogram hist =
+		registry.histogram("test_seconds", "Seconds", {0.1, 1});
+
+	// 已退出线程的值并入 retired，gauge 的 add 与 sub 在不同线程
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.emplace_back(
+			[&]()
+			{
+				for (int j = 0; j < 1000; ++j)
+				{
+					counter.inc();
+				}
+				gauge.add(2);
+				hist.observe(0.5);
+			});
+	}
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+	gauge.sub(3);
+	hist.observe(0.05);
+	hist.observe(7);
+
+	// 重复注册返回同一个指标
+	registry.counter("test_events_total", "Events", {{"kind", "a\"b"}}).inc();
+
+	std::string text = registry.scrape();
+	assert(contains(text, "# TYPE test_events_total counter"));
+	assert(contains(text, R"(test_events_total{kind="a\"b"} 4001)"));
+	assert(contains(text, "test_inflight 5"));
+	assert(contains(text, R"(test_seconds_bucket{le="0.1"} 1)"));
+	assert(contains(text, R"(test_seconds_bucket{le="1"} 5)"));
+	assert(contains(text, R"(test_seconds_bucket{le="+Inf"} 6)"));
+	assert(contains(text, "test_seconds_sum 9.05"));
+	assert(contains(text, "test_seconds_count 6"));
+}
+} // namespace
+
+int main()
+{
+	testRegistry();
+
+	tcp::EventLoop loop;
+	http::Router router;
+	router.addRoute("GET", "/hello",
+					[](const auto&, auto* res, const auto& conn)
+					{
+						res->setBody("hello");
+						conn->send(res->toFormattedString());
+					});
+	router.enableMetrics();
+
+	tcp::Server server(&loop, "127.0.0.1", 18087, "Metrics", 0);
+	server.setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+
+	std::vector<std::string> requests = {
+		"GET /hello HTTP/1.1\r\n\r\n",
+		"GET /hello HTTP/1.1\r\n\r\n",
+		"GET /missing HTTP/1.1\r\n\r\n",
+		"GET /metrics HTTP/1.1\r\n\r\n",
+	};
+
+	http::ResponseParser parser;
+	std::string body;
+	size_t done = 0;
+
+	tcp::ClientPool::local(&loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18087),
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[&](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					[[maybe_unused]] bool ok = parser.parseHeader(buf);
+					assert(ok);
+					if (!parser.headerCompleted())
+					{
+						return;
+					}
+					size_t n =
+						parser.consumeBody(buf->peek(), buf->readableBytes());
+					body.append(buf->peek(), n);
+					buf->retrieve(n);
+					if (!parser.completed())
+					{
+						return;
+					}
+
+					if (++done < requests.size())
+					{
+						parser.clear();
+						body.clear();
+						c->send(requests[done]);
+					}
+					else
+					{
+						assert(parser.statusCode() == 200);
+						c->forceClose();
+						loop.quit();
+					}
+				});
+			conn->send(requests[0]);
+		});
+
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(done == requests.size());
+	// /metrics 自身在处理函数返回后才计数，不出现在本次输出中
+	assert(contains(
+		body,
+		R"(lynx_http_requests_total{method="GET",route="/hello",code="2xx"} 2)"));
+	assert(contains(
+		body,
+		R"(lynx_http_requests_total{method="GET",route="unmatched",code="4xx"} 1)"));
+	assert(contains(
+		body,
+		R"(lynx_http_request_duration_seconds_count{method="GET",route="/hello"} 2)"));
+	assert(
+		contains(body, R"(lynx_tcp_connections_accepted_total{server="Metrics"} 1)"));
+	assert(contains(body, R"(lynx_tcp_connections_active{server="Metrics"} 1)"));
+	assert(body.find("lynx_tcp_bytes_received_total ") != std::string::npos);
+	assert(body.find("# TYPE lynx_alloc_pool_bytes gauge") != std::string::npos);
+
+	LOG_INFO << "metrics test passed";
+}
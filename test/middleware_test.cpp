@@ -0,0 +1,176 @@
+#include "lynx/http/middleware.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace lynx;
+
+namespace
+{
+// 记录 before/after 的执行顺序
+struct Trace
+{
+	std::string* out;
+	char tag;
+
+	template <typename Next>
+	void operator()(const http::Request&, http::Response*,
+					const std::shared_ptr<tcp::Connection>&, Next&& next) const
+	{
+		*out += tag;
+		next();
+		*out += tag;
+	}
+};
+} // namespace
+
+int main()
+{
+	tcp::EventLoop loop;
+	http::Router router;
+	std::string trace;
+
+	auto base = http::use(Trace{&trace, 'a'}, http::Cors{});
+	auto authed = base.use(
+		http::BearerAuth{[](std::string_view token) { return token == "t0k"; }},
+		Trace{&trace, 'b'});
+
+	router.addRoute("GET", "/api/items",
+					authed.handle(
+						[&trace](const auto&, auto* res, const auto& conn)
+						{
+							trace += 'h';
+							res->setBody("items");
+							conn->send(res->toFormattedString());
+						}));
+	router.addRoute("OPTIONS", "/api/*",
+					base.handle([&trace](const auto&, auto*, const auto&)
+								{ trace += 'h'; }));
+	router.addRoute("POST", "/api/*",
+					base.use(http::JsonError{})
+						.handle(
+							[](const auto&, auto*, const auto&)
+							{ throw std::runtime_error("bad \"input\"\\"); }));
+
+	tcp::Server server(&loop, "127.0.0.1", 18085, "Middleware", 0);
+	server.setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+
+	struct Case
+	{
+		std::string request;
+		int status;
+		std::string trace;
+	};
+	std::vector<Case> cases = {
+		// 预检请求被 Cors 短路，处理函数不执行
+		{"OPTIONS /api/items HTTP/1.1\r\n\r\n", 204, "aa"},
+		{"GET /api/items HTTP/1.1\r\n\r\n", 401, "aa"},
+		{"GET /api/items HTTP/1.1\r\nAuthorization: Bearer t0k\r\n\r\n", 200,
+		 "abhba"},
+		{"POST /api/calc HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}", 400, "aa"},
+	};
+
+	http::ResponseParser parser;
+	std::string body;
+	size_t done = 0;
+	std::function<void(const std::shared_ptr<tcp::Connection>&)> next =
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+	{
+		trace.clear();
+		parser.clear();
+		body.clear();
+		conn->send(cases[done].request);
+	};
+
+	tcp::ClientPool::local(&loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18085),
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[&](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					[[maybe_unused]] bool ok = parser.parseHeader(buf);
+					assert(ok);
+					if (!parser.headerCompleted())
+					{
+						return;
+					}
+					size_t n =
+						parser.consumeBody(buf->peek(), buf->readableBytes());
+					body.append(buf->peek(), n);
+					buf->retrieve(n);
+					if (!parser.completed())
+					{
+						return;
+					}
+
+					const Case& expect = cases[done];
+					assert(parser.statusCode() == expect.status);
+					assert(trace == expect.trace);
+					assert(parser.header("access-control-allow-origin") ==
+						   "*");
+					if (expect.status == 400)
+					{
+						assert(body == R"({"error":"bad \"input\"\\"})");
+					}
+
+					if (++done < cases.size())
+					{
+						next(c);
+					}
+					else
+					{
+						c->forceClose();
+						loop.quit();
+					}
+				});
+			next(conn);
+		});
+
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(done == cases.size());
+	LOG_INFO << "middleware test passed";
+}
@@ -0,0 +1,198 @@
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/metrics/registry.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/master.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <csignal>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <unistd.h>
+
+using namespace lynx;
+
+namespace
+{
+void runWorker(tcp::EventLoop* loop, int listen_fd, size_t)
+{
+	http::Router router;
+	router.addRoute("GET", "/pid",
+					[](const auto&, auto* res, const auto& conn)
+					{
+						res->setStatusCode(200);
+						res->setBody(std::to_string(::getpid()));
+						conn->send(res->toFormattedString());
+					});
+
+	tcp::Server server(loop, listen_fd, "Prefork", 0);
+	server.setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+	loop->run();
+}
+
+// 把 scrape 结果中某条样本的值取出，不存在时返回 -1
+double sample(const std::string& text, const std::string& key)
+{
+	size_t pos = text.find("\n" + key + " ");
+	if (pos == std::string::npos)
+	{
+		return -1;
+	}
+	return std::stod(text.substr(pos + key.size() + 2));
+}
+
+void testMerge()
+{
+	std::string a = "# HELP c c\n# TYPE c counter\nc{x=\"1\"} 2\n"
+					"# HELP g g\n# TYPE g gauge\ng 5\n";
+	std::string b = "# HELP c c\n# TYPE c counter\nc{x=\"1\"} 3\n"
+					"c{x=\"2\"} 1\n# HELP g g\n# TYPE g gauge\ng 1\n";
+	std::string merged = metrics::Registry::merge({a, b});
+	assert(merged == "# HELP c c\n# TYPE c counter\nc{x=\"1\"} 5\n"
+					 "c{x=\"2\"} 1\n# HELP g g\n# TYPE g gauge\ng 6\n");
+	assert(metrics::Registry::merge({a, b}, true) ==
+		   "# HELP c c\n# TYPE c counter\nc{x=\"1\"} 5\nc{x=\"2\"} 1\n");
+}
+} // namespace
+
+int main()
+{
+	testMerge();
+
+	const tcp::InetAddr addr("127.0.0.1", 18090);
+	tcp::EventLoop loop;
+	tcp::Master master(&loop, addr, "Prefork", 2);
+	master.setReportInterval(0.1);
+	master.setWorkerCallback(runWorker);
+	master.run();
+
+	std::set<std::string> pids;
+	size_t responses = 0;
+	std::function<void(std::function<void()>)> request =
+		[&](std::function<void()> done)
+	{
+		tcp::ClientPool::local(&loop)->acquire(
+			addr,
+			[&, done](const std::shared_ptr<tcp::Connection>& conn)
+			{
+				assert(conn);
+				auto parser = std::make_shared<http::ResponseParser>();
+				conn->setMessageCallback(
+					[&, parser, done](const std::shared_ptr<tcp::Connection>& c,
+									  tcp::Buffer* buf)
+					{
+						[[maybe_unused]] bool ok = parser->parseHeader(buf);
+						assert(ok);
+						if (!parser->headerCompleted())
+						{
+							return;
+						}
+						size_t n = parser->consumeBody(buf->peek(),
+													   buf->readableBytes());
+						std::string body(buf->peek(), n);
+						buf->retrieve(n);
+						if (parser->completed())
+						{
+							assert(parser->statusCode() == 200);
+							pids.insert(body);
+							++responses;
+							c->forceClose();
+							done();
+						}
+					});
+				conn->send("GET /pid HTTP/1.1\r\n\r\n");
+			});
+	};
+
+	const size_t kRequests = 32;
+	const std::string kAccepted =
+		"lynx_tcp_connections_accepted_total{server=\"Prefork\"}";
+	pid_t killed = -1;
+	bool restarted = false;
+	double accepted = 0;
+
+	// 3. worker 重启后仍能服务，全部退出后 loop 结束
+	auto afterRestart = [&]()
+	{
+		request(
+			[&]()
+			{
+				assert(master.workerPid(0) != killed);
+				restarted = true;
+				master.stop();
+			});
+	};
+
+	// 2. 等指标上报后杀掉一个 worker，它的计数仍计入总量
+	auto killWorker = [&]()
+	{
+		accepted = sample(master.scrape(), kAccepted);
+		killed = master.workerPid(0);
+		::kill(killed, SIGKILL);
+		loop.runAfter(1.5,
+					  [&]()
+					  {
+						  assert(sample(master.scrape(), kAccepted) >=
+								 accepted);
+						  afterRestart();
+					  });
+	};
+
+	// 1. 连接分散到两个 worker
+	size_t finished = 0;
+	for (size_t i = 0; i < kRequests; ++i)
+	{
+		request(
+			[&]()
+			{
+				if (++finished == kRequests)
+				{
+					loop.runAfter(0.3, killWorker);
+				}
+			});
+	}
+
+	loop.runAfter(8.0, [&master]() { master.stop(); });
+	loop.run();
+
+	assert(responses == kRequests + 1);
+	assert(pids.size() >= 2);
+	assert(accepted == kRequests);
+	assert(restarted);
+	LOG_INFO << "prefork test passed";
+}
@@ -0,0 +1,143 @@
+#include "lynx/http/middleware.hpp"
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/metrics/registry.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/rate_limiter.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace lynx;
+
+namespace
+{
+void testBucket()
+{
+	tcp::RateLimiter limiter(10, 2, 2);
+	int64_t now = 1000000;
+	assert(limiter.allow("a", now));
+	assert(limiter.allow("a", now));
+	assert(!limiter.allow("a", now));
+	assert(limiter.allow("a", now + 100000));
+	assert(!limiter.allow("a", now + 100000));
+
+	// 表满时清理空闲的桶，清不掉则放行且不记录
+	assert(limiter.allow("b", now));
+	assert(limiter.allow("c", now));
+	assert(limiter.size() == 2);
+	assert(limiter.allow("c", now + 2000000));
+	assert(limiter.size() == 1);
+}
+} // namespace
+
+int main()
+{
+	testBucket();
+
+	tcp::EventLoop loop;
+	http::Router router;
+	router.addRoute("GET", "/limited",
+					http::use(http::RateLimit{1, 2})
+						.handle(
+							[](const auto&, auto* res, const auto& conn)
+							{
+								res->setBody("ok");
+								conn->send(res->toFormattedString());
+							}));
+
+	tcp::Server server(&loop, "127.0.0.1", 18091, "RateLimit", 0);
+	server.setMaxConnectionsPerIp(2);
+	server.setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+
+	// 同一连接上的第三个请求超出突发上限
+	std::vector<int> statuses;
+	http::ResponseParser parser;
+	tcp::ClientPool::local(&loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18091),
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[&](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					[[maybe_unused]] bool ok = parser.parseHeader(buf);
+					assert(ok);
+					if (!parser.headerCompleted())
+					{
+						return;
+					}
+					buf->retrieve(
+						parser.consumeBody(buf->peek(), buf->readableBytes()));
+					if (!parser.completed())
+					{
+						return;
+					}
+					statuses.push_back(parser.statusCode());
+					if (parser.statusCode() == 429)
+					{
+						assert(parser.header("retry-after") == "1");
+					}
+					parser.clear();
+					if (statuses.size() < 3)
+					{
+						c->send("GET /limited HTTP/1.1\r\n\r\n");
+					}
+				});
+			conn->send("GET /limited HTTP/1.1\r\n\r\n");
+		});
+
+	// 再开两个连接：第二个占满上限，第三个在创建 Connection 前被拒绝
+	for (int i = 0; i < 2; ++i)
+	{
+		tcp::ClientPool::local(&loop)->acquire(
+			tcp::InetAddr("127.0.0.1", 18091),
+			[](const std::shared_ptr<tcp::Connection>& conn) { assert(conn); });
+	}
+
+	loop.runAfter(0.5, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert((statuses == std::vector<int>{200, 200, 429}));
+	assert(server.connectionNum() == 2);
+	std::string text = metrics::Registry::instance().scrape();
+	assert(text.find("lynx_tcp_connections_rejected_total{server=\"RateLimit\","
+					 "reason=\"limit\"} 1") != std::string::npos);
+	LOG_INFO << "rate limit test passed";
+}
@@ -0,0 +1,183 @@
+#include "lynx/http/parser.hpp"
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace lynx;
+
+namespace
+{
+int parse(const http::Limits& limits, const std::string& data)
+{
+	http::Parser parser(limits);
+	if (parser.parse(data))
+	{
+		return 0;
+	}
+	assert(parser.state() == http::Parser::State::kError);
+	return parser.errorStatus();
+}
+
+void testParser()
+{
+	http::Limits limits;
+	limits.max_header_bytes = 64;
+	limits.max_headers = 2;
+	limits.max_body_bytes = 10;
+
+	assert(parse(limits, "GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\n\r\n") == 0);
+	assert(parse(limits, "GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n") ==
+		   431);
+	assert(parse(limits, "GET / HTTP/1.1\r\nA: " + std::string(64, 'x')) ==
+		   431);
+	assert(parse(limits, "POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\n") ==
+		   413);
+	assert(parse(limits, "POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n") ==
+		   400);
+	assert(parse(limits, "/ HTTP/1.1\r\n") == 400);
+}
+} // namespace
+
+int main()
+{
+	testParser();
+
+	tcp::EventLoop loop;
+	http::Router router;
+	router.addRoute("POST", "/echo",
+					[](const auto& req, auto* res, const auto& conn)
+					{
+						res->setBody(req.body);
+						conn->send(res->toFormattedString());
+					});
+
+	http::Limits limits;
+	limits.max_header_bytes = 1024;
+	limits.max_body_bytes = 16;
+	limits.header_timeout = 0.2;
+	limits.body_timeout = 0.2;
+
+	tcp::Server server(&loop, "127.0.0.1", 18092, "Limits", 0);
+	server.setConnectionCallback(
+		[&limits](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>(limits);
+				ctx.session_->setConnection(conn);
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			if (!session->parser(buf))
+			{
+				http::Session::reject(conn, session->errorStatus());
+				return;
+			}
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+
+	// 请求分段到达但在期限内收齐的不受影响
+	std::map<std::string, std::string> expect = {
+		{"slow-header", "HTTP/1.1 408 Request Timeout"},
+		{"slow-body", "HTTP/1.1 408 Request Timeout"},
+		{"big-header", "HTTP/1.1 431 Request Header Fields Too Large"},
+		{"big-body", "HTTP/1.1 413 Content Too Large"},
+		{"split", "HTTP/1.1 200 OK"},
+	};
+	std::map<std::string, std::string> statuses;
+
+	auto client = [&](const std::string& name, const std::string& first,
+					  const std::string& second)
+	{
+		tcp::ClientPool::local(&loop)->acquire(
+			tcp::InetAddr("127.0.0.1", 18092),
+			[&, name, first,
+			 second](const std::shared_ptr<tcp::Connection>& conn)
+			{
+				assert(conn);
+				auto parser = std::make_shared<http::ResponseParser>();
+				conn->setMessageCallback(
+					[&, name, parser](const std::shared_ptr<tcp::Connection>& c,
+									  tcp::Buffer* buf)
+					{
+						[[maybe_unused]] bool ok = parser->parseHeader(buf);
+						assert(ok);
+						if (!parser->headerCompleted())
+						{
+							return;
+						}
+						buf->retrieve(parser->consumeBody(
+							buf->peek(), buf->readableBytes()));
+						if (!parser->completed())
+						{
+							return;
+						}
+						statuses[name] =
+							parser->version() + " " +
+							std::to_string(parser->statusCode()) + " " +
+							parser->statusMessage();
+						c->forceClose();
+						if (statuses.size() == expect.size())
+						{
+							loop.quit();
+						}
+					});
+				conn->send(first);
+				if (!second.empty())
+				{
+					std::weak_ptr<tcp::Connection> weak = conn;
+					loop.runAfter(0.1,
+								  [weak, second]()
+								  {
+									  if (auto c = weak.lock())
+									  {
+										  c->send(second);
+									  }
+								  });
+				}
+			});
+	};
+
+	client("slow-header", "POST /echo HTTP/1.1\r\nHost: x\r\n", "");
+	client("slow-body", "POST /echo HTTP/1.1\r\nContent-Length: 8\r\n\r\nab",
+		   "");
+	client("big-header",
+		   "GET / HTTP/1.1\r\nCookie: " + std::string(2048, 'c') + "\r\n\r\n",
+		   "");
+	client("big-body", "POST /echo HTTP/1.1\r\nContent-Length: 64\r\n\r\n",
+		   "");
+	client("split", "POST /echo HTTP/1.1\r\nContent-Len",
+		   "gth: 2\r\n\r\nok");
+
+	loop.runAfter(3.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(statuses == expect);
+	LOG_INFO << "request limits test passed";
+}
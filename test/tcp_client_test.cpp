@@ -0,0 +1,108 @@
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/connector.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include "lynx/tcp/socket.hpp"
+#include <cassert>
+#include <memory>
+#include <string>
+
+using namespace lynx;
+
+int main()
+{
+	tcp::EventLoop loop;
+	tcp::Server server(&loop, "127.0.0.1", 18080, "EchoServer", 0);
+	server.setMessageCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn, tcp::Buffer* buf)
+		{ conn->send(buf->retrieveString(buf->readableBytes())); });
+	server.run();
+
+	tcp::ClientPool* pool = tcp::ClientPool::local(&loop);
+	tcp::InetAddr addr("127.0.0.1", 18080);
+	int replies = 0;
+	uint64_t first_id = 0;
+
+	// 第一次请求新建连接，第二次应复用同一条连接
+	std::function<void()> request = [&]()
+	{
+		pool->acquire(
+			addr,
+			[&](const std::shared_ptr<tcp::Connection>& conn)
+			{
+				assert(conn);
+				if (first_id == 0)
+				{
+					first_id = conn->id();
+				}
+				assert(conn->id() == first_id);
+
+				conn->setMessageCallback(
+					[&](const std::shared_ptr<tcp::Connection>& c,
+						tcp::Buffer* buf)
+					{
+						std::string msg =
+							buf->retrieveString(buf->readableBytes());
+						assert(msg == "ping");
+						pool->release(c);
+						if (++replies < 2)
+						{
+							request();
+						}
+						else
+						{
+							assert(pool->idleSize() == 1);
+							loop.quit();
+						}
+					});
+				conn->send("ping");
+			});
+	};
+	request();
+
+	// 连接不存在的端口应在重试耗尽后回调 nullptr
+	bool failed = false;
+	pool->setMaxRetries(0);
+	pool->acquire(tcp::InetAddr("127.0.0.1", 1),
+				  [&](const std::shared_ptr<tcp::Connection>& conn)
+				  {
+					  assert(!conn);
+					  failed = true;
+				  });
+
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(replies == 2);
+	assert(failed);
+
+	// 退避期间 stop 再 start：旧的重试定时器应被取消，只建立一条连接。
+	// late 已 bind 但尚未 listen，第一次连接被拒绝后进入退避
+	tcp::Server late(&loop, "127.0.0.1", 18097, "LateServer", 0);
+	auto connector = std::make_shared<tcp::Connector>(
+		&loop, tcp::InetAddr("127.0.0.1", 18097));
+	int connected = 0;
+	connector->setNewConnectionCallback(
+		[&connected](int fd)
+		{
+			++connected;
+			tcp::Socket::close(fd);
+		});
+	connector->start();
+	loop.runAfter(0.2,
+				  [&]()
+				  {
+					  late.run();
+					  connector->stop();
+				  });
+	loop.runAfter(0.25, [&connector]() { connector->start(); });
+	loop.runAfter(1.5, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(connected == 1);
+	LOG_INFO << "tcp client test passed";
+}
@@ -0,0 +1,66 @@
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+using namespace lynx;
+
+int main()
+{
+	// 回调每次耗时 5ms，周期 20ms：第 n 次触发应在起点后约 n * 20ms，
+	// 而不是 n * 25ms
+	{
+		tcp::EventLoop loop;
+		const int kTicks = 20;
+		int ticks = 0;
+		int64_t start = time::TimeStamp::monotonic().microseconds();
+		int64_t elapsed = 0;
+		loop.runEvery(0.02,
+					  [&]()
+					  {
+						  // 同一轮中缓存的时间不变
+						  time::TimeStamp cached = loop.now();
+						  std::this_thread::sleep_for(
+							  std::chrono::milliseconds(5));
+						  assert(loop.now() == cached);
+						  if (++ticks == kTicks)
+						  {
+							  elapsed =
+								  time::TimeStamp::monotonic().microseconds() -
+								  start;
+							  loop.quit();
+						  }
+					  });
+		loop.runAfter(2.0, [&loop]() { loop.quit(); });
+		loop.run();
+
+		assert(ticks == kTicks);
+		assert(elapsed >= kTicks * 20000);
+		assert(elapsed < kTicks * 20000 + 15000);
+	}
+
+	// 粗粒度时钟：定时器最多提前或推迟一个 tick，runAt 按墙上时间换算
+	{
+		tcp::EventLoop loop;
+		loop.setCoarseClock();
+		int64_t start = time::TimeStamp::monotonic().microseconds();
+		int64_t elapsed = 0;
+		loop.runAt(time::TimeStamp::addTime(time::TimeStamp::now(), 0.05),
+				   [&]()
+				   {
+					   elapsed = time::TimeStamp::monotonic().microseconds() -
+								 start;
+					   loop.quit();
+				   });
+		loop.runAfter(2.0, [&loop]() { loop.quit(); });
+		loop.run();
+
+		assert(elapsed >= 40000);
+		assert(elapsed < 100000);
+	}
+
+	LOG_INFO << "timer drift test passed";
+}
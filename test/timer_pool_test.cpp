@@ -0,0 +1,122 @@
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/time/timer_id.hpp"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace lynx;
+
+namespace
+{
+std::atomic<size_t> allocations{0};
+}
+
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+int main()
+{
+	tcp::EventLoop loop;
+	const int kTimers = 1000;
+	int fired = 0;
+	size_t steady_allocations = 1;
+
+	// 第一批：节点与堆首次分配；取消一半
+	std::vector<time::TimerId> ids;
+	for (int i = 0; i < kTimers; ++i)
+	{
+		ids.push_back(loop.runAfter(0.01, [&fired]() { ++fired; }));
+	}
+	for (int i = 0; i < kTimers; i += 2)
+	{
+		loop.cancell(ids[i]);
+		assert(!ids[i].isAlive());
+	}
+	assert(ids[1].isAlive());
+
+	loop.runAfter(0.05,
+				  [&]()
+				  {
+					  assert(fired == kTimers / 2);
+					  for (auto& id : ids)
+					  {
+						  assert(!id.isAlive());
+					  }
+
+					  // 第二批复用池中节点，小回调注册不分配内存
+					  size_t before = allocations.load();
+					  for (int i = 0; i < kTimers; ++i)
+					  {
+						  loop.runAfter(0.01, [&fired]() { ++fired; });
+					  }
+					  steady_allocations = allocations.load() - before;
+
+					  // 节点已被复用，旧的 TimerId 取消不影响新定时器
+					  loop.cancell(ids[0]);
+				  });
+
+	// 重复定时器在自己的回调中取消
+	int ticks = 0;
+	time::TimerId every;
+	every = loop.runEvery(0.01,
+						  [&]()
+						  {
+							  if (++ticks == 3)
+							  {
+								  loop.cancell(every);
+							  }
+						  });
+
+	// 超过内联容量的回调仍可使用
+	std::array<char, 256> big{};
+	big[0] = 'x';
+	bool big_fired = false;
+	loop.runAfter(0.01, [big, &big_fired]() { big_fired = big[0] == 'x'; });
+
+	// 其他线程批量注册与取消
+	std::atomic<int> remote_fired{0};
+	std::thread worker(
+		[&]()
+		{
+			std::vector<time::TimerId> remote;
+			for (int i = 0; i < 100; ++i)
+			{
+				remote.push_back(
+					loop.runAfter(0.02, [&remote_fired]() { ++remote_fired; }));
+			}
+			loop.cancell(remote[0]);
+		});
+
+	loop.runAfter(0.2, [&loop]() { loop.quit(); });
+	loop.run();
+	worker.join();
+
+	assert(fired == kTimers / 2 + kTimers);
+	assert(steady_allocations == 0);
+	assert(ticks == 3);
+	assert(big_fired);
+	assert(remote_fired == 99);
+	LOG_INFO << "timer pool test passed";
+}
@@ -0,0 +1,204 @@
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include "lynx/tcp/tls.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <string>
+
+using namespace lynx;
+
+namespace
+{
+const char* kCertFile = "/tmp/lynx_tls_test_cert.pem";
+const char* kKeyFile = "/tmp/lynx_tls_test_key.pem";
+
+// 生成 CN=localhost 的自签名证书
+void writeSelfSignedCert()
+{
+	EVP_PKEY* key = EVP_EC_gen("P-256");
+	assert(key);
+
+	X509* cert = X509_new();
+	X509_set_version(cert, 2);
+	ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+	X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+	X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+	X509_set_pubkey(cert, key);
+	X509_NAME* name = X509_get_subject_name(cert);
+	X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+							   reinterpret_cast<const unsigned char*>("localhost"),
+							   -1, -1, 0);
+	X509_set_issuer_name(cert, name);
+	[[maybe_unused]] int signed_len = X509_sign(cert, key, EVP_sha256());
+	assert(signed_len > 0);
+
+	FILE* fp = ::fopen(kCertFile, "w");
+	PEM_write_X509(fp, cert);
+	::fclose(fp);
+	fp = ::fopen(kKeyFile, "w");
+	PEM_write_PrivateKey(fp, key, nullptr, nullptr, 0, nullptr, nullptr);
+	::fclose(fp);
+
+	X509_free(cert);
+	EVP_PKEY_free(key);
+}
+} // namespace
+
+int main()
+{
+	writeSelfSignedCert();
+
+	const std::string file_path = "/tmp/lynx_tls_test_file";
+	std::string content;
+	for (int i = 0; content.size() < 300 * 1024; ++i)
+	{
+		content += std::to_string(i) + "\n";
+	}
+	std::ofstream(file_path) << content;
+
+	tcp::EventLoop loop;
+	tcp::Server server(&loop, "127.0.0.1", 18095, "TlsServer", 0);
+	server.setTlsContext(tcp::TlsContext::server(kCertFile, kKeyFile));
+	server.setMessageCallback(
+		[&](const std::shared_ptr<tcp::Connection>& conn, tcp::Buffer* buf)
+		{
+			std::string msg = buf->retrieveString(buf->readableBytes());
+			if (msg == "file")
+			{
+				conn->sendFile(file_path);
+			}
+			else
+			{
+				conn->send(msg);
+			}
+		});
+	server.run();
+
+	// 以自签名证书作为 CA 校验服务端
+	auto client_ctx = tcp::TlsContext::client(kCertFile);
+	assert(client_ctx);
+	const tcp::InetAddr addr("127.0.0.1", 18095);
+	auto on_connect = [&](const std::shared_ptr<tcp::Connection>& conn)
+	{
+		if (conn->connected())
+		{
+			conn->startTls(client_ctx, "localhost");
+			// 握手完成前发送的数据暂存在 output buffer 中
+			conn->send("ping");
+		}
+	};
+
+	// 第一条连接：完整握手，回显后取回文件
+	tcp::Client first(&loop, addr, "TlsClient1");
+	tcp::Client second(&loop, addr, "TlsClient2");
+	std::string received;
+	bool first_resumed = true;
+	bool second_resumed = false;
+	first.setConnectionCallback(on_connect);
+	first.setMessageCallback(
+		[&](const std::shared_ptr<tcp::Connection>& conn, tcp::Buffer* buf)
+		{
+			received += buf->retrieveString(buf->readableBytes());
+			if (received == "ping")
+			{
+				assert(conn->tls()->established());
+				first_resumed = conn->tls()->resumed();
+				received.clear();
+				conn->send("file");
+			}
+			else if (received.size() == content.size())
+			{
+				assert(received == content);
+				conn->shutdown();
+				// 第二条连接应复用第一条连接收到的会话
+				second.connect();
+			}
+		});
+
+	second.setConnectionCallback(on_connect);
+	second.setMessageCallback(
+		[&](const std::shared_ptr<tcp::Connection>& conn, tcp::Buffer* buf)
+		{
+			std::string msg = buf->retrieveString(buf->readableBytes());
+			assert(msg == "ping");
+			second_resumed = conn->tls()->resumed();
+			loop.quit();
+		});
+
+	first.connect();
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(!first_resumed);
+	assert(second_resumed);
+
+	// 默认使用系统 CA，自签名证书应被拒绝；insecureClient 显式跳过校验
+	auto strict_ctx = tcp::TlsContext::client();
+	auto insecure_ctx = tcp::TlsContext::insecureClient();
+	assert(strict_ctx && insecure_ctx);
+	tcp::Client strict(&loop, addr, "TlsStrict");
+	tcp::Client insecure(&loop, addr, "TlsInsecure");
+	bool rejected = false;
+	bool accepted = false;
+	auto check_done = [&]()
+	{
+		if (rejected && accepted)
+		{
+			loop.quit();
+		}
+	};
+	strict.setConnectionCallback(
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				conn->startTls(strict_ctx, "localhost");
+				conn->send("ping");
+			}
+			else
+			{
+				rejected = true;
+				check_done();
+			}
+		});
+	strict.setMessageCallback(
+		[](const std::shared_ptr<tcp::Connection>&, tcp::Buffer*)
+		{ assert(false); });
+	insecure.setConnectionCallback(
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				conn->startTls(insecure_ctx, "localhost");
+				conn->send("ping");
+			}
+		});
+	insecure.setMessageCallback(
+		[&](const std::shared_ptr<tcp::Connection>&, tcp::Buffer* buf)
+		{
+			std::string msg = buf->retrieveString(buf->readableBytes());
+			assert(msg == "ping");
+			accepted = true;
+			check_done();
+		});
+
+	strict.connect();
+	insecure.connect();
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(rejected);
+	assert(accepted);
+	::remove(file_path.c_str());
+	LOG_INFO << "tls test passed";
+}
@@ -0,0 +1,172 @@
+#include "lynx/http/request.hpp"
+#include "lynx/http/response.hpp"
+#include "lynx/http/response_parser.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/http/trace.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <string>
+
+using namespace lynx;
+
+namespace
+{
+void testSampling()
+{
+	http::Trace::setSampleRate(0);
+	http::Trace trace;
+	trace.begin();
+	assert(!trace.sampled());
+	trace.mark(http::Trace::kHeaders);
+	assert(!trace.marked(http::Trace::kHeaders));
+
+	http::Trace::setSampleRate(0.25);
+	size_t sampled = 0;
+	for (int i = 0; i < 20000; ++i)
+	{
+		trace.reset();
+		trace.begin();
+		sampled += trace.sampled();
+	}
+	assert(sampled > 4000 && sampled < 6000);
+
+	http::Trace::setSampleRate(1);
+	trace.reset();
+	trace.begin();
+	assert(trace.sampled() && !trace.firstRequest());
+
+	// 越界截断，nan 视为 0
+	http::Trace::setSampleRate(1e9);
+	assert(http::Trace::sampleRate() == 1.0);
+	http::Trace::setSampleRate(std::nan(""));
+	assert(http::Trace::sampleRate() == 0.0);
+	http::Trace::setSampleRate(1);
+}
+
+void testSession()
+{
+	http::Session session;
+	tcp::Buffer buf;
+	std::string head = "POST /echo HTTP/1.1\r\nContent-Length: 4\r\n\r\n";
+	buf.append(head.data(), head.size());
+	[[maybe_unused]] bool ok = session.parser(&buf);
+	assert(ok);
+	assert(session.trace().marked(http::Trace::kFirstByte));
+	assert(session.trace().marked(http::Trace::kHeaders));
+	assert(!session.completed());
+
+	buf.append("ping", 4);
+	ok = session.parser(&buf);
+	assert(ok && session.completed());
+
+	http::Trace& trace = session.trace();
+	trace.mark(http::Trace::kDispatch);
+	trace.mark(http::Trace::kHandlerDone);
+	trace.mark(http::Trace::kFlushed);
+	trace.setRequest(7, "POST", "/echo", 200);
+	std::string line = trace.format();
+	assert(line.starts_with("trace conn=7#1 POST /echo 200 parse="));
+	assert(line.find(" body=") != std::string::npos);
+	assert(line.find(" handler=") != std::string::npos);
+	assert(line.find(" flush=") != std::string::npos);
+	assert(line.find(" total=") != std::string::npos);
+
+	session.clear();
+	assert(!session.trace().marked(http::Trace::kFirstByte));
+}
+} // namespace
+
+int main()
+{
+	testSampling();
+	testSession();
+
+	// 处理函数自己设置的 flush callback 不能被 trace 覆盖
+	tcp::EventLoop loop;
+	http::Router router;
+	bool handler_flushed = false;
+	router.addRoute(
+		"GET", "/big",
+		[&handler_flushed](const auto&, auto* res, const auto& conn)
+		{
+			res->setBody(std::string(8 * 1024 * 1024, 'x'));
+			conn->send(res->toFormattedString());
+			assert(conn->pendingBytes() > 0);
+			conn->setFlushCallback([&handler_flushed]()
+								   { handler_flushed = true; });
+		});
+
+	tcp::Server server(&loop, "127.0.0.1", 18088, "Trace", 0);
+	server.setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+
+	http::ResponseParser parser;
+	size_t received = 0;
+	tcp::ClientPool::local(&loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18088),
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[&](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					[[maybe_unused]] bool ok = parser.parseHeader(buf);
+					assert(ok);
+					if (!parser.headerCompleted())
+					{
+						return;
+					}
+					size_t n =
+						parser.consumeBody(buf->peek(), buf->readableBytes());
+					received += n;
+					buf->retrieve(n);
+					if (parser.completed())
+					{
+						c->forceClose();
+						loop.quit();
+					}
+				});
+			conn->send("GET /big HTTP/1.1\r\n\r\n");
+		});
+
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(received == 8 * 1024 * 1024);
+	assert(handler_flushed);
+	LOG_INFO << "trace test passed";
+}
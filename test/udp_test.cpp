@@ -0,0 +1,81 @@
+#include "lynx/logger/logger.hpp"
+#include "lynx/metrics/registry.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/udp_endpoint.hpp"
+#include "lynx/tcp/udp_server.hpp"
+#include <cassert>
+#include <memory>
+#include <string>
+#include <string_view>
+
+using namespace lynx;
+
+int main()
+{
+	const tcp::InetAddr addr("127.0.0.1", 18094);
+	auto echo = [](tcp::UdpEndpoint* ep, std::string_view data,
+				   const tcp::InetAddr& peer) { ep->send(peer, data); };
+
+	tcp::EventLoop loop;
+	tcp::UdpServer server(&loop, addr, "Udp", 0);
+	server.enableGro();
+	server.setMessageCallback(echo);
+	server.run();
+
+	// 同一地址上的第二个 SO_REUSEPORT socket，内核按对端地址分流
+	auto extra = std::make_shared<tcp::UdpEndpoint>(&loop, addr, "UdpExtra",
+													true);
+	extra->enableGro();
+	extra->setMessageCallback(echo);
+	extra->start();
+
+	const size_t kSmall = 20;
+	const size_t kSegments = 3;
+	size_t replies = 0;
+	size_t bytes = 0;
+	auto client = std::make_shared<tcp::UdpEndpoint>(
+		&loop, tcp::InetAddr("127.0.0.1", 0), "UdpClient");
+	assert(client->localAddr().port() != 0);
+	client->setMessageCallback(
+		[&](tcp::UdpEndpoint*, std::string_view data, const tcp::InetAddr& peer)
+		{
+			assert(peer == addr);
+			++replies;
+			bytes += data.size();
+			if (replies == kSmall + kSegments)
+			{
+				loop.quit();
+			}
+		});
+	client->start();
+
+	loop.runAfter(0.01,
+				  [&]()
+				  {
+					  // 同一轮 loop 中的发送合并为一次 sendmmsg
+					  for (size_t i = 0; i < kSmall; ++i)
+					  {
+						  client->send(addr, "ping " + std::to_string(i));
+					  }
+					  assert(client->pendingBytes() > 0);
+					  // 一次发出 3 个 100 字节的数据报，服务端逐个回显
+					  client->send(addr, std::string(kSegments * 100, 'x'),
+								   100);
+				  });
+
+	loop.runAfter(2.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(replies == kSmall + kSegments);
+	assert(bytes == 10 * 6 + 10 * 7 + kSegments * 100);
+	assert(client->pendingBytes() == 0);
+
+	std::string text = metrics::Registry::instance().scrape();
+	assert(text.find("lynx_udp_datagrams_sent_total{endpoint=\"UdpClient\"} " +
+					 std::to_string(kSmall + kSegments)) != std::string::npos);
+
+	extra->stop();
+	client->stop();
+	LOG_INFO << "udp test passed (gso " << client->gsoSupported() << ")";
+}
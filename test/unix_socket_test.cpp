@@ -0,0 +1,111 @@
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include <cassert>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace lynx;
+
+namespace
+{
+void testAddr()
+{
+	tcp::InetAddr path = tcp::InetAddr::fromUnixPath("/tmp/lynx.sock");
+	assert(path.isUnix());
+	assert(path.path() == "/tmp/lynx.sock");
+	assert(path.toFormattedString() == "unix:/tmp/lynx.sock");
+
+	tcp::InetAddr abstract = tcp::InetAddr::fromUnixPath("@lynx");
+	assert(abstract.path() == "@lynx");
+	assert(abstract.length() == offsetof(sockaddr_un, sun_path) + 5);
+
+	assert(!tcp::InetAddr("127.0.0.1", 80).isUnix());
+}
+
+// 模拟进程崩溃后残留的套接字文件
+void leaveStaleSocket(const tcp::InetAddr& addr)
+{
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	[[maybe_unused]] int ret = ::bind(fd, addr.sockaddr(), addr.length());
+	assert(ret == 0);
+	::close(fd);
+}
+} // namespace
+
+int main()
+{
+	testAddr();
+
+	const std::string file = "/tmp/lynx_unix_test.sock";
+	const tcp::InetAddr file_addr = tcp::InetAddr::fromUnixPath(file);
+	const tcp::InetAddr abstract_addr = tcp::InetAddr::fromUnixPath(
+		"@lynx_unix_test." + std::to_string(::getpid()));
+	::unlink(file.c_str());
+	leaveStaleSocket(file_addr);
+
+	tcp::EventLoop loop;
+	auto onMessage = [](const std::shared_ptr<tcp::Connection>& conn,
+						tcp::Buffer* buf)
+	{
+		struct ucred cred;
+		assert(conn->addr().isUnix());
+		[[maybe_unused]] bool ok = conn->peerCredentials(&cred);
+		assert(ok);
+		conn->send(buf->retrieveString(buf->readableBytes()) + " " +
+				   std::to_string(cred.pid));
+	};
+
+	int replies = 0;
+	{
+		tcp::Server file_server(&loop, file_addr, "UnixFile", 0);
+		tcp::Server abstract_server(&loop, abstract_addr, "UnixAbstract", 0);
+		file_server.setMessageCallback(onMessage);
+		abstract_server.setMessageCallback(onMessage);
+		file_server.run();
+		abstract_server.run();
+
+		for (const tcp::InetAddr& addr : {file_addr, abstract_addr})
+		{
+			tcp::ClientPool::local(&loop)->acquire(
+				addr,
+				[&](const std::shared_ptr<tcp::Connection>& conn)
+				{
+					assert(conn);
+					conn->setMessageCallback(
+						[&](const std::shared_ptr<tcp::Connection>& c,
+							tcp::Buffer* buf)
+						{
+							std::string msg =
+								buf->retrieveString(buf->readableBytes());
+							assert(msg == "ping " + std::to_string(::getpid()));
+							c->forceClose();
+							if (++replies == 2)
+							{
+								loop.quit();
+							}
+						});
+					conn->send("ping");
+				});
+		}
+
+		loop.runAfter(2.0, [&loop]() { loop.quit(); });
+		loop.run();
+
+		struct stat st;
+		assert(::stat(file.c_str(), &st) == 0 && S_ISSOCK(st.st_mode));
+	}
+
+	// 服务端析构后删除套接字文件
+	struct stat st;
+	assert(::stat(file.c_str(), &st) == -1);
+	assert(replies == 2);
+	LOG_INFO << "unix socket test passed";
+}
@@ -0,0 +1,200 @@
+#include "lynx/http/response.hpp"
+#include "lynx/http/router.hpp"
+#include "lynx/http/session.hpp"
+#include "lynx/http/websocket.hpp"
+#include "lynx/logger/logger.hpp"
+#include "lynx/tcp/buffer.hpp"
+#include "lynx/tcp/client_pool.hpp"
+#include "lynx/tcp/connection.hpp"
+#include "lynx/tcp/context.hpp"
+#include "lynx/tcp/event_loop.hpp"
+#include "lynx/tcp/inet_addr.hpp"
+#include "lynx/tcp/server.hpp"
+#include "lynx/time/time_stamp.hpp"
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace lynx;
+using Opcode = http::WebSocket::Opcode;
+
+namespace
+{
+// 客户端帧必须加掩码
+std::string clientFrame(const std::string& payload, Opcode opcode, bool fin)
+{
+	std::string frame = http::WebSocket::encodeFrame(payload, opcode, fin);
+	const uint8_t key[4] = {0x12, 0x34, 0x56, 0x78};
+	size_t header = frame.size() - payload.size();
+	frame[1] = static_cast<char>(frame[1] | 0x80);
+	http::WebSocket::unmask(frame.data() + header, frame.data() + header,
+							payload.size(), key);
+	frame.insert(header, reinterpret_cast<const char*>(key), 4);
+	return frame;
+}
+const char* const kHandshake = "GET /ws HTTP/1.1\r\n"
+							   "Host: localhost\r\n"
+							   "Upgrade: websocket\r\n"
+							   "Connection: Upgrade\r\n"
+							   "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+							   "Sec-WebSocket-Version: 13\r\n\r\n";
+} // namespace
+
+int main()
+{
+	// 掩码：SIMD 与逐字节结果一致
+	{
+		std::string src(1000, '\0');
+		for (size_t i = 0; i < src.size(); ++i)
+		{
+			src[i] = static_cast<char>(i * 7);
+		}
+		const uint8_t key[4] = {1, 2, 3, 4};
+		std::string dst(src.size(), '\0');
+		http::WebSocket::unmask(dst.data(), src.data(), src.size(), key);
+		for (size_t i = 0; i < src.size(); ++i)
+		{
+			assert(dst[i] == static_cast<char>(src[i] ^ key[i % 4]));
+		}
+	}
+
+	tcp::EventLoop loop;
+	http::WebSocketHub hub;
+	hub.setMessageCallback(
+		[&hub](const std::shared_ptr<http::WebSocket>& ws,
+			   const std::string& msg, Opcode opcode)
+		{
+			assert(opcode == Opcode::kText);
+			ws->send("echo:" + msg);
+			hub.broadcast("all:" + msg);
+		});
+
+	http::Router router;
+	router.addRoute("GET", "/ws", hub.handler());
+
+	tcp::Server server(&loop, "127.0.0.1", 18082, "WebSocket", 0);
+	server.setConnectionCallback(
+		[](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			if (conn->connected())
+			{
+				tcp::Context ctx;
+				ctx.session_ = std::make_shared<http::Session>();
+				conn->setContext(ctx);
+			}
+		});
+	server.setMessageCallback(
+		[&router](const std::shared_ptr<tcp::Connection>& conn,
+				  tcp::Buffer* buf)
+		{
+			auto session = conn->context<tcp::Context>().session_;
+			[[maybe_unused]] bool ok = session->parser(buf);
+			assert(ok);
+			if (session->completed())
+			{
+				http::Response res;
+				router.dispatch(session->req(), &res, conn);
+				session->clear();
+			}
+		});
+	server.run();
+
+	// 第二个连接保持打开，drain 时应收到 1001 close 帧并被尽快关闭
+	std::string drain_received;
+	bool drained = false;
+	time::TimeStamp drain_start;
+	auto drainTest = [&]()
+	{
+		tcp::ClientPool::local(&loop)->acquire(
+			tcp::InetAddr("127.0.0.1", 18082),
+			[&](const std::shared_ptr<tcp::Connection>& conn)
+			{
+				assert(conn);
+				conn->setMessageCallback(
+					[&](const std::shared_ptr<tcp::Connection>&,
+						tcp::Buffer* buf)
+					{
+						drain_received +=
+							buf->retrieveString(buf->readableBytes());
+						if (drain_received.starts_with("HTTP/1.1 101") &&
+							drain_start == time::TimeStamp())
+						{
+							drain_start = time::TimeStamp::now();
+							server.drain(3.0,
+										 [&]()
+										 {
+											 drained = true;
+											 loop.quit();
+										 });
+						}
+					});
+				conn->send(kHandshake);
+			});
+	};
+
+	std::string received;
+	bool handshake = false;
+	tcp::ClientPool::local(&loop)->acquire(
+		tcp::InetAddr("127.0.0.1", 18082),
+		[&](const std::shared_ptr<tcp::Connection>& conn)
+		{
+			assert(conn);
+			conn->setMessageCallback(
+				[&](const std::shared_ptr<tcp::Connection>& c,
+					tcp::Buffer* buf)
+				{
+					if (!handshake)
+					{
+						std::string resp =
+							buf->retrieveString(buf->readableBytes());
+						assert(resp.starts_with("HTTP/1.1 101"));
+						// RFC 6455 1.3 中的示例
+						assert(resp.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") !=
+							   std::string::npos);
+						handshake = true;
+
+						// 分片的文本消息，中间插入一个 ping
+						std::string frames =
+							clientFrame("hel", Opcode::kText, false) +
+							clientFrame("p", Opcode::kPing, true) +
+							clientFrame("lo", Opcode::kContinuation, true);
+						c->send(frames);
+						return;
+					}
+
+					received += buf->retrieveString(buf->readableBytes());
+					std::string pong =
+						http::WebSocket::encodeFrame("p", Opcode::kPong);
+					std::string echo = http::WebSocket::encodeFrame(
+						"echo:hello", Opcode::kText);
+					std::string all = http::WebSocket::encodeFrame(
+						"all:hello", Opcode::kText);
+					if (received == pong + echo + all)
+					{
+						c->send(clientFrame(std::string("\x03\xe8", 2),
+											Opcode::kClose, true));
+					}
+					else if (received.size() > pong.size() + echo.size() +
+												   all.size())
+					{
+						// 服务端回应的 close 帧
+						assert(received.ends_with(
+							std::string("\x88\x02\x03\xe8")));
+						drainTest();
+					}
+				});
+			conn->send(kHandshake);
+		});
+
+	loop.runAfter(5.0, [&loop]() { loop.quit(); });
+	loop.run();
+
+	assert(handshake);
+	assert(received.ends_with(std::string("\x88\x02\x03\xe8")));
+	assert(drained);
+	assert(time::TimeStamp::now() < time::TimeStamp::addTime(drain_start, 1.0));
+	assert(drain_received.ends_with(
+		http::WebSocket::encodeClose(1001, "Going Away")));
+	LOG_INFO << "websocket test passed";
+}